@@ -36,12 +36,68 @@ namespace z3y
         /**
          * @brief 队列连接 (异步)。
          * 事件被放入一个线程安全的队列，由 PluginManager
-         * 拥有的一个专用工作线程稍后执行。
+         * 拥有的工作线程池稍后执行。
          * FireGlobal/FireToSender 会立即返回，发布者不会被阻塞。
+         * [!! 注意 !!] 工作线程数大于 1 时
+         * (PluginManagerOptions::event_worker_count)，
+         * 不同事件的回调可能并行执行，不保证顺序。
          */
-        kQueued
+        kQueued,
+
+        /**
+         * @brief [!! 新增 !!] 有序队列连接 (异步, 每订阅者 FIFO)。
+         * 与 kQueued 相同，在工作线程池上异步执行；
+         * 但同一订阅者对象的所有 kQueuedOrdered 回调
+         * 经由其专属的串行执行器 (strand) 按发布顺序逐个执行，
+         * 不同订阅者之间仍然并行。
+         */
+        kQueuedOrdered,
+
+        /**
+         * @brief [!! 新增 !!] 合并队列连接 (异步, 只投递最新值)。
+         * 适用于高频的状态变化事件：该订阅 (全局订阅，或
+         * 发送者/订阅者对) 已有一个尚未投递的事件时，新事件直接替换它，
+         * 而不是再排入一个任务；回调总是看到最新的事件。
+         * 同一订阅的回调不会并发执行，且按发布顺序递增。
+         * [!! 注意 !!] 被替换的中间事件永远不会被投递。
+         */
+        kQueuedCoalesced,
+
+        /**
+         * @brief [!! 新增 !!] 宿主调度器连接 (异步, 在宿主线程上执行)。
+         * 回调不进入工作线程池，而是由发布者直接放入某个具名
+         * EventDispatcher 的无锁收件箱，在宿主线程调用 Pump() 时按 FIFO 执行
+         * (见 event_dispatcher.h)。
+         * [!! 注意 !!] 不要直接使用此值：它只是一段取值范围的起点，
+         * 具体的连接方式由 EventDispatcher::Connection() 生成
+         * (kDispatcher + 调度器槽位号)。
+         */
+        kDispatcher = 0x100
     };
 
+    /**
+     * @brief [!! 新增 !!] 连接方式是否指向某个宿主调度器。
+     */
+    constexpr bool IsDispatcherConnection(ConnectionType type) {
+        return static_cast<int>(type) >= static_cast<int>(ConnectionType::kDispatcher);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 指向槽位 slot 的调度器的连接方式。
+     */
+    constexpr ConnectionType MakeDispatcherConnection(unsigned slot) {
+        return static_cast<ConnectionType>(
+            static_cast<int>(ConnectionType::kDispatcher) + static_cast<int>(slot));
+    }
+
+    /**
+     * @brief [!! 新增 !!] 调度器连接方式中的槽位号。
+     */
+    constexpr unsigned DispatcherSlotOf(ConnectionType type) {
+        return static_cast<unsigned>(
+            static_cast<int>(type) - static_cast<int>(ConnectionType::kDispatcher));
+    }
+
 } // namespace z3y
 
 #endif // Z3Y_FRAMEWORK_CONNECTION_TYPE_H_
\ No newline at end of file
@@ -0,0 +1,242 @@
+/**
+ * @file event_awaitable.h
+ * @brief [!! 新增 !!] 定义 z3y::EventAwaiter，等待事件的 C++20 协程 awaitable。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 用法 (协程中)：
+ * @code
+ * auto loaded = co_await bus->Next<event::PluginLoadSuccessEvent>(
+ *     [](const auto& e) { return e.plugin_path_ == path; });
+ * std::optional<MyEvent> e = co_await bus->NextFor<MyEvent>(500ms);
+ * @endcode
+ *
+ * 实现：
+ * - 每次等待创建一个共享状态 (EventAwaitState)，它本身就是订阅者，
+ * 以 kQueued 方式订阅 TEvent；协程挂起期间不占用任何线程；
+ * - [!! 修改 !!] predicate 作为订阅过滤器在发布者线程上执行，
+ * 不满足的事件不会入队；第一个送达的事件 (或超时) 通过原子标志赢得完成权，
+ * 保存事件副本后在该工作线程上恢复协程；
+ * - 超时由 IEventBus::ScheduleTimerImpl 驱动，同样在工作线程上恢复；
+ * - [!! 新增 !!] PluginManager 清空注册表 (UnloadAllPlugins / 析构) 时，
+ * 挂起的等待在调用线程上立即恢复：NextFor / NextFromFor 得到 std::nullopt，
+ * Next / NextFrom 抛出 PluginException (kErrorEventWaitCancelled)。
+ * 没有超时的等待为此登记一个 kTimerUntilCleared 定时器；
+ * - 等待结束后共享状态随 awaiter 析构，订阅随之失效，由事件总线的 GC 回收
+ * (不调用 Unsubscribe，避免大量并发等待同时完成时反复重建订阅表)。
+ *
+ * @note 仅在 Z3Y_HAS_COROUTINES 为 1 时可用 (由 i_event_bus.h 自动包含)。
+ * TEvent 必须可复制。取消后恢复的协程仍在 PluginManager 的清理过程中运行，
+ * 应尽快结束 (例如不要再次等待)。
+ * 对保留事件 (Z3Y_DEFINE_EVENT_RETAINED)，已有保留实例时
+ * 等待立即以该实例 (满足 predicate 时) 完成。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_EVENT_AWAITABLE_H_
+#define Z3Y_FRAMEWORK_EVENT_AWAITABLE_H_
+
+#include "framework/i_event_bus.h"
+#include "framework/plugin_exceptions.h"  // [!! 新增 !!] kErrorEventWaitCancelled
+
+#if Z3Y_HAS_COROUTINES
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace z3y {
+    namespace internal {
+
+        /**
+         * @class EventAwaitState
+         * @brief [内部] 一次等待的共享状态 (同时充当订阅者)。
+         */
+        template <typename TEvent>
+        class EventAwaitState
+            : public std::enable_shared_from_this<EventAwaitState<TEvent>> {
+        public:
+            using Predicate = std::function<bool(const TEvent&)>;
+
+            /**
+             * @brief 订阅回调 (kQueued，在工作线程上执行；
+             * predicate 已由事件总线在发布者线程上检查过)。
+             */
+            void OnEvent(const TEvent& e) {
+                if (done_.exchange(true, std::memory_order_acq_rel)) {
+                    return;
+                }
+                result_.emplace(e);
+                handle_.resume();
+            }
+
+            /**
+             * @brief 定时器回调 (在工作线程上执行；注册表被清空时在调用线程上执行，
+             * 此时 result_ 为空)。
+             */
+            void OnTimeout(const Event&) {
+                if (done_.exchange(true, std::memory_order_acq_rel)) {
+                    return;
+                }
+                handle_.resume();
+            }
+
+            std::coroutine_handle<> handle_;
+            std::optional<TEvent> result_;
+
+        private:
+            std::atomic<bool> done_{ false };
+        };
+
+    }  // namespace internal
+
+    /**
+     * @class EventAwaiter
+     * @brief [!! 新增 !!] IEventBus::Next / NextFor / NextFrom / NextFromFor
+     * 返回的 awaitable。
+     * @tparam kTimed 为 true 时 co_await 的结果为 std::optional<TEvent>
+     * (超时为空)，否则为 TEvent。
+     */
+    template <typename TEvent, bool kTimed>
+    class EventAwaiter {
+    public:
+        using State = internal::EventAwaitState<TEvent>;
+        using Predicate = typename State::Predicate;
+
+        static_assert(std::is_copy_constructible_v<TEvent>,
+            "co_await on an event requires a copyable TEvent");
+
+        EventAwaiter(IEventBus* bus, std::weak_ptr<void> sender,
+            void* sender_key, std::chrono::nanoseconds timeout,
+            Predicate predicate)
+            : bus_(bus),
+            sender_(std::move(sender)),
+            sender_key_(sender_key),
+            timeout_(timeout),
+            predicate_(std::move(predicate)),
+            state_(std::allocate_shared<State>(
+                internal::PoolAllocator<State>())) {}
+
+        EventAwaiter(EventAwaiter&&) noexcept = default;
+        EventAwaiter(const EventAwaiter&) = delete;
+        EventAwaiter& operator=(const EventAwaiter&) = delete;
+
+        bool await_ready() const noexcept { return false; }
+
+        /**
+         * @brief 订阅并挂起。
+         * @note 订阅之后协程可能立即在工作线程上恢复并销毁本对象，
+         * 因此之后只能访问局部变量。
+         */
+        void await_suspend(std::coroutine_handle<> handle) {
+            IEventBus* bus = bus_;
+            std::shared_ptr<State> state = state_;
+            const std::chrono::nanoseconds timeout = timeout_;
+            state->handle_ = handle;
+            bus->DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+
+            EventDelegate on_event =
+                internal::MakeEventDelegate<TEvent, State>(&State::OnEvent);
+            // [!! 修改 !!] predicate 作为过滤器：不满足的事件不入队
+            EventFilterDelegate filter;
+            if (predicate_) {
+                filter = internal::MakeEventFilterDelegate<TEvent>(
+                    std::move(predicate_));
+            }
+            // 订阅由 state 持有 (state 析构后自动失效)，不需要连接句柄
+            if (sender_key_) {
+                bus->SubscribeToSenderConnectedImpl(sender_key_,
+                    TEvent::kEventId, state, sender_, std::move(on_event),
+                    nullptr, std::move(filter), ConnectionType::kQueued);
+            }
+            else {
+                bus->SubscribeGlobalConnectedImpl(TEvent::kEventId, state,
+                    std::move(on_event), nullptr, std::move(filter),
+                    ConnectionType::kQueued);
+            }
+
+            // [!! 修改 !!] 没有超时的等待也登记一个定时器，清空注册表时据此取消
+            bus->ScheduleTimerImpl(
+                kTimed ? timeout : IEventBus::kTimerUntilCleared, state,
+                internal::MakeEventDelegate<Event, State>(&State::OnTimeout));
+        }
+
+        auto await_resume() {
+            if constexpr (kTimed) {
+                return std::move(state_->result_);
+            }
+            else {
+                if (!state_->result_) {
+                    throw PluginException(InstanceError::kErrorEventWaitCancelled,
+                        "The plugin manager was cleared while waiting for an event.");
+                }
+                return std::move(*state_->result_);
+            }
+        }
+
+    private:
+        IEventBus* bus_;
+        std::weak_ptr<void> sender_;
+        void* sender_key_;  // nullptr 表示全局事件
+        std::chrono::nanoseconds timeout_;
+        Predicate predicate_;
+        std::shared_ptr<State> state_;
+    };
+
+    // --- IEventBus 协程模板的实现 ---
+
+    template <typename TEvent>
+    EventAwaiter<TEvent, false> IEventBus::Next(
+        std::function<bool(const TEvent&)> predicate) {
+        static_assert(std::is_base_of_v<Event, TEvent>,
+            "TEvent must derive from z3y::Event");
+        return EventAwaiter<TEvent, false>(this, std::weak_ptr<void>(),
+            nullptr, std::chrono::nanoseconds::zero(), std::move(predicate));
+    }
+
+    template <typename TEvent, typename Rep, typename Period>
+    EventAwaiter<TEvent, true> IEventBus::NextFor(
+        const std::chrono::duration<Rep, Period>& timeout,
+        std::function<bool(const TEvent&)> predicate) {
+        static_assert(std::is_base_of_v<Event, TEvent>,
+            "TEvent must derive from z3y::Event");
+        return EventAwaiter<TEvent, true>(this, std::weak_ptr<void>(),
+            nullptr,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(timeout),
+            std::move(predicate));
+    }
+
+    template <typename TEvent, typename TSender>
+    EventAwaiter<TEvent, false> IEventBus::NextFrom(
+        const std::shared_ptr<TSender>& sender,
+        std::function<bool(const TEvent&)> predicate) {
+        static_assert(std::is_base_of_v<Event, TEvent>,
+            "TEvent must derive from z3y::Event");
+        return EventAwaiter<TEvent, false>(this, sender, sender.get(),
+            std::chrono::nanoseconds::zero(), std::move(predicate));
+    }
+
+    template <typename TEvent, typename TSender, typename Rep, typename Period>
+    EventAwaiter<TEvent, true> IEventBus::NextFromFor(
+        const std::shared_ptr<TSender>& sender,
+        const std::chrono::duration<Rep, Period>& timeout,
+        std::function<bool(const TEvent&)> predicate) {
+        static_assert(std::is_base_of_v<Event, TEvent>,
+            "TEvent must derive from z3y::Event");
+        return EventAwaiter<TEvent, true>(this, sender, sender.get(),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(timeout),
+            std::move(predicate));
+    }
+
+}  // namespace z3y
+
+#endif  // Z3Y_HAS_COROUTINES
+
+#endif  // Z3Y_FRAMEWORK_EVENT_AWAITABLE_H_
@@ -0,0 +1,162 @@
+/**
+ * @file event_completion.h
+ * @brief [!! 新增 !!] 定义 z3y::EventCompletion，异步事件扇出的完成句柄。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * IEventBus::FireGlobalAsync / FireToSenderAsync 返回
+ * PluginPtr<EventCompletion>：
+ * - 发布时计数为 1 (发布者自身)，每投递一个异步任务加 1；
+ * - 每个任务执行完毕 (或被溢出策略丢弃、关闭时清空) 减 1，
+ * 发布者分发结束时再减去自身的 1；计数归零即“完成”；
+ * - 异步回调抛出的异常不再转为 AsyncExceptionEvent，而是汇总到句柄中。
+ *
+ * 句柄由 std::allocate_shared + internal::PoolAllocator 创建 (见 event_pool.h)；
+ * 没有订阅者时返回一个共享的、已完成的句柄，不做任何分配。
+ *
+ * @warning 不要在工作线程上 Wait()：等待的任务可能排在当前线程之后，
+ * 单工作线程时必然死锁。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_EVENT_COMPLETION_H_
+#define Z3Y_FRAMEWORK_EVENT_COMPLETION_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace z3y {
+
+    /**
+     * @class EventCompletion
+     * @brief 一次异步发布的完成状态 (线程安全)。
+     */
+    class EventCompletion {
+    public:
+        EventCompletion() = default;
+
+        EventCompletion(const EventCompletion&) = delete;
+        EventCompletion& operator=(const EventCompletion&) = delete;
+
+        /**
+         * @brief 所有异步回调是否都已执行完毕。
+         */
+        bool IsReady() const {
+            return pending_.load(std::memory_order_acquire) == 0;
+        }
+
+        /**
+         * @brief 阻塞直到完成。
+         */
+        void Wait() const {
+            if (IsReady()) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return IsReady(); });
+        }
+
+        /**
+         * @brief 带超时的 Wait。
+         * @return true 表示已完成。
+         */
+        template <typename Rep, typename Period>
+        bool WaitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+            if (IsReady()) {
+                return true;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            return cv_.wait_for(lock, timeout, [this] { return IsReady(); });
+        }
+
+        /**
+         * @brief 异步回调抛出的异常 (按抛出顺序；完成之前调用只返回已收集的部分)。
+         */
+        std::vector<std::exception_ptr> Exceptions() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return errors_;
+        }
+
+        /**
+         * @brief 等待完成；若有回调失败，重新抛出第一个异常。
+         */
+        void Get() const {
+            Wait();
+            std::exception_ptr first;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!errors_.empty()) {
+                    first = errors_.front();
+                }
+            }
+            if (first) {
+                std::rethrow_exception(first);
+            }
+        }
+
+        // --- [内部] 由事件总线调用 ---
+
+        /**
+         * @internal
+         * @brief 登记 count 个新的异步任务 (必须在发布者释放自身计数之前)。
+         */
+        void AddPending(size_t count) {
+            pending_.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        /**
+         * @internal
+         * @brief 记录一个回调异常。
+         */
+        void AddError(std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            errors_.push_back(std::move(error));
+        }
+
+        /**
+         * @internal
+         * @brief 一个任务 (或发布者自身) 结束。
+         */
+        void Complete() {
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                {
+                    // 与 Wait 的谓词检查互斥，避免丢失唤醒
+                    std::lock_guard<std::mutex> lock(mutex_);
+                }
+                cv_.notify_all();
+            }
+        }
+
+    private:
+        std::atomic<size_t> pending_{ 1 };  // 初始的 1 属于发布者
+        mutable std::mutex mutex_;
+        mutable std::condition_variable cv_;
+        std::vector<std::exception_ptr> errors_;
+    };
+
+    namespace internal {
+        /**
+         * @internal
+         * @brief 没有订阅者时返回的共享“已完成”句柄。
+         */
+        inline const std::shared_ptr<EventCompletion>& CompletedEventCompletion() {
+            static const std::shared_ptr<EventCompletion> completed = [] {
+                auto completion = std::make_shared<EventCompletion>();
+                completion->Complete();
+                return completion;
+            }();
+            return completed;
+        }
+    }  // namespace internal
+
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_EVENT_COMPLETION_H_
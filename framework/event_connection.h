@@ -0,0 +1,172 @@
+/**
+ * @file event_connection.h
+ * @brief [!! 新增 !!] 定义 z3y::EventConnection 与 z3y::ScopedEventConnection，
+ * 订阅的连接句柄。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * SubscribeGlobal / SubscribeToSender 等返回一个 EventConnection
+ * (不绑定订阅者的重载返回 ScopedEventConnection)，
+ * 它指向这一条订阅 (而不是订阅者的全部订阅)：
+ * @code
+ * // 绑定订阅者：订阅者析构时订阅照常失效，句柄可以丢弃
+ * z3y::EventConnection c = bus->SubscribeGlobal<ProgressEvent>(self, &View::OnProgress);
+ * c.Disconnect();  // 只取消这一条订阅
+ *
+ * // 不绑定订阅者：订阅由句柄持有，ScopedEventConnection 析构时断开
+ * z3y::ScopedEventConnection scoped = bus->SubscribeGlobal<ProgressEvent>(
+ *     [this](const ProgressEvent& e) { bar_.SetValue(e.percent); });
+ *
+ * // 确实需要与句柄生命周期脱钩时显式 Release()，之后须自行 Disconnect
+ * z3y::EventConnection kept = bus->SubscribeGlobal<ProgressEvent>(
+ *     [](const ProgressEvent& e) { Log(e.percent); }).Release();
+ * @endcode
+ *
+ * - Disconnect 是 O(1) 的：只清除连接状态中的一个原子标志，发布路径
+ * 不再投递它 (包括已在队列中、尚未执行的任务)；订阅在工作线程上的
+ * 下一次 GC 时间片中移出订阅列表，不需要 Unsubscribe 的反向查找与逐表删除；
+ * - 不绑定订阅者的订阅没有 weak_ptr：发布时不检查订阅者是否失效，
+ * 也不锁定订阅者，只读取连接标志；
+ * - EventConnection 可以复制，不会自动断开；ScopedEventConnection
+ * 只能移动，析构 (或被重新赋值) 时断开。
+ *
+ * @warning Disconnect 返回时，其他线程上正在执行的同步回调可能尚未结束。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_EVENT_CONNECTION_H_
+#define Z3Y_FRAMEWORK_EVENT_CONNECTION_H_
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace z3y {
+
+    /**
+     * @class EventConnectionState
+     * @brief [!! 新增 !!] 一条订阅的连接状态 (由事件总线创建，句柄共享)。
+     */
+    class EventConnectionState {
+    public:
+        virtual ~EventConnectionState() = default;
+
+        EventConnectionState(const EventConnectionState&) = delete;
+        EventConnectionState& operator=(const EventConnectionState&) = delete;
+
+        bool IsConnected() const {
+            return connected_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief 断开订阅 (重复调用是空操作)。
+         */
+        void Disconnect() {
+            if (MarkDisconnected()) {
+                OnDisconnected();
+            }
+        }
+
+    protected:
+        EventConnectionState() = default;
+
+        /**
+         * @brief 清除连接标志。
+         * @return true 表示本次调用使其由连接变为断开。
+         */
+        bool MarkDisconnected() {
+            return connected_.exchange(false, std::memory_order_acq_rel);
+        }
+
+        /**
+         * @brief 由 Disconnect 调用 (事件总线据此安排回收)。
+         */
+        virtual void OnDisconnected() = 0;
+
+    private:
+        std::atomic<bool> connected_{ true };
+    };
+
+    /**
+     * @class EventConnection
+     * @brief [!! 新增 !!] 订阅的连接句柄 (可复制，不自动断开)。
+     */
+    class EventConnection {
+    public:
+        EventConnection() = default;
+
+        explicit EventConnection(std::shared_ptr<EventConnectionState> state)
+            : state_(std::move(state)) {}
+
+        /**
+         * @brief 断开订阅 (空句柄或已断开时什么也不做)。
+         */
+        void Disconnect() const {
+            if (state_) {
+                state_->Disconnect();
+            }
+        }
+
+        /**
+         * @brief 订阅是否仍然有效 (未 Disconnect，也未被 Unsubscribe
+         * 或失效订阅回收移除)。
+         */
+        bool IsConnected() const {
+            return state_ && state_->IsConnected();
+        }
+
+        explicit operator bool() const { return IsConnected(); }
+
+    private:
+        std::shared_ptr<EventConnectionState> state_;
+    };
+
+    /**
+     * @class ScopedEventConnection
+     * @brief [!! 新增 !!] 析构时断开的连接句柄 (只能移动)。
+     */
+    class ScopedEventConnection {
+    public:
+        ScopedEventConnection() = default;
+
+        ScopedEventConnection(EventConnection connection)  // NOLINT: 隐式转换
+            : connection_(std::move(connection)) {}
+
+        ScopedEventConnection(ScopedEventConnection&& other) noexcept
+            : connection_(std::exchange(other.connection_, EventConnection())) {}
+
+        ScopedEventConnection& operator=(ScopedEventConnection&& other) noexcept {
+            if (this != &other) {
+                connection_.Disconnect();
+                connection_ = std::exchange(other.connection_, EventConnection());
+            }
+            return *this;
+        }
+
+        ScopedEventConnection(const ScopedEventConnection&) = delete;
+        ScopedEventConnection& operator=(const ScopedEventConnection&) = delete;
+
+        ~ScopedEventConnection() { connection_.Disconnect(); }
+
+        void Disconnect() { connection_.Disconnect(); }
+
+        bool IsConnected() const { return connection_.IsConnected(); }
+
+        explicit operator bool() const { return IsConnected(); }
+
+        /**
+         * @brief 放弃所有权：返回句柄，析构时不再断开。
+         */
+        EventConnection Release() {
+            return std::exchange(connection_, EventConnection());
+        }
+
+    private:
+        EventConnection connection_;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_EVENT_CONNECTION_H_
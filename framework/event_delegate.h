@@ -0,0 +1,200 @@
+/**
+ * @file event_delegate.h
+ * @brief [!! 新增 !!] 定义 z3y::BasicEventDelegate，事件订阅使用的定长委托。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 取代 Subscription 中的 std::function<void(const Event&)>：
+ * - 委托只保存“载荷” (成员函数指针 / 函数指针 / 小型 lambda) 与一个调用桩，
+ * 不再保存订阅者的 weak_ptr —— 事件总线在分发时锁定
+ * Subscription::subscriber_id，并把原始指针作为 target 传入；
+ * - 可平凡复制且不超过 kInlineSize 的载荷 (所有成员函数指针、函数指针、
+ * 只捕获平凡数据的 lambda) 内联保存，委托整体可按字节搬移
+ * (trivially relocatable)，复制/销毁无需任何额外操作；
+ * - 其余 lambda 放入一个引用计数盒子，复制委托只增加引用计数。
+ *
+ * 调用只有一次间接跳转 (invoke_)，没有 std::function 的虚调用 + lambda
+ * 内部 weak_ptr::lock 两层开销。
+ *
+ * [!! 新增 !!] 第二个模板参数为返回类型 (默认 void)，
+ * 订阅过滤器使用 BasicEventDelegate<Event, bool>。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_EVENT_DELEGATE_H_
+#define Z3Y_FRAMEWORK_EVENT_DELEGATE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace z3y {
+
+    /**
+     * @class BasicEventDelegate
+     * @brief 定长委托：TResult(void* target, const TArg& arg)。
+     * @tparam TArg 分发参数类型 (Event 或 EventBatch)。
+     * @tparam TResult [!! 新增 !!] 返回类型 (过滤器为 bool)。
+     */
+    template <typename TArg, typename TResult = void>
+    class BasicEventDelegate {
+    public:
+        /**
+         * @brief 内联载荷的最大字节数。
+         * 足以容纳单继承 / 多继承类的成员函数指针 (GCC/Clang/MSVC)；
+         * MSVC 对“未知继承”的不完整类使用更大的表示，此时退回盒装。
+         */
+        static constexpr size_t kInlineSize = 2 * sizeof(void*);
+
+        /**
+         * @brief 调用桩。storage 用 Payload<T>() 还原载荷。
+         */
+        using InvokeFn = TResult(*)(const void* storage, void* target,
+            const TArg& arg);
+
+        /**
+         * @brief 载荷 T 是否内联保存。
+         */
+        template <typename T>
+        static constexpr bool kIsInline =
+            std::is_trivially_copyable_v<T> &&
+            sizeof(T) <= kInlineSize &&
+            alignof(T) <= alignof(void*);
+
+        BasicEventDelegate() noexcept = default;
+        BasicEventDelegate(std::nullptr_t) noexcept {}
+
+        /**
+         * @brief 用载荷与调用桩构造委托。
+         */
+        template <typename T>
+        static BasicEventDelegate Create(T payload, InvokeFn invoke) {
+            BasicEventDelegate delegate;
+            if constexpr (kIsInline<T>) {
+                ::new (static_cast<void*>(delegate.storage_)) T(std::move(payload));
+            }
+            else {
+                Box<T>* box = new Box<T>{ {1}, std::move(payload) };
+                ::new (static_cast<void*>(delegate.storage_)) Box<T>*(box);
+                delegate.manager_ = &kBoxManager<T>;
+            }
+            delegate.invoke_ = invoke;
+            return delegate;
+        }
+
+        /**
+         * @brief 在调用桩内部还原载荷。
+         */
+        template <typename T>
+        static const T& Payload(const void* storage) {
+            if constexpr (kIsInline<T>) {
+                return *static_cast<const T*>(storage);
+            }
+            else {
+                return (*static_cast<Box<T>* const*>(storage))->payload;
+            }
+        }
+
+        BasicEventDelegate(const BasicEventDelegate& other) noexcept {
+            CopyFrom(other);
+        }
+
+        BasicEventDelegate(BasicEventDelegate&& other) noexcept {
+            std::memcpy(storage_, other.storage_, kInlineSize);
+            invoke_ = other.invoke_;
+            manager_ = other.manager_;
+            other.invoke_ = nullptr;
+            other.manager_ = nullptr;
+        }
+
+        BasicEventDelegate& operator=(const BasicEventDelegate& other) noexcept {
+            if (this != &other) {
+                Release();
+                CopyFrom(other);
+            }
+            return *this;
+        }
+
+        BasicEventDelegate& operator=(BasicEventDelegate&& other) noexcept {
+            if (this != &other) {
+                Release();
+                std::memcpy(storage_, other.storage_, kInlineSize);
+                invoke_ = other.invoke_;
+                manager_ = other.manager_;
+                other.invoke_ = nullptr;
+                other.manager_ = nullptr;
+            }
+            return *this;
+        }
+
+        ~BasicEventDelegate() { Release(); }
+
+        explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+        /**
+         * @brief 调用委托。
+         * @param[in] target 已锁定的订阅者对象 (成员函数委托的 this)。
+         */
+        TResult operator()(void* target, const TArg& arg) const {
+            return invoke_(storage_, target, arg);
+        }
+
+    private:
+        template <typename T>
+        struct Box {
+            std::atomic<size_t> refs;
+            T payload;
+        };
+
+        /**
+         * @brief 盒装载荷的引用计数操作 (内联载荷为 nullptr)。
+         */
+        struct Manager {
+            void (*retain)(const void* storage) noexcept;
+            void (*release)(void* storage) noexcept;
+        };
+
+        template <typename T>
+        static constexpr Manager kBoxManager = {
+            [](const void* storage) noexcept {
+                (*static_cast<Box<T>* const*>(storage))->refs.fetch_add(
+                    1, std::memory_order_relaxed);
+            },
+            [](void* storage) noexcept {
+                Box<T>* box = *static_cast<Box<T>**>(storage);
+                if (box->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete box;
+                }
+            },
+        };
+
+        void CopyFrom(const BasicEventDelegate& other) noexcept {
+            std::memcpy(storage_, other.storage_, kInlineSize);
+            invoke_ = other.invoke_;
+            manager_ = other.manager_;
+            if (manager_) {
+                manager_->retain(storage_);
+            }
+        }
+
+        void Release() noexcept {
+            if (manager_) {
+                manager_->release(storage_);
+                manager_ = nullptr;
+            }
+            invoke_ = nullptr;
+        }
+
+        alignas(void*) unsigned char storage_[kInlineSize] = {};
+        InvokeFn invoke_ = nullptr;
+        const Manager* manager_ = nullptr;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_EVENT_DELEGATE_H_
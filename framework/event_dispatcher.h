@@ -0,0 +1,125 @@
+/**
+ * @file event_dispatcher.h
+ * @brief [!! 新增 !!] 定义 z3y::EventDispatcher，由宿主线程驱动的具名事件调度器。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * UI / 游戏循环等宿主需要某些回调在自己的主线程上执行。
+ * 以前只能在工作线程的回调里再转发一次 (两次排队)；现在宿主登记一个
+ * 具名调度器并在自己的循环中调用 Pump()，订阅者以该调度器的连接方式订阅，
+ * FireGlobal / FireToSender 在发布者线程上直接把回调放入它的收件箱：
+ * @code
+ * // 宿主 (主线程)
+ * auto ui = bus->GetDispatcher("ui");
+ * ui->SetWakeHandler([hwnd] { ::PostMessage(hwnd, WM_APP, 0, 0); });
+ * // ... 消息循环中 (或每帧)：
+ * ui->Pump();
+ *
+ * // 插件
+ * bus->SubscribeGlobal<ProgressEvent>(self, &View::OnProgress,
+ *     bus->GetDispatcher("ui")->Connection());
+ * @endcode
+ *
+ * - 收件箱是无锁的多生产者/单消费者链表，投递只是一次原子交换；
+ * - 回调按投递顺序执行，与优先级通道无关；异常与统计/追踪的处理
+ * 和工作线程上的异步任务相同 (AsyncExceptionEvent)；
+ * - 任意一方先调用 GetDispatcher 都会创建调度器，因此插件可以在宿主
+ * 开始 Pump 之前订阅；
+ * - 看门狗不会把调度器订阅降级到隔离通道 (它们必须在宿主线程上执行)。
+ *
+ * @warning 销毁 PluginManager 之前先停止 Pump；RemoveDispatcher 或
+ * PluginManager 析构之后，调度器不再接收新的回调，Pump 只会丢弃残留的任务。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_EVENT_DISPATCHER_H_
+#define Z3Y_FRAMEWORK_EVENT_DISPATCHER_H_
+
+#include "framework/connection_type.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string>
+
+namespace z3y {
+
+    /**
+     * @class EventDispatcher
+     * @brief [!! 新增 !!] 具名宿主调度器 (由 IEventBus::GetDispatcher 创建)。
+     */
+    class EventDispatcher {
+    public:
+        virtual ~EventDispatcher() = default;
+
+        EventDispatcher(const EventDispatcher&) = delete;
+        EventDispatcher& operator=(const EventDispatcher&) = delete;
+
+        /**
+         * @brief 订阅时使用的连接方式：回调被投递到本调度器。
+         */
+        ConnectionType Connection() const {
+            return MakeDispatcherConnection(slot_);
+        }
+
+        /**
+         * @brief 调度器的名字 (GetDispatcher 的参数)。
+         */
+        virtual const std::string& Name() const = 0;
+
+        /**
+         * @brief 在调用线程上执行收件箱中的回调，至多 max_tasks 个。
+         * @return 执行的回调数。
+         * @note 同一时刻只允许一个线程 Pump；其他线程的并发调用直接返回 0。
+         * 回调内部可以再次 Pump (嵌套的消息循环)。
+         */
+        virtual size_t Pump(
+            size_t max_tasks = (std::numeric_limits<size_t>::max)()) = 0;
+
+        /**
+         * @brief 收件箱中尚未执行的回调数 (近似值)。
+         */
+        virtual size_t Pending() const = 0;
+
+        /**
+         * @brief 等待收件箱非空 (或 Wake)，最多 timeout。
+         * @return true 表示有待执行的回调。
+         */
+        template <typename Rep, typename Period>
+        bool WaitFor(const std::chrono::duration<Rep, Period>& timeout) {
+            return WaitForImpl(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
+        }
+
+        /**
+         * @brief 唤醒正在 WaitFor 的宿主线程 (例如退出循环时)。
+         */
+        virtual void Wake() = 0;
+
+        /**
+         * @brief 设置唤醒回调：收件箱由空变为非空时，在发布者线程上调用
+         * (例如向窗口投递一条消息)。传入空函数即取消。
+         * @note Pump(max_tasks) 留下未执行的回调时不会再次唤醒，
+         * 宿主应在 Pending() 非零时自行安排下一次 Pump。
+         */
+        virtual void SetWakeHandler(std::function<void()> handler) = 0;
+
+        /**
+         * @brief 调度器是否已被移除 (RemoveDispatcher 或 PluginManager 析构)。
+         */
+        virtual bool IsClosed() const = 0;
+
+    protected:
+        explicit EventDispatcher(unsigned slot) : slot_(slot) {}
+
+        virtual bool WaitForImpl(std::chrono::nanoseconds timeout) = 0;
+
+    private:
+        const unsigned slot_;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_EVENT_DISPATCHER_H_
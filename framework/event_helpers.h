@@ -13,6 +13,7 @@
 #define Z3Y_FRAMEWORK_EVENT_HELPERS_H_
 
 #include "framework/class_id.h"
+#include "framework/event_priority.h" // [!! 新增 !!]
 
  /**
   * @brief [框架辅助宏]
@@ -41,4 +42,56 @@
           */ \
          static constexpr const char* kName = #ClassName;
 
+/**
+ * @brief [!! 新增 !!] [框架辅助宏]
+ * 声明事件类型的异步投递优先级 (写在 Z3Y_DEFINE_EVENT 之后)。
+ *
+ * @param Priority
+ * EventPriority 的枚举值名 (kLow / kNormal / kHigh)。
+ */
+#define Z3Y_DEFINE_EVENT_PRIORITY(Priority) \
+         static constexpr z3y::EventPriority kPriority = \
+         z3y::EventPriority::Priority;
+
+/**
+ * @brief [!! 新增 !!] [框架辅助宏]
+ * 把事件类型声明为“保留事件” (写在 Z3Y_DEFINE_EVENT 之后)。
+ *
+ * 事件总线保存每个 EventId (FireToSender 时为每个发送者)
+ * 最后发布的实例，新的订阅者在订阅时立即收到它。
+ * 适用于“当前状态”类事件，晚加载的插件无需再走重新查询的路径。
+ */
+#define Z3Y_DEFINE_EVENT_RETAINED() \
+         static constexpr bool kRetained = true;
+
+/**
+ * @brief [!! 新增 !!] [框架辅助宏]
+ * 指定事件经由 IEventBridge 跨进程传递的载荷成员 (写在该成员声明之后)。
+ *
+ * 只有这个成员被按字节复制到共享内存，它必须可平凡复制
+ * (不含指针、std::string 等)；接收方默认构造事件后再填入载荷。
+ *
+ * @param Member
+ * 载荷成员名 (例如 data_)。
+ */
+#define Z3Y_DEFINE_EVENT_BRIDGED(Member) \
+         auto& BridgePayload() { return Member; } \
+         const auto& BridgePayload() const { return Member; }
+
+/**
+ * @brief [!! 新增 !!] [框架辅助宏]
+ * 声明事件类型的父类别 (写在 Z3Y_DEFINE_EVENT 之后)。
+ *
+ * 订阅父类别 (SubscribeGlobal<ParentEvent> 等) 的回调也会收到本事件
+ * 及其所有后代事件；类别可以逐级嵌套。ParentEvent 必须是本事件的
+ * C++ 基类，且自身用 Z3Y_DEFINE_EVENT 定义 (可以从不单独发布，只作为类别)。
+ * 子类不会继承这一声明：派生事件需要再声明自己的父类别。
+ *
+ * @param ParentEvent
+ * 父类别的事件类型 (例如 PluginLifecycleEvent)。
+ */
+#define Z3Y_DEFINE_EVENT_CATEGORY(ParentEvent) \
+         using EventCategory = ParentEvent; \
+         static constexpr z3y::EventId kCategoryDeclaredBy = kEventId;
+
 #endif // Z3Y_FRAMEWORK_EVENT_HELPERS_H_
\ No newline at end of file
@@ -0,0 +1,263 @@
+/**
+ * @file event_pool.h
+ * @brief [!! 新增 !!] 定义 z3y::internal::EventPool 与 PoolAllocator，
+ * 事件对象 (及其 shared_ptr 控制块) 的分级内存池。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * FireGlobal / FireToSender 通过 std::allocate_shared + PoolAllocator
+ * 创建事件，对象与控制块一次分配，且来自内存池而不是 malloc。
+ *
+ * 设计 (类似 tcmalloc 的线程缓存 + 中央仓库)：
+ * - 按 16 字节粒度分级，最大 kMaxPooledSize 字节，更大的请求直接走 operator new；
+ * - 每个线程每个级别有一条无锁的空闲链表 (thread_local)；
+ * - 线程缓存为空时，从中央仓库 (互斥锁) 一次取回 kBatchSize 个块；
+ * 仓库也为空时，才向系统申请一整块 slab 并切分；
+ * - 线程缓存过多 (例如工作线程只释放不分配) 时，整批归还仓库，
+ * 供发布者线程复用。因此稳态下发布/投递不再调用 malloc。
+ *
+ * @note 内存池只增不减：slab 在进程生命周期内不会归还系统。
+ * @note 本头文件是 header-only 的，每个模块 (宿主 / 插件 DLL)
+ * 拥有自己的池；释放总是经由分配时生成的控制块代码完成，
+ * 因此块永远回到分配它的那个模块的池中。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_EVENT_POOL_H_
+#define Z3Y_FRAMEWORK_EVENT_POOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace z3y {
+    namespace internal {
+
+        /**
+         * @class EventPool
+         * @brief [内部] 分级、线程缓存的固定块内存池。
+         */
+        class EventPool {
+        public:
+            static constexpr size_t kGranularity = 16;
+            static constexpr size_t kMaxPooledSize = 512;
+            static constexpr size_t kClassCount = kMaxPooledSize / kGranularity;
+            static constexpr size_t kBatchSize = 32;
+
+            /**
+             * @brief 分配 size 字节 (对齐要求不超过 kGranularity 时走池)。
+             */
+            static void* Allocate(size_t size, size_t alignment) {
+                if (size > kMaxPooledSize || alignment > kGranularity) {
+                    return ::operator new(size, std::align_val_t(alignment));
+                }
+                const size_t cls = ClassOf(size);
+                ThreadCache* cache = LocalCache();
+                if (!cache) {
+                    return AllocateFromDepot(cls);
+                }
+                FreeNode* node = cache->heads[cls];
+                if (!node) {
+                    node = Refill(cls, *cache);
+                }
+                cache->heads[cls] = node->next;
+                --cache->counts[cls];
+                return node;
+            }
+
+            /**
+             * @brief 归还由 Allocate 分配的块 (size / alignment 必须与分配时一致)。
+             */
+            static void Deallocate(void* ptr, size_t size,
+                size_t alignment) noexcept {
+                if (size > kMaxPooledSize || alignment > kGranularity) {
+                    ::operator delete(ptr, std::align_val_t(alignment));
+                    return;
+                }
+                const size_t cls = ClassOf(size);
+                FreeNode* node = static_cast<FreeNode*>(ptr);
+                ThreadCache* cache = LocalCache();
+                if (!cache) {
+                    node->next = nullptr;
+                    PushBatch(cls, node);
+                    return;
+                }
+                node->next = cache->heads[cls];
+                cache->heads[cls] = node;
+                if (++cache->counts[cls] >= 2 * kBatchSize) {
+                    ReleaseBatch(cls, *cache);
+                }
+            }
+
+        private:
+            struct FreeNode {
+                FreeNode* next;        // 批内链接
+                FreeNode* next_batch;  // 仓库中批与批之间的链接 (仅批首有效)
+            };
+            static_assert(sizeof(FreeNode) <= kGranularity,
+                "FreeNode must fit in the smallest block");
+
+            /**
+             * @brief 中央仓库：保存整批空闲块 (每个级别一条批链表)。
+             */
+            struct Depot {
+                std::mutex mutex;
+                FreeNode* batches[kClassCount] = {};
+            };
+
+            /**
+             * @brief 线程缓存：线程退出时把剩余的块全部归还仓库。
+             */
+            struct ThreadCache {
+                FreeNode* heads[kClassCount] = {};
+                size_t counts[kClassCount] = {};
+
+                ~ThreadCache() {
+                    CacheDestroyedFlag() = true;
+                    for (size_t cls = 0; cls < kClassCount; ++cls) {
+                        if (heads[cls]) {
+                            PushBatch(cls, heads[cls]);
+                            heads[cls] = nullptr;
+                            counts[cls] = 0;
+                        }
+                    }
+                }
+            };
+
+            static size_t ClassOf(size_t size) {
+                return size == 0 ? 0 : (size - 1) / kGranularity;
+            }
+
+            static size_t BlockSizeOf(size_t cls) {
+                return (cls + 1) * kGranularity;
+            }
+
+            static Depot& GlobalDepot() {
+                // 故意泄漏：事件可能在静态析构阶段才被释放
+                static Depot* depot = new Depot();
+                return *depot;
+            }
+
+            /**
+             * @brief 线程缓存析构后 (线程退出阶段) 返回 nullptr，
+             * 此时直接与仓库交换单个块。
+             */
+            static ThreadCache* LocalCache() {
+                if (CacheDestroyedFlag()) {
+                    return nullptr;
+                }
+                thread_local ThreadCache cache;
+                return &cache;
+            }
+
+            static bool& CacheDestroyedFlag() {
+                thread_local bool destroyed = false;  // 平凡类型，不会先于缓存析构
+                return destroyed;
+            }
+
+            static void* AllocateFromDepot(size_t cls) {
+                ThreadCache scratch;
+                FreeNode* node = Refill(cls, scratch);
+                scratch.heads[cls] = node->next;
+                scratch.counts[cls] = 0;
+                return node;  // scratch 析构时归还剩余块
+            }
+
+            static void PushBatch(size_t cls, FreeNode* batch) {
+                Depot& depot = GlobalDepot();
+                std::lock_guard<std::mutex> lock(depot.mutex);
+                batch->next_batch = depot.batches[cls];
+                depot.batches[cls] = batch;
+            }
+
+            /**
+             * @brief 线程缓存为空：从仓库取一批，或切分一个新 slab。
+             */
+            static FreeNode* Refill(size_t cls, ThreadCache& cache) {
+                FreeNode* batch = nullptr;
+                {
+                    Depot& depot = GlobalDepot();
+                    std::lock_guard<std::mutex> lock(depot.mutex);
+                    batch = depot.batches[cls];
+                    if (batch) {
+                        depot.batches[cls] = batch->next_batch;
+                    }
+                }
+
+                if (!batch) {
+                    const size_t block_size = BlockSizeOf(cls);
+                    char* slab = static_cast<char*>(::operator new(
+                        block_size * kBatchSize, std::align_val_t(kGranularity)));
+                    for (size_t i = 0; i < kBatchSize; ++i) {
+                        FreeNode* node =
+                            reinterpret_cast<FreeNode*>(slab + i * block_size);
+                        node->next = (i + 1 < kBatchSize)
+                            ? reinterpret_cast<FreeNode*>(slab + (i + 1) * block_size)
+                            : nullptr;
+                    }
+                    batch = reinterpret_cast<FreeNode*>(slab);
+                }
+
+                size_t count = 0;
+                for (FreeNode* node = batch; node; node = node->next) {
+                    ++count;
+                }
+                cache.heads[cls] = batch;
+                cache.counts[cls] = count;
+                return batch;
+            }
+
+            /**
+             * @brief 线程缓存过多：摘下 kBatchSize 个块归还仓库。
+             */
+            static void ReleaseBatch(size_t cls, ThreadCache& cache) {
+                FreeNode* batch = cache.heads[cls];
+                FreeNode* tail = batch;
+                for (size_t i = 1; i < kBatchSize; ++i) {
+                    tail = tail->next;
+                }
+                cache.heads[cls] = tail->next;
+                cache.counts[cls] -= kBatchSize;
+                tail->next = nullptr;
+                PushBatch(cls, batch);
+            }
+        };
+
+        /**
+         * @class PoolAllocator
+         * @brief [内部] 基于 EventPool 的标准分配器 (供 std::allocate_shared 使用)。
+         */
+        template <typename T>
+        class PoolAllocator {
+        public:
+            using value_type = T;
+
+            PoolAllocator() noexcept = default;
+            template <typename U>
+            PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+            T* allocate(size_t count) {
+                return static_cast<T*>(
+                    EventPool::Allocate(count * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T* ptr, size_t count) noexcept {
+                EventPool::Deallocate(ptr, count * sizeof(T), alignof(T));
+            }
+
+            template <typename U>
+            bool operator==(const PoolAllocator<U>&) const noexcept {
+                return true;
+            }
+            template <typename U>
+            bool operator!=(const PoolAllocator<U>&) const noexcept {
+                return false;
+            }
+        };
+
+    }  // namespace internal
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_EVENT_POOL_H_
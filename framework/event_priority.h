@@ -0,0 +1,77 @@
+/**
+ * @file event_priority.h
+ * @brief [!! 新增 !!] 定义 z3y::EventPriority 与事件类型的优先级特征。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 异步 (kQueued / kQueuedOrdered) 投递按事件优先级进入不同的通道 (lane)，
+ * 工作线程按加权轮转 (PluginManagerOptions::event_lane_weights) 服务各通道：
+ * 大量低价值的遥测事件不会再拖慢关键的控制事件，
+ * 而低优先级通道在每个轮转周期内至少被服务一次，不会饿死。
+ *
+ * 事件类型在 Z3Y_DEFINE_EVENT 之后用 Z3Y_DEFINE_EVENT_PRIORITY 声明优先级；
+ * 未声明的事件为 kNormal。宿主也可以用 IEventBus::SetEventPriority
+ * 在运行时覆盖任意事件类型的优先级。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_EVENT_PRIORITY_H_
+#define Z3Y_FRAMEWORK_EVENT_PRIORITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace z3y {
+
+    /**
+     * @enum EventPriority
+     * @brief 异步事件的优先级 (数值越大越优先)。
+     * @note 只影响异步投递的先后；kDirect 回调总是在发布者线程上立即执行。
+     * 同一通道内仍保持 FIFO，不同通道之间不保证顺序。
+     */
+    enum class EventPriority : uint8_t {
+        kLow = 0,     //!< 遥测、日志等可延后的事件
+        kNormal = 1,  //!< 默认
+        kHigh = 2,    //!< 控制类、对延迟敏感的事件
+    };
+
+    /**
+     * @brief 优先级 (通道) 的数量。
+     */
+    constexpr size_t kEventPriorityCount = 3;
+
+    namespace internal {
+        template <typename TEvent, typename = void>
+        struct HasDeclaredPriority : std::false_type {};
+
+        template <typename TEvent>
+        struct HasDeclaredPriority<TEvent,
+            std::void_t<decltype(TEvent::kPriority)>> : std::true_type {};
+    }  // namespace internal
+
+    /**
+     * @brief [特征] 事件类型是否用 Z3Y_DEFINE_EVENT_PRIORITY 声明了优先级。
+     */
+    template <typename TEvent>
+    constexpr bool kHasEventPriority =
+        internal::HasDeclaredPriority<TEvent>::value;
+
+    /**
+     * @brief [特征] 事件类型的优先级 (未声明时为 kNormal)。
+     */
+    template <typename TEvent>
+    constexpr EventPriority EventPriorityOf() {
+        if constexpr (kHasEventPriority<TEvent>) {
+            return TEvent::kPriority;
+        }
+        else {
+            return EventPriority::kNormal;
+        }
+    }
+
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_EVENT_PRIORITY_H_
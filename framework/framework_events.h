@@ -24,6 +24,8 @@
 #include "framework/i_event_bus.h"
 #include "framework/class_id.h"
 #include "framework/event_helpers.h" // [新]
+#include <chrono>
+#include <memory>
 #include <string>
 
 namespace z3y {
@@ -132,6 +134,68 @@ namespace z3y {
             }  // [修改]
         };
 
+
+        // --- 4. [!! 新增 !!] 定时器事件 ---
+
+        /**
+         * @struct TimerElapsedEvent
+         * @brief [事件]
+         * IEventBus::ScheduleTimerImpl 登记的定时器到期时，
+         * 在工作线程上传给定时器委托的参数 (不经过订阅表广播)。
+         */
+        struct TimerElapsedEvent : public Event {
+            Z3Y_DEFINE_EVENT(TimerElapsedEvent,
+                "z3y-event-timer-elapsed-E0000005")
+
+                std::chrono::steady_clock::time_point deadline_;
+
+            explicit TimerElapsedEvent(
+                std::chrono::steady_clock::time_point deadline)
+                : deadline_(deadline) {
+            }
+        };
+
+
+        // --- 5. [!! 新增 !!] 慢回调看门狗 ---
+
+        /**
+         * @struct SlowCallbackEvent
+         * @brief [事件]
+         * 工作线程上的一个回调执行时间超过
+         * PluginManagerOptions::slow_callback_budget 时触发
+         * (在该工作线程上、回调返回之后发布)。
+         */
+        struct SlowCallbackEvent : public Event {
+            Z3Y_DEFINE_EVENT(SlowCallbackEvent,
+                "z3y-event-slow-callback-E0000006")
+
+                std::weak_ptr<void> subscriber_;    //!< 超时的订阅者
+            EventId event_id_;                      //!< 超时回调所处理的事件
+            std::chrono::nanoseconds duration_;     //!< 本次执行时间
+            std::chrono::nanoseconds budget_;       //!< 预算
+            /**
+             * @brief 订阅者所属组件的插件路径
+             * (订阅者不是经 PluginManager 创建的组件时为空)
+             */
+            std::string source_plugin_path_;
+            uint64_t overruns_;                     //!< 该订阅者累计超时次数
+            bool demoted_;                          //!< 是否已被降级到隔离通道
+
+            SlowCallbackEvent(std::weak_ptr<void> subscriber, EventId event_id,
+                std::chrono::nanoseconds duration,
+                std::chrono::nanoseconds budget,
+                std::string source_plugin_path, uint64_t overruns,
+                bool demoted)
+                : subscriber_(std::move(subscriber)),
+                event_id_(event_id),
+                duration_(duration),
+                budget_(budget),
+                source_plugin_path_(std::move(source_plugin_path)),
+                overruns_(overruns),
+                demoted_(demoted) {
+            }
+        };
+
     }  // namespace event
 }  // namespace z3y
 
@@ -0,0 +1,215 @@
+/**
+ * @file i_event_bridge.h
+ * @brief [!! 新增 !!] 定义 z3y::IEventBridge，跨进程的共享内存事件桥。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 同一台机器上的多个宿主进程通过一段具名共享内存 (POSIX shm_open /
+ * Win32 CreateFileMapping) 交换一部分全局事件：
+ * @code
+ * auto bridge = z3y::GetDefaultService<z3y::IEventBridge>();
+ * bridge->Open({ "market-data" });
+ * bridge->Export<PriceTickEvent>();   // 本进程 FireGlobal 的实例写入共享环
+ * bridge->Import<OrderFilledEvent>(); // 其他进程写入的实例在本进程重新发布
+ * @endcode
+ *
+ * - 共享内存中是一个定长槽位的广播环：写者原子地领取序号后把载荷
+ * 复制进槽位，每个读者 (每个进程一个读线程) 各自维护游标；
+ * 发布路径上不取互斥量，也没有系统调用 (只读取一次通道快照)；
+ * - 只有“载荷”跨进程：事件类型用 Z3Y_DEFINE_EVENT_BRIDGED 指定一个
+ * 可平凡复制的成员 (Event 本身有虚表，不能按字节复制)，
+ * 写入与读出各一次 memcpy，没有序列化；
+ * - 读者太慢时最旧的记录被覆盖，丢失数计入 EventBridgeStats::lost，
+ * 写者永远不会被读者阻塞；
+ * - 只桥接全局事件 (FireGlobal)；发送者指针在其他进程中没有意义。
+ *
+ * 同一进程既 Export 又 Import 同一类型时，自己写入的记录会被跳过，
+ * 重新发布的事件也不会再被写回共享环 (不会在进程之间来回反弹)。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_I_EVENT_BRIDGE_H_
+#define Z3Y_FRAMEWORK_I_EVENT_BRIDGE_H_
+
+#include "framework/i_event_bus.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace z3y {
+
+    /**
+     * @struct EventBridgeOptions
+     * @brief [!! 新增 !!] IEventBridge::Open 的参数。
+     * @details 槽位参数只在创建共享内存的进程中生效，
+     * 之后加入的进程沿用创建者的布局。
+     */
+    struct EventBridgeOptions {
+        std::string channel;       //!< 通道名 (所有参与进程相同)
+        size_t slot_count = 4096;  //!< 环的槽位数 (向上取 2 的幂)
+        size_t slot_size = 256;    //!< 每个槽位的字节数，含 32 字节槽头 (向上取 64 的倍数)
+        bool remove_on_close = false;  //!< Close 时删除共享内存的名字 (已打开的进程不受影响)
+    };
+
+    /**
+     * @struct EventBridgeStats
+     * @brief [!! 新增 !!] 事件桥的计数器 (本进程视角)。
+     */
+    struct EventBridgeStats {
+        uint64_t exported;  //!< 写入共享环的事件数
+        uint64_t imported;  //!< 从共享环读出的导入类型记录数 (本进程无订阅者时不解码)
+        uint64_t lost;      //!< 读取过慢被覆盖 (或写者中途退出、放弃) 而丢失的记录数；
+                            //!< 被覆盖的记录无法识别，因此也包括其他类型与本进程写入的记录
+        uint64_t rejected;  //!< 载荷大小与本进程的类型定义不符而丢弃的记录数
+    };
+
+    namespace internal {
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 事件类型是否用 Z3Y_DEFINE_EVENT_BRIDGED 指定了载荷。
+         */
+        template <typename TEvent, typename = void>
+        struct HasBridgePayload : std::false_type {};
+
+        template <typename TEvent>
+        struct HasBridgePayload<TEvent,
+            std::void_t<decltype(std::declval<const TEvent&>().BridgePayload())>>
+            : std::true_type {};
+
+        template <typename TEvent>
+        using BridgePayloadOf = std::decay_t<
+            decltype(std::declval<const TEvent&>().BridgePayload())>;
+
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 把事件的载荷复制到共享环的槽位。
+         */
+        template <typename TEvent>
+        void EncodeBridgedEvent(const Event& e, void* payload) {
+            const auto& source = static_cast<const TEvent&>(e).BridgePayload();
+            std::memcpy(payload, &source, sizeof(source));
+        }
+
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 由槽位中的载荷构造一个新的事件实例 (内存池分配)。
+         */
+        template <typename TEvent>
+        PluginPtr<Event> DecodeBridgedEvent(const void* payload) {
+            PluginPtr<TEvent> e = std::allocate_shared<TEvent>(
+                internal::PoolAllocator<TEvent>());
+            std::memcpy(&e->BridgePayload(), payload,
+                sizeof(BridgePayloadOf<TEvent>));
+            return e;
+        }
+    }  // namespace internal
+
+    /**
+     * @class IEventBridge
+     * @brief [!! 新增 !!] 跨进程事件桥接口。
+     */
+    class IEventBridge : public virtual IComponent
+    {
+    public:
+        Z3Y_DEFINE_INTERFACE(IEventBridge, "z3y-core-IEventBridge-IID-A0000004", \
+            1, 0)
+
+            virtual ~IEventBridge() = default;
+
+        /**
+         * @brief 创建或加入一个通道，并启动本进程的读线程。
+         * @details 只接收 Open 之后写入的记录。
+         * @throws z3y::PluginException (kErrorEventBridge) 共享内存无法打开、
+         * 已有的共享内存不是事件桥、已导出类型的载荷放不进槽位，或已经打开。
+         */
+        virtual void Open(const EventBridgeOptions& options) = 0;
+
+        /**
+         * @brief 停止读线程并解除映射 (Export / Import 的登记保留，
+         * 再次 Open 时继续生效)。
+         */
+        virtual void Close() = 0;
+
+        /**
+         * @brief 当前是否已打开。
+         */
+        virtual bool IsOpen() const = 0;
+
+        /**
+         * @brief 计数器快照。
+         */
+        virtual EventBridgeStats GetStats() const = 0;
+
+        /**
+         * @brief [模板] 把本进程发布的全局 TEvent 写入共享环。
+         * @details 以 kDirect 订阅 TEvent：写入发生在发布者线程上。
+         * @throws z3y::PluginException (kErrorEventBridge) 已打开且载荷放不进槽位。
+         */
+        template <typename TEvent>
+        void Export() {
+            CheckBridgedEvent<TEvent>();
+            ExportImpl(TEvent::kEventId,
+                sizeof(internal::BridgePayloadOf<TEvent>),
+                &internal::EncodeBridgedEvent<TEvent>);
+        }
+
+        /**
+         * @brief [模板] 把其他进程写入的 TEvent 在本进程重新发布 (FireGlobal)。
+         * @details 在事件桥的读线程上发布：kDirect 订阅者在读线程上执行。
+         */
+        template <typename TEvent>
+        void Import() {
+            CheckBridgedEvent<TEvent>();
+            static_assert(std::is_default_constructible_v<TEvent>,
+                "Imported events must be default constructible");
+            ImportImpl(TEvent::kEventId,
+                sizeof(internal::BridgePayloadOf<TEvent>),
+                &internal::DecodeBridgedEvent<TEvent>,
+                kIsRetainedEvent<TEvent>);
+        }
+
+    protected:
+        using EncodeFn = void (*)(const Event& e, void* payload);
+        using DecodeFn = PluginPtr<Event>(*)(const void* payload);
+
+        /**
+         * @internal
+         */
+        virtual void ExportImpl(EventId event_id, size_t payload_size,
+            EncodeFn encode) = 0;
+
+        /**
+         * @internal
+         * @param[in] retained 事件类型是否为保留事件 (重新发布时同样保留)。
+         */
+        virtual void ImportImpl(EventId event_id, size_t payload_size,
+            DecodeFn decode, bool retained) = 0;
+
+    private:
+        template <typename TEvent>
+        static constexpr void CheckBridgedEvent() {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+            static_assert(internal::HasBridgePayload<TEvent>::value,
+                "TEvent must name its payload with Z3Y_DEFINE_EVENT_BRIDGED");
+            static_assert(std::is_trivially_copyable_v<
+                internal::BridgePayloadOf<TEvent>>,
+                "The bridged payload must be trivially copyable");
+        }
+    };
+
+    namespace clsid {
+        /**
+         * @brief [!! 新增 !!] 事件桥服务的 "服务ID"。
+         */
+        constexpr ClassId kEventBridge =
+            ConstexprHash("z3y-core-event-bridge-SERVICE-UUID-7C31A0E4");
+    }  // namespace clsid
+
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_I_EVENT_BRIDGE_H_
@@ -13,6 +13,14 @@
  * 使用 Z3Y_DEFINE_INTERFACE
  * 宏 (
  * 版本 1.0)
+ * 4. [!! 新增 !!]
+ * 事件总线扩展 (接口版本 1.1)：批量发布 (FireGlobalBatch / FireToSenderBatch)、
+ * 定长委托回调 (EventDelegate)、异步投递的优先级通道 (event_priority.h)、
+ * C++20 协程等待 (event_awaitable.h)、带完成句柄的异步发布
+ * (event_completion.h)、ConnectionType::kQueuedCoalesced、保留事件、
+ * 带过滤器的订阅、具名宿主调度器 (event_dispatcher.h)、事件类别，
+ * 以及返回连接句柄 (event_connection.h) 的 Subscribe*；
+ * 对象池分配事件 (event_pool.h)
  */
 
 #pragma once
@@ -24,13 +32,43 @@
 #include "framework/i_component.h"
 #include "framework/connection_type.h"
 #include "framework/interface_helpers.h" // [新]
+#include "framework/event_pool.h" // [!! 新增 !!]
+#include "framework/event_delegate.h" // [!! 新增 !!]
+#include "framework/event_priority.h" // [!! 新增 !!]
+#include "framework/event_completion.h" // [!! 新增 !!]
+#include "framework/event_dispatcher.h" // [!! 新增 !!]
+#include "framework/event_connection.h" // [!! 新增 !!]
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <typeindex>
+#include <type_traits>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
+
+/**
+ * @brief [!! 新增 !!] 编译器支持 C++20 协程时为 1。
+ * 只控制 Next / NextFor 等模板是否可用，IEventBus 的虚表与之无关。
+ */
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define Z3Y_HAS_COROUTINES 1
+#endif
+#endif
+#ifndef Z3Y_HAS_COROUTINES
+#define Z3Y_HAS_COROUTINES 0
+#endif
 
 namespace z3y {
 
+#if Z3Y_HAS_COROUTINES
+    template <typename TEvent, bool kTimed>
+    class EventAwaiter;  // 见 event_awaitable.h
+#endif
+
     /**
      * @struct Event
      * @brief 所有“信号”或“事件”的空基类。
@@ -42,6 +80,242 @@ namespace z3y {
         virtual ~Event() = default;
     };
 
+    /**
+     * @class EventBatch
+     * @brief [!! 新增 !!] 一批同类型事件的类型擦除视图。
+     * @details
+     * 由 FireGlobalBatch / FireToSenderBatch 创建，
+     * 框架内部通过它把整批事件交给订阅者。
+     * 所有实现都保证元素在内存中连续存放。
+     */
+    class EventBatch {
+    public:
+        virtual ~EventBatch() = default;
+
+        /**
+         * @brief 批次中的事件数量 (至少为 1)。
+         */
+        virtual size_t Size() const = 0;
+
+        /**
+         * @brief 访问第 index 个事件。
+         */
+        virtual const Event& At(size_t index) const = 0;
+    };
+
+    /**
+     * @class EventSpan
+     * @brief [!! 新增 !!] 批量订阅者收到的只读事件视图 (C++17 下 std::span 的替代品)。
+     * @details 视图只在回调执行期间有效，不要保存它。
+     */
+    template <typename TEvent>
+    class EventSpan {
+    public:
+        EventSpan(const TEvent* data, size_t size) : data_(data), size_(size) {}
+
+        const TEvent* data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const TEvent& operator[](size_t index) const { return data_[index]; }
+        const TEvent* begin() const { return data_; }
+        const TEvent* end() const { return data_ + size_; }
+
+    private:
+        const TEvent* data_;
+        size_t size_;
+    };
+
+    namespace internal {
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 持有 std::vector<TEvent> 的批次。
+         * 整批只有这一次分配，异步任务共享它的引用计数。
+         */
+        template <typename TEvent>
+        class VectorEventBatch final : public EventBatch {
+        public:
+            explicit VectorEventBatch(std::vector<TEvent>&& events)
+                : events_(std::move(events)) {}
+
+            size_t Size() const override { return events_.size(); }
+            const Event& At(size_t index) const override {
+                return events_[index];
+            }
+
+        private:
+            std::vector<TEvent> events_;
+        };
+
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 把 EventBatch 还原为 EventSpan<TEvent>。
+         */
+        template <typename TEvent>
+        EventSpan<TEvent> ToEventSpan(const EventBatch& batch) {
+            const TEvent& first = static_cast<const TEvent&>(batch.At(0));
+            return EventSpan<TEvent>(&first, batch.Size());
+        }
+
+        template <typename TEvent, typename = void>
+        struct HasDeclaredRetention : std::false_type {};
+
+        template <typename TEvent>
+        struct HasDeclaredRetention<TEvent,
+            std::void_t<decltype(TEvent::kRetained)>>
+            : std::bool_constant<TEvent::kRetained> {};
+    }  // namespace internal
+
+    /**
+     * @brief [!! 新增 !!] [特征] 事件类型是否用 Z3Y_DEFINE_EVENT_RETAINED
+     * 声明为保留事件。
+     */
+    template <typename TEvent>
+    constexpr bool kIsRetainedEvent =
+        internal::HasDeclaredRetention<TEvent>::value;
+
+    namespace internal {
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 事件类别链：kDepth 为祖先类别数，
+         * Fill 由近及远写出各祖先的 EventId。
+         */
+        template <typename TEvent, typename = void>
+        struct EventCategoryTraits {
+            static constexpr size_t kDepth = 0;
+            static void Fill(EventId*) {}
+        };
+
+        template <typename TEvent>
+        struct EventCategoryTraits<TEvent,
+            std::void_t<typename TEvent::EventCategory>> {
+            using Parent = typename TEvent::EventCategory;
+
+            static_assert(TEvent::kCategoryDeclaredBy == TEvent::kEventId,
+                "The event inherits its base's Z3Y_DEFINE_EVENT_CATEGORY; "
+                "declare Z3Y_DEFINE_EVENT_CATEGORY(ParentEvent) in it as well");
+            static_assert(std::is_base_of_v<Parent, TEvent>,
+                "Z3Y_DEFINE_EVENT_CATEGORY: the category must be a base class "
+                "of the event");
+
+            static constexpr size_t kDepth =
+                1 + EventCategoryTraits<Parent>::kDepth;
+
+            static void Fill(EventId* out) {
+                out[0] = Parent::kEventId;
+                EventCategoryTraits<Parent>::Fill(out + 1);
+            }
+        };
+    }  // namespace internal
+
+    /**
+     * @brief [!! 新增 !!] [特征] 事件类型是否用 Z3Y_DEFINE_EVENT_CATEGORY
+     * 声明了父类别。
+     */
+    template <typename TEvent>
+    constexpr bool kHasEventCategory =
+        internal::EventCategoryTraits<TEvent>::kDepth != 0;
+
+    /**
+     * @brief [!! 新增 !!] 单事件订阅的委托类型。
+     */
+    using EventDelegate = BasicEventDelegate<Event>;
+
+    /**
+     * @brief [!! 新增 !!] 批量订阅的委托类型。
+     */
+    using EventBatchDelegate = BasicEventDelegate<EventBatch>;
+
+    /**
+     * @brief [!! 新增 !!] 订阅过滤器的委托类型 (返回 true 表示投递)。
+     */
+    using EventFilterDelegate = BasicEventDelegate<Event, bool>;
+
+    namespace internal {
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 由回调生成 EventDelegate。
+         * @details
+         * - 成员函数指针：在事件总线锁定的订阅者 (target) 上调用；
+         * - 其他可调用对象 (自由函数、lambda)：以 (const TEvent&) 调用，
+         * 生命周期仍由订阅者控制 (订阅者析构后不再调用)。
+         */
+        template <typename TEvent, typename TSubscriber, typename TCallback>
+        EventDelegate MakeEventDelegate(TCallback&& callback) {
+            using Fn = std::decay_t<TCallback>;
+            if constexpr (std::is_member_function_pointer_v<Fn>) {
+                return EventDelegate::Create<Fn>(callback,
+                    [](const void* storage, void* target, const Event& e) {
+                        const Fn& method = EventDelegate::Payload<Fn>(storage);
+                        (static_cast<TSubscriber*>(target)->*method)(
+                            static_cast<const TEvent&>(e));
+                    });
+            }
+            else {
+                static_assert(std::is_invocable_v<const Fn&, const TEvent&>,
+                    "Callback must be a member function of the subscriber or "
+                    "const-callable with (const TEvent&)");
+                return EventDelegate::Create<Fn>(std::forward<TCallback>(callback),
+                    [](const void* storage, void*, const Event& e) {
+                        EventDelegate::Payload<Fn>(storage)(
+                            static_cast<const TEvent&>(e));
+                    });
+            }
+        }
+
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 由回调生成 EventBatchDelegate
+         * (回调参数为 EventSpan<TEvent>)。
+         */
+        template <typename TEvent, typename TSubscriber, typename TCallback>
+        EventBatchDelegate MakeEventBatchDelegate(TCallback&& callback) {
+            using Fn = std::decay_t<TCallback>;
+            if constexpr (std::is_member_function_pointer_v<Fn>) {
+                return EventBatchDelegate::Create<Fn>(callback,
+                    [](const void* storage, void* target, const EventBatch& batch) {
+                        const Fn& method = EventBatchDelegate::Payload<Fn>(storage);
+                        (static_cast<TSubscriber*>(target)->*method)(
+                            ToEventSpan<TEvent>(batch));
+                    });
+            }
+            else {
+                static_assert(
+                    std::is_invocable_v<const Fn&, EventSpan<TEvent>>,
+                    "Callback must be a member function of the subscriber or "
+                    "const-callable with (EventSpan<TEvent>)");
+                return EventBatchDelegate::Create<Fn>(
+                    std::forward<TCallback>(callback),
+                    [](const void* storage, void*, const EventBatch& batch) {
+                        EventBatchDelegate::Payload<Fn>(storage)(
+                            ToEventSpan<TEvent>(batch));
+                    });
+            }
+        }
+
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 由谓词 bool(const TEvent&) 生成 EventFilterDelegate
+         * (调用时 target 总是 nullptr)。
+         */
+        template <typename TEvent, typename TFilter>
+        EventFilterDelegate MakeEventFilterDelegate(TFilter&& filter) {
+            using Fn = std::decay_t<TFilter>;
+            return EventFilterDelegate::Create<Fn>(std::forward<TFilter>(filter),
+                [](const void* storage, void*, const Event& e) -> bool {
+                    return static_cast<bool>(EventFilterDelegate::Payload<Fn>(
+                        storage)(static_cast<const TEvent&>(e)));
+                });
+        }
+
+        /**
+         * @internal
+         * @brief [!! 新增 !!] TFilter 能否作为 TEvent 的订阅过滤器。
+         */
+        template <typename TEvent, typename TFilter>
+        constexpr bool kIsEventFilter = std::is_invocable_r_v<bool,
+            const std::decay_t<TFilter>&, const TEvent&>;
+    }  // namespace internal
+
     /**
      * @class IEventBus
      * @brief [框架核心] 事件总线 (信号/槽) 接口。
@@ -57,7 +331,7 @@ namespace z3y {
          * 版本)
          */
         Z3Y_DEFINE_INTERFACE(IEventBus, "z3y-core-IEventBus-IID-A0000002", \
-            1, 0)
+            1, 1)
 
             /**
              * @brief 虚析构函数。
@@ -68,9 +342,14 @@ namespace z3y {
 
         /**
          * @brief [模板] 订阅一个全局事件 (广播)。
+         * @details [!! 修改 !!] callback 可以是 TSubscriber 的成员函数指针，
+         * 也可以是以 (const TEvent&) 调用的自由函数 / lambda；
+         * 两种情况下订阅都随 subscriber 析构而失效。
+         * @return [!! 新增 !!] 这一条订阅的连接句柄 (可以丢弃；
+         * Disconnect 只取消这一条订阅)。
          */
         template <typename TEvent, typename TSubscriber, typename TCallback>
-        void SubscribeGlobal(std::shared_ptr<TSubscriber> subscriber,
+        EventConnection SubscribeGlobal(std::shared_ptr<TSubscriber> subscriber,
             TCallback&& callback,
             ConnectionType type = ConnectionType::kDirect) {
             static_assert(std::is_base_of_v<Event, TEvent>,
@@ -81,20 +360,99 @@ namespace z3y {
                 "Subscriber must inherit from std::enable_shared_from_this");
 
             EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
 
-            std::weak_ptr<TSubscriber> weak_sub = subscriber;
+            // [!! 优化 !!] 定长委托：不再在回调内保存 weak_ptr
+            EventDelegate delegate =
+                internal::MakeEventDelegate<TEvent, TSubscriber>(
+                    std::forward<TCallback>(callback));
 
-            std::function<void(const Event&)> wrapper =
-                [weak_sub, cb = std::forward<TCallback>(callback)](const Event& e) {
-                if (auto sub = weak_sub.lock()) {
-                    (sub.get()->*cb)(static_cast<const TEvent&>(e));
-                }
-                };
+            std::weak_ptr<void> weak_id = subscriber;
+
+            // [!! 新增 !!] 事件类型声明了优先级时，登记为该类型的默认优先级
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeGlobalConnectedImpl(event_id,
+                std::move(weak_id), std::move(delegate), nullptr, nullptr, type));
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 订阅一个全局事件，订阅由返回的句柄持有
+         * (不绑定订阅者)。
+         * @details callback 以 (const TEvent&) 调用。订阅一直有效，直到返回的
+         * ScopedEventConnection 析构或 Disconnect；丢弃返回值会立即断开。
+         * 需要订阅与句柄脱钩时调用 Release() 取得 EventConnection。
+         * 发布时不检查订阅者是否失效，也不锁定订阅者。
+         */
+        template <typename TEvent, typename TCallback>
+        [[nodiscard]] ScopedEventConnection SubscribeGlobal(TCallback&& callback,
+            ConnectionType type = ConnectionType::kDirect) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+            static_assert(
+                !std::is_member_function_pointer_v<std::decay_t<TCallback>>,
+                "A member function callback needs the subscriber argument");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();
+
+            EventDelegate delegate = internal::MakeEventDelegate<TEvent, void>(
+                std::forward<TCallback>(callback));
+
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeGlobalConnectedImpl(event_id,
+                std::weak_ptr<void>(), std::move(delegate), nullptr, nullptr,
+                type));
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 订阅一个全局事件，只接收 filter 返回 true 的实例。
+         * @details
+         * filter 以 (const TEvent&) 调用，在发布者线程上、事件入队之前执行：
+         * 被拒绝的事件不会进入事件队列，也不会唤醒工作线程或锁定订阅者。
+         * 对批量发布，逐个事件过滤，订阅者只收到通过的部分。
+         * @warning filter 可能在多个发布者线程上并发调用，
+         * 应当是只读取事件字段的廉价检查；不要在其中访问订阅者
+         * (此时订阅者没有被锁定)。
+         */
+        template <typename TEvent, typename TSubscriber, typename TCallback,
+            typename TFilter, typename = std::enable_if_t<
+            internal::kIsEventFilter<TEvent, TFilter>>>
+        EventConnection SubscribeGlobal(std::shared_ptr<TSubscriber> subscriber,
+            TCallback&& callback,
+            TFilter&& filter,
+            ConnectionType type = ConnectionType::kDirect) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+            static_assert(
+                std::is_base_of_v<std::enable_shared_from_this<TSubscriber>,
+                TSubscriber>,
+                "Subscriber must inherit from std::enable_shared_from_this");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+
+            EventDelegate delegate =
+                internal::MakeEventDelegate<TEvent, TSubscriber>(
+                    std::forward<TCallback>(callback));
+            EventFilterDelegate filter_delegate =
+                internal::MakeEventFilterDelegate<TEvent>(
+                    std::forward<TFilter>(filter));
 
             std::weak_ptr<void> weak_id = subscriber;
 
-            SubscribeGlobalImpl(event_id, std::move(weak_id), std::move(wrapper),
-                type);
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeGlobalConnectedImpl(event_id,
+                std::move(weak_id), std::move(delegate), nullptr,
+                std::move(filter_delegate), type));
         }
 
         /**
@@ -107,20 +465,143 @@ namespace z3y {
                 "TEvent must derive from z3y::Event");
 
             EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
 
             // [!! 核心优化 !!] 检查是否有订阅者，如果没有则避免构造事件对象
-            if (!IsGlobalSubscribed(event_id)) {
+            // [!! 新增 !!] 保留事件总要构造 (供之后的订阅者使用)
+            if (!kIsRetainedEvent<TEvent> && !IsGlobalSubscribed(event_id)) {
                 return;
             }
 
-            PluginPtr<TEvent> event_ptr =
-                std::make_shared<TEvent>(std::forward<Args>(args)...);
+            // [!! 优化 !!] 事件与控制块从内存池分配 (稳态无 malloc)
+            PluginPtr<TEvent> event_ptr = std::allocate_shared<TEvent>(
+                internal::PoolAllocator<TEvent>(), std::forward<Args>(args)...);
+
+            if constexpr (kIsRetainedEvent<TEvent>) {
+                RetainGlobalImpl(event_id, event_ptr);
+                if (!IsGlobalSubscribed(event_id)) {
+                    return;
+                }
+            }
 
             PluginPtr<Event> base_event = event_ptr;
 
             FireGlobalImpl(event_id, base_event);
         }
 
+        /**
+         * @brief [!! 新增 !!] [模板] 发布一个全局事件，并返回异步扇出的完成句柄。
+         * @details
+         * kDirect 回调仍在本线程上同步执行；其中抛出的异常在其余订阅
+         * 全部入队之后抛给调用方 (之后的 kDirect 回调不再调用，句柄丢失，
+         * 但异步回调照常执行)；
+         * 句柄在所有 kQueued / kQueuedOrdered 回调执行完毕后完成，
+         * 这些回调抛出的异常汇总到句柄中 (不再触发 AsyncExceptionEvent)。
+         * kQueuedCoalesced 订阅的事件被更新的事件替换时也视为完成。
+         */
+        template <typename TEvent, typename... Args>
+        PluginPtr<EventCompletion> FireGlobalAsync(Args&&... args) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+
+            if (!kIsRetainedEvent<TEvent> && !IsGlobalSubscribed(event_id)) {
+                return internal::CompletedEventCompletion();
+            }
+
+            PluginPtr<TEvent> event_ptr = std::allocate_shared<TEvent>(
+                internal::PoolAllocator<TEvent>(), std::forward<Args>(args)...);
+
+            if constexpr (kIsRetainedEvent<TEvent>) {
+                RetainGlobalImpl(event_id, event_ptr);
+                if (!IsGlobalSubscribed(event_id)) {
+                    return internal::CompletedEventCompletion();
+                }
+            }
+
+            PluginPtr<EventCompletion> completion =
+                std::allocate_shared<EventCompletion>(
+                    internal::PoolAllocator<EventCompletion>());
+
+            FireGlobalAsyncImpl(event_id, std::move(event_ptr), completion);
+            return completion;
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 以批次方式订阅一个全局事件。
+         * @details
+         * 回调签名为 void (TSubscriber::*)(EventSpan<TEvent>)，
+         * 或以 (EventSpan<TEvent>) 调用的自由函数 / lambda。
+         * FireGlobalBatch 发布的整批事件会一次性交给回调；
+         * 单个 FireGlobal 发布的事件以长度为 1 的 span 交付。
+         */
+        template <typename TEvent, typename TSubscriber, typename TCallback>
+        EventConnection SubscribeGlobalBatch(std::shared_ptr<TSubscriber> subscriber,
+            TCallback&& callback,
+            ConnectionType type = ConnectionType::kDirect) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+            static_assert(
+                std::is_base_of_v<std::enable_shared_from_this<TSubscriber>,
+                TSubscriber>,
+                "Subscriber must inherit from std::enable_shared_from_this");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+
+            EventBatchDelegate delegate =
+                internal::MakeEventBatchDelegate<TEvent, TSubscriber>(
+                    std::forward<TCallback>(callback));
+
+            std::weak_ptr<void> weak_id = subscriber;
+
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeGlobalConnectedImpl(event_id,
+                std::move(weak_id), nullptr, std::move(delegate), nullptr, type));
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 批量发布一组全局事件。
+         * @details
+         * 订阅者列表只解析一次；kDirect 回调在发布者线程上逐个 (或整批) 执行，
+         * kQueued 订阅者整批只入队一个任务。
+         * @param[in] events 要发布的事件 (按值接收，调用方可 std::move 以免拷贝)。
+         */
+        template <typename TEvent>
+        void FireGlobalBatch(std::vector<TEvent> events) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+
+            if (events.empty() ||
+                (!kIsRetainedEvent<TEvent> && !IsGlobalSubscribed(event_id))) {
+                return;
+            }
+
+            PluginPtr<EventBatch> batch =
+                std::allocate_shared<internal::VectorEventBatch<TEvent>>(
+                    internal::PoolAllocator<internal::VectorEventBatch<TEvent>>(),
+                    std::move(events));
+
+            if constexpr (kIsRetainedEvent<TEvent>) {
+                // 保留最后一个事件 (别名指针共享批次的引用计数)
+                RetainGlobalImpl(event_id, PluginPtr<const Event>(
+                    batch, &batch->At(batch->Size() - 1)));
+                if (!IsGlobalSubscribed(event_id)) {
+                    return;
+                }
+            }
+
+            FireGlobalBatchImpl(event_id, std::move(batch));
+        }
+
         // --- 2. 实例到实例 (Sender-Specific) ---
 
         /**
@@ -128,7 +609,7 @@ namespace z3y {
          */
         template <typename TEvent, typename TSender, typename TSubscriber,
             typename TCallback>
-        void SubscribeToSender(std::shared_ptr<TSender> sender,
+        EventConnection SubscribeToSender(std::shared_ptr<TSender> sender,
             std::shared_ptr<TSubscriber> subscriber,
             TCallback&& callback,
             ConnectionType type = ConnectionType::kDirect) {
@@ -140,23 +621,101 @@ namespace z3y {
                 "Subscriber must inherit from std::enable_shared_from_this");
 
             EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
 
-            std::weak_ptr<TSubscriber> weak_sub = subscriber;
+            // [!! 优化 !!] 定长委托：不再在回调内保存 weak_ptr
+            EventDelegate delegate =
+                internal::MakeEventDelegate<TEvent, TSubscriber>(
+                    std::forward<TCallback>(callback));
 
-            std::function<void(const Event&)> wrapper =
-                [weak_sub, cb = std::forward<TCallback>(callback)](const Event& e) {
-                if (auto sub = weak_sub.lock()) {
-                    (sub.get()->*cb)(static_cast<const TEvent&>(e));
-                }
-                };
+            std::weak_ptr<void> weak_sub_id = subscriber;
+            std::weak_ptr<void> weak_sender_id = sender;
+            void* sender_key = sender.get();
+
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeToSenderConnectedImpl(sender_key,
+                event_id, std::move(weak_sub_id), std::move(weak_sender_id),
+                std::move(delegate), nullptr, nullptr, type));
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 订阅一个特定发送者的事件，订阅由返回的
+         * 句柄持有 (不绑定订阅者)。
+         * @see SubscribeGlobal (不绑定订阅者的重载)
+         */
+        template <typename TEvent, typename TSender, typename TCallback>
+        [[nodiscard]] ScopedEventConnection SubscribeToSender(
+            std::shared_ptr<TSender> sender,
+            TCallback&& callback,
+            ConnectionType type = ConnectionType::kDirect) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+            static_assert(
+                !std::is_member_function_pointer_v<std::decay_t<TCallback>>,
+                "A member function callback needs the subscriber argument");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();
+
+            EventDelegate delegate = internal::MakeEventDelegate<TEvent, void>(
+                std::forward<TCallback>(callback));
+
+            std::weak_ptr<void> weak_sender_id = sender;
+            void* sender_key = sender.get();
+
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeToSenderConnectedImpl(sender_key,
+                event_id, std::weak_ptr<void>(), std::move(weak_sender_id),
+                std::move(delegate), nullptr, nullptr, type));
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 订阅一个特定发送者的事件，
+         * 只接收 filter 返回 true 的实例。
+         * @see SubscribeGlobal (带 filter 的重载)
+         */
+        template <typename TEvent, typename TSender, typename TSubscriber,
+            typename TCallback, typename TFilter, typename = std::enable_if_t<
+            internal::kIsEventFilter<TEvent, TFilter>>>
+        EventConnection SubscribeToSender(std::shared_ptr<TSender> sender,
+            std::shared_ptr<TSubscriber> subscriber,
+            TCallback&& callback,
+            TFilter&& filter,
+            ConnectionType type = ConnectionType::kDirect) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+            static_assert(
+                std::is_base_of_v<std::enable_shared_from_this<TSubscriber>,
+                TSubscriber>,
+                "Subscriber must inherit from std::enable_shared_from_this");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+
+            EventDelegate delegate =
+                internal::MakeEventDelegate<TEvent, TSubscriber>(
+                    std::forward<TCallback>(callback));
+            EventFilterDelegate filter_delegate =
+                internal::MakeEventFilterDelegate<TEvent>(
+                    std::forward<TFilter>(filter));
 
             std::weak_ptr<void> weak_sub_id = subscriber;
             std::weak_ptr<void> weak_sender_id = sender;
             void* sender_key = sender.get();
 
-            SubscribeToSenderImpl(sender_key, event_id, std::move(weak_sub_id),
-                std::move(weak_sender_id), std::move(wrapper),
-                type);
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeToSenderConnectedImpl(sender_key,
+                event_id, std::move(weak_sub_id), std::move(weak_sender_id),
+                std::move(delegate), nullptr, std::move(filter_delegate), type));
         }
 
         /**
@@ -164,26 +723,190 @@ namespace z3y {
          * [!! 优化 !!] 增加 IsSenderSubscribed 检查，实现条件式创建。
          */
         template <typename TEvent, typename TSender, typename... Args>
-        void FireToSender(std::shared_ptr<TSender> sender, Args&&... args) {
+        void FireToSender(const std::shared_ptr<TSender>& sender, Args&&... args) {
             static_assert(std::is_base_of_v<Event, TEvent>,
                 "TEvent must derive from z3y::Event");
 
             EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
             void* sender_key = sender.get();
 
             // [!! 核心优化 !!] 检查是否有订阅者，如果没有则避免构造事件对象
-            if (!IsSenderSubscribed(sender_key, event_id)) {
+            if (!kIsRetainedEvent<TEvent> &&
+                !IsSenderSubscribed(sender_key, event_id)) {
                 return;
             }
 
-            PluginPtr<TEvent> event_ptr =
-                std::make_shared<TEvent>(std::forward<Args>(args)...);
+            // [!! 优化 !!] 事件与控制块从内存池分配 (稳态无 malloc)
+            PluginPtr<TEvent> event_ptr = std::allocate_shared<TEvent>(
+                internal::PoolAllocator<TEvent>(), std::forward<Args>(args)...);
+
+            if constexpr (kIsRetainedEvent<TEvent>) {
+                RetainToSenderImpl(sender_key, sender, event_id, event_ptr);
+                if (!IsSenderSubscribed(sender_key, event_id)) {
+                    return;
+                }
+            }
 
             PluginPtr<Event> base_event = event_ptr;
 
             FireToSenderImpl(sender_key, event_id, base_event);
         }
 
+        /**
+         * @brief [!! 新增 !!] [模板] 向发送者的订阅者发布事件，并返回完成句柄。
+         * @see FireGlobalAsync
+         */
+        template <typename TEvent, typename TSender, typename... Args>
+        PluginPtr<EventCompletion> FireToSenderAsync(
+            const std::shared_ptr<TSender>& sender, Args&&... args) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+            void* sender_key = sender.get();
+
+            if (!kIsRetainedEvent<TEvent> &&
+                !IsSenderSubscribed(sender_key, event_id)) {
+                return internal::CompletedEventCompletion();
+            }
+
+            PluginPtr<TEvent> event_ptr = std::allocate_shared<TEvent>(
+                internal::PoolAllocator<TEvent>(), std::forward<Args>(args)...);
+
+            if constexpr (kIsRetainedEvent<TEvent>) {
+                RetainToSenderImpl(sender_key, sender, event_id, event_ptr);
+                if (!IsSenderSubscribed(sender_key, event_id)) {
+                    return internal::CompletedEventCompletion();
+                }
+            }
+
+            PluginPtr<EventCompletion> completion =
+                std::allocate_shared<EventCompletion>(
+                    internal::PoolAllocator<EventCompletion>());
+
+            FireToSenderAsyncImpl(sender_key, event_id, std::move(event_ptr),
+                completion);
+            return completion;
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 以批次方式订阅一个特定发送者的事件。
+         * @see SubscribeGlobalBatch
+         */
+        template <typename TEvent, typename TSender, typename TSubscriber,
+            typename TCallback>
+        EventConnection SubscribeToSenderBatch(std::shared_ptr<TSender> sender,
+            std::shared_ptr<TSubscriber> subscriber,
+            TCallback&& callback,
+            ConnectionType type = ConnectionType::kDirect) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+            static_assert(
+                std::is_base_of_v<std::enable_shared_from_this<TSubscriber>,
+                TSubscriber>,
+                "Subscriber must inherit from std::enable_shared_from_this");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+
+            EventBatchDelegate delegate =
+                internal::MakeEventBatchDelegate<TEvent, TSubscriber>(
+                    std::forward<TCallback>(callback));
+
+            std::weak_ptr<void> weak_sub_id = subscriber;
+            std::weak_ptr<void> weak_sender_id = sender;
+            void* sender_key = sender.get();
+
+            if constexpr (kHasEventPriority<TEvent>) {
+                DeclareEventPriorityImpl(event_id, EventPriorityOf<TEvent>());
+            }
+
+            return EventConnection(SubscribeToSenderConnectedImpl(sender_key,
+                event_id, std::move(weak_sub_id), std::move(weak_sender_id),
+                nullptr, std::move(delegate), nullptr, type));
+        }
+
+        /**
+         * @brief [!! 新增 !!] [模板] 向订阅了此发送者的订阅者批量发布事件。
+         * @see FireGlobalBatch
+         */
+        template <typename TEvent, typename TSender>
+        void FireToSenderBatch(const std::shared_ptr<TSender>& sender,
+            std::vector<TEvent> events) {
+            static_assert(std::is_base_of_v<Event, TEvent>,
+                "TEvent must derive from z3y::Event");
+
+            EventId event_id = TEvent::kEventId;
+            DeclareEventCategory<TEvent>();  // [!! 新增 !!]
+            void* sender_key = sender.get();
+
+            if (events.empty() || (!kIsRetainedEvent<TEvent> &&
+                !IsSenderSubscribed(sender_key, event_id))) {
+                return;
+            }
+
+            PluginPtr<EventBatch> batch =
+                std::allocate_shared<internal::VectorEventBatch<TEvent>>(
+                    internal::PoolAllocator<internal::VectorEventBatch<TEvent>>(),
+                    std::move(events));
+
+            if constexpr (kIsRetainedEvent<TEvent>) {
+                RetainToSenderImpl(sender_key, sender, event_id,
+                    PluginPtr<const Event>(batch,
+                        &batch->At(batch->Size() - 1)));
+                if (!IsSenderSubscribed(sender_key, event_id)) {
+                    return;
+                }
+            }
+
+            FireToSenderBatchImpl(sender_key, event_id, std::move(batch));
+        }
+
+#if Z3Y_HAS_COROUTINES
+        // --- 2b. [!! 新增 !!] 协程等待 (C++20) ---
+
+        /**
+         * @brief [模板] 等待下一个 (满足 predicate 的) 全局事件。
+         * @details
+         * co_await bus->Next<TEvent>() 挂起协程而不占用线程；
+         * 事件到达后，协程在工作线程 (kQueued) 上恢复，结果为事件的副本。
+         * predicate 可能在多个工作线程上并发调用。
+         * @see event_awaitable.h
+         */
+        template <typename TEvent>
+        EventAwaiter<TEvent, false> Next(
+            std::function<bool(const TEvent&)> predicate = nullptr);
+
+        /**
+         * @brief [模板] 带超时的 Next：结果为 std::optional<TEvent>，超时为空。
+         */
+        template <typename TEvent, typename Rep, typename Period>
+        EventAwaiter<TEvent, true> NextFor(
+            const std::chrono::duration<Rep, Period>& timeout,
+            std::function<bool(const TEvent&)> predicate = nullptr);
+
+        /**
+         * @brief [模板] 等待某个发送者的下一个 (满足 predicate 的) 事件。
+         * @note 只持有发送者的 weak_ptr；发送者析构后只有超时才能结束等待。
+         */
+        template <typename TEvent, typename TSender>
+        EventAwaiter<TEvent, false> NextFrom(
+            const std::shared_ptr<TSender>& sender,
+            std::function<bool(const TEvent&)> predicate = nullptr);
+
+        /**
+         * @brief [模板] 带超时的 NextFrom。
+         */
+        template <typename TEvent, typename TSender, typename Rep,
+            typename Period>
+        EventAwaiter<TEvent, true> NextFromFor(
+            const std::shared_ptr<TSender>& sender,
+            const std::chrono::duration<Rep, Period>& timeout,
+            std::function<bool(const TEvent&)> predicate = nullptr);
+#endif
+
         // --- 3. 手动生命周期管理 ---
 
         /**
@@ -205,6 +928,8 @@ namespace z3y {
 
         /**
          * @internal
+         * @deprecated [!! 修改 !!] 仅为 1.0 插件保留的二进制兼容入口，
+         * 新代码经由 SubscribeGlobalConnectedImpl。
          */
         virtual void SubscribeGlobalImpl(EventId event_id,
             std::weak_ptr<void> sub,
@@ -219,6 +944,8 @@ namespace z3y {
 
         /**
          * @internal
+         * @deprecated [!! 修改 !!] 仅为 1.0 插件保留的二进制兼容入口，
+         * 新代码经由 SubscribeToSenderConnectedImpl。
          */
         virtual void SubscribeToSenderImpl(void* sender_key,
             EventId event_id,
@@ -233,6 +960,182 @@ namespace z3y {
         virtual void FireToSenderImpl(void* sender_key,
             EventId event_id,
             PluginPtr<Event> e_ptr) = 0;
+
+        // --- [!! 新增 !!] 1.1 版本追加 (保持在虚表末尾) ---
+
+        /**
+         * @internal
+         */
+        virtual void FireGlobalBatchImpl(EventId event_id,
+            PluginPtr<EventBatch> batch) = 0;
+
+        /**
+         * @internal
+         */
+        virtual void FireToSenderBatchImpl(void* sender_key,
+            EventId event_id,
+            PluginPtr<EventBatch> batch) = 0;
+
+        /**
+         * @internal
+         * @brief 登记事件类型声明的默认优先级 (不会覆盖 SetEventPriority 的设置)。
+         */
+        virtual void DeclareEventPriorityImpl(EventId event_id,
+            EventPriority priority) = 0;
+
+    public:
+        /**
+         * @brief [!! 新增 !!] 设置某个事件类型的异步投递优先级。
+         * @details
+         * 覆盖 Z3Y_DEFINE_EVENT_PRIORITY 声明的默认值，对已有订阅立即生效
+         * (尚在队列中的任务不受影响)。用于调整不属于自己的事件类型
+         * (例如把某个插件的遥测事件降为 kLow)。
+         */
+        virtual void SetEventPriority(EventId event_id,
+            EventPriority priority) = 0;
+
+    protected:
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 作为 ScheduleTimerImpl 的 delay 时，定时器永不到期，
+         * 只在清空注册表时触发 (用于取消没有超时的等待)。
+         */
+        static constexpr std::chrono::nanoseconds kTimerUntilCleared =
+            std::chrono::hours(24 * 365 * 100);
+
+        /**
+         * @internal
+         * @brief 登记一个一次性定时器：delay 之后在工作线程上以
+         * event::TimerElapsedEvent 调用 cb (owner 已析构则跳过)。
+         * @details 定时器由空闲的工作线程带超时等待驱动，不占用额外线程。
+         * [!! 新增 !!] 清空注册表 (UnloadAllPlugins / 析构) 时，尚未到期的
+         * 定时器在调用线程上立即触发，而不是被丢弃；
+         * delay 不小于 kTimerUntilCleared 的定时器只在这时触发。
+         */
+        virtual void ScheduleTimerImpl(std::chrono::nanoseconds delay,
+            std::weak_ptr<void> owner,
+            EventDelegate cb) = 0;
+
+        /**
+         * @internal
+         * @brief 与 FireGlobalImpl 相同，但异步任务向 completion 报告完成与异常；
+         * 返回前释放发布者自身的计数。
+         */
+        virtual void FireGlobalAsyncImpl(EventId event_id,
+            PluginPtr<Event> e_ptr,
+            PluginPtr<EventCompletion> completion) = 0;
+
+        /**
+         * @internal
+         */
+        virtual void FireToSenderAsyncImpl(void* sender_key,
+            EventId event_id,
+            PluginPtr<Event> e_ptr,
+            PluginPtr<EventCompletion> completion) = 0;
+
+        /**
+         * @internal
+         * @brief 保存保留事件的最新实例 (替换旧实例)。
+         */
+        virtual void RetainGlobalImpl(EventId event_id,
+            PluginPtr<const Event> e_ptr) = 0;
+
+        /**
+         * @internal
+         * @brief 保存某个发送者的保留事件；发送者析构后实例随之作废。
+         */
+        virtual void RetainToSenderImpl(void* sender_key,
+            std::weak_ptr<void> sender_id,
+            EventId event_id,
+            PluginPtr<const Event> e_ptr) = 0;
+
+    public:
+        /**
+         * @brief [!! 新增 !!] 丢弃某个事件类型的所有保留实例
+         * (全局的与各发送者的)。
+         * @details 例如状态已失效、之后的订阅者不应再收到旧值时调用。
+         */
+        virtual void ClearRetainedEvent(EventId event_id) = 0;
+
+        /**
+         * @brief [!! 新增 !!] 获取 (不存在时创建) 名为 name 的宿主调度器。
+         * @details 宿主线程通过它 Pump 回调；订阅者以
+         * GetDispatcher(name)->Connection() 作为连接方式订阅。
+         * 调度器在 UnloadAllPlugins 后仍然存在 (尚未执行的回调被丢弃)。
+         */
+        virtual PluginPtr<EventDispatcher> GetDispatcher(
+            const std::string& name) = 0;
+
+        /**
+         * @brief [!! 新增 !!] 移除宿主调度器。
+         * @details 已有的句柄变为关闭状态：尚未执行的回调被丢弃，
+         * 指向它的订阅不再收到事件；同名调度器可以重新创建 (连接方式不同)。
+         */
+        virtual void RemoveDispatcher(const std::string& name) = 0;
+
+    protected:
+        /**
+         * @internal
+         * @brief 登记事件的类别链 (ancestors 由近及远，共 count 个)。
+         * @details 总线据此把类别订阅预先合并进后代事件的订阅列表，
+         * 发布时仍只查找一次。重复登记是空操作。
+         */
+        virtual void DeclareEventCategoryImpl(EventId event_id,
+            const EventId* ancestors, size_t count) = 0;
+
+        /**
+         * @internal
+         * @brief [!! 新增 !!] 向本总线登记 TEvent 的类别链
+         * (未声明类别时为空操作；每个模块、每个事件类型只登记一次)。
+         */
+        template <typename TEvent>
+        void DeclareEventCategory() {
+            if constexpr (kHasEventCategory<TEvent>) {
+                static std::atomic<const IEventBus*> s_declared_for{ nullptr };
+                if (s_declared_for.load(std::memory_order_acquire) == this) {
+                    return;
+                }
+                using Traits = internal::EventCategoryTraits<TEvent>;
+                EventId ancestors[Traits::kDepth];
+                Traits::Fill(ancestors);
+                DeclareEventCategoryImpl(TEvent::kEventId, ancestors,
+                    Traits::kDepth);
+                s_declared_for.store(this, std::memory_order_release);
+            }
+        }
+
+        /**
+         * @internal
+         * @brief 订阅一个全局事件并返回它的连接状态
+         * (cb 与 batch_cb 恰有一个非空，filter 可为空)。
+         * @details sub 为空时订阅由连接状态持有：发布时不再检查订阅者。
+         */
+        virtual PluginPtr<EventConnectionState> SubscribeGlobalConnectedImpl(
+            EventId event_id,
+            std::weak_ptr<void> sub,
+            EventDelegate cb,
+            EventBatchDelegate batch_cb,
+            EventFilterDelegate filter,
+            ConnectionType connection_type) = 0;
+
+        /**
+         * @internal
+         * @see SubscribeGlobalConnectedImpl
+         */
+        virtual PluginPtr<EventConnectionState> SubscribeToSenderConnectedImpl(
+            void* sender_key,
+            EventId event_id,
+            std::weak_ptr<void> sub_id,
+            std::weak_ptr<void> sender_id,
+            EventDelegate cb,
+            EventBatchDelegate batch_cb,
+            EventFilterDelegate filter,
+            ConnectionType connection_type) = 0;
+
+#if Z3Y_HAS_COROUTINES
+        template <typename TEvent, bool kTimed>
+        friend class EventAwaiter;
+#endif
     };
 
     /**
@@ -249,4 +1152,8 @@ namespace z3y {
 
 }  // namespace z3y
 
+#if Z3Y_HAS_COROUTINES
+#include "framework/event_awaitable.h" // [!! 新增 !!] Next / NextFor 的实现
+#endif
+
 #endif  // Z3Y_FRAMEWORK_I_EVENT_BUS_H_
\ No newline at end of file
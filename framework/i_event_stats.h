@@ -0,0 +1,178 @@
+/**
+ * @file i_event_stats.h
+ * @brief [!! 新增 !!] 定义 z3y::IEventStats，按 EventId 统计的事件延迟与吞吐。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 与 IPluginQuery 一样由 PluginManager 自身实现，注册为核心服务
+ * clsid::kEventStats：
+ * @code
+ * auto stats = z3y::GetService<z3y::IEventStats>(z3y::clsid::kEventStats);
+ * stats->EnableEventStats(true);
+ * // ... 运行一段时间 ...
+ * for (const z3y::EventStats& s : stats->GetAllEventStats()) {
+ *     s.queue_latency_ns.ValueAtPercentile(99.0);  // 排队多久才开始执行
+ *     s.callback_ns.max;                          // 最慢的回调
+ * }
+ * @endcode
+ *
+ * - queue_latency_ns：异步任务从入队 (发布时) 到开始执行；
+ * - callback_ns：每个回调 (同步与异步) 的执行时间，批量发布时为整批；
+ * - fan_out：每次发布投递到的订阅数 (通过过滤的、未失效的)。
+ *
+ * [!! 新增 !!] 1.1：GetSlowSubscribers 返回慢回调看门狗记录的订阅者
+ * (看门狗始终工作，不受 EnableEventStats 影响)。
+ *
+ * 直方图为 HDR 风格的对数-线性分桶 (每个 2 的幂 8 个子桶，相对误差 < 12.5%)，
+ * 记录只是几次 relaxed 原子加法，不加锁。统计默认关闭，
+ * 关闭时热路径上只有一次原子读取。
+ */
+
+#pragma once
+
+#ifndef Z3Y_FRAMEWORK_I_EVENT_STATS_H_
+#define Z3Y_FRAMEWORK_I_EVENT_STATS_H_
+
+#include "framework/i_component.h"
+#include "framework/class_id.h"
+#include "framework/event_priority.h"
+#include "framework/interface_helpers.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace z3y {
+
+    namespace clsid {
+        /**
+         * @brief [!! 新增 !!] 框架核心事件统计服务的 "服务ID"。
+         */
+        constexpr ClassId kEventStats =
+            ConstexprHash("z3y-core-event-stats-SERVICE-UUID");
+    }  // namespace clsid
+
+    /**
+     * @struct EventHistogram
+     * @brief [!! 新增 !!] 直方图快照。
+     */
+    struct EventHistogram {
+        uint64_t count = 0;  //!< 样本数
+        uint64_t sum = 0;    //!< 样本之和
+        uint64_t min = 0;    //!< 最小值 (count 为 0 时无意义)
+        uint64_t max = 0;    //!< 最大值
+        /**
+         * @brief 非空的桶：(桶内最大值, 样本数)，按值升序。
+         */
+        std::vector<std::pair<uint64_t, uint64_t>> buckets;
+
+        double Mean() const {
+            return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+        }
+
+        /**
+         * @brief 百分位数 (0-100) 的近似值 (所在桶的上界，不超过 max)。
+         */
+        uint64_t ValueAtPercentile(double percentile) const {
+            if (count == 0) {
+                return 0;
+            }
+            const double target = percentile / 100.0 * static_cast<double>(count);
+            uint64_t seen = 0;
+            for (const auto& bucket : buckets) {
+                seen += bucket.second;
+                if (static_cast<double>(seen) >= target) {
+                    return bucket.first < max ? bucket.first : max;
+                }
+            }
+            return max;
+        }
+    };
+
+    /**
+     * @struct EventStats
+     * @brief [!! 新增 !!] 一个 EventId 的统计。
+     */
+    struct EventStats {
+        EventId event_id = 0;
+        uint64_t fired = 0;        //!< 统计期间的发布次数
+        uint64_t window_ns = 0;    //!< 统计期间的长度 (自开启或上次重置)
+        EventHistogram queue_latency_ns;  //!< 入队到开始执行 (纳秒)
+        EventHistogram callback_ns;       //!< 单个回调的执行时间 (纳秒)
+        EventHistogram fan_out;           //!< 每次发布投递到的订阅数
+    };
+
+    /**
+     * @struct EventQueueDepthStats
+     * @brief [!! 新增 !!] 异步队列深度的高水位 (统计开启期间)。
+     */
+    struct EventQueueDepthStats {
+        //! 各优先级通道的最大深度 (按 EventPriority 下标)
+        std::array<size_t, kEventPriorityCount> lane_high_water{};
+        //! 所有通道之和的最大深度
+        size_t total_high_water = 0;
+    };
+
+    /**
+     * @struct SlowSubscriberStats
+     * @brief [!! 新增 !!] 慢回调看门狗对一个订阅者的记录。
+     * @see event::SlowCallbackEvent
+     */
+    struct SlowSubscriberStats {
+        std::weak_ptr<void> subscriber;
+        std::string source_plugin_path;  //!< 所属插件 (未知时为空)
+        EventId last_event_id = 0;       //!< 最近一次超时所处理的事件
+        uint64_t overruns = 0;           //!< 超时次数
+        uint64_t max_duration_ns = 0;    //!< 最长一次执行时间
+        bool demoted = false;            //!< 是否已被降级到隔离通道
+    };
+
+    /**
+     * @class IEventStats
+     * @brief [!! 新增 !!] [框架核心] 事件统计接口。
+     */
+    class IEventStats : public virtual IComponent {
+    public:
+        Z3Y_DEFINE_INTERFACE(IEventStats, "z3y-core-IEventStats-IID-A0000005", 1, 1)
+
+        /**
+         * @brief 开启或关闭统计。开启时重置全部统计。
+         */
+        virtual void EnableEventStats(bool enabled) = 0;
+
+        virtual bool IsEventStatsEnabled() const = 0;
+
+        /**
+         * @brief 获取所有有记录的 EventId 的统计。
+         */
+        virtual std::vector<EventStats> GetAllEventStats() const = 0;
+
+        /**
+         * @brief 获取一个 EventId 的统计。
+         * @return false 表示该事件在统计期间没有被发布。
+         */
+        virtual bool GetEventStats(EventId event_id, EventStats& out_stats) const = 0;
+
+        /**
+         * @brief 获取异步队列深度的高水位。
+         */
+        virtual EventQueueDepthStats GetQueueDepthStats() const = 0;
+
+        /**
+         * @brief 清零全部统计 (统计保持开启或关闭)。
+         */
+        virtual void ResetEventStats() = 0;
+
+        /**
+         * @brief [!! 新增 !!] [1.1] 获取超过回调预算的订阅者 (按超时次数降序)。
+         * 已析构的订阅者不再返回。
+         */
+        virtual std::vector<SlowSubscriberStats> GetSlowSubscribers() const = 0;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_FRAMEWORK_I_EVENT_STATS_H_
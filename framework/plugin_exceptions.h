@@ -131,7 +131,42 @@ namespace z3y {
          * 例如指针为空
          * )。
          */
-        kErrorInternal = 9
+        kErrorInternal = 9,
+
+        /**
+         * @brief
+         * [!! 新增 !!] 错误：
+         * 异步事件队列已满，
+         * 且溢出策略为 kReject
+         * (
+         * 事件未被投递
+         * )。
+         */
+        kErrorEventQueueFull = 10,
+
+        /**
+         * @brief
+         * [!! 新增 !!] 错误：
+         * 事件桥 (IEventBridge) 无法打开共享内存，
+         * 或事件载荷放不进槽位。
+         */
+        kErrorEventBridge = 11,
+
+        /**
+         * @brief
+         * [!! 新增 !!] 错误：
+         * 订阅的连接方式指向的宿主调度器
+         * (EventDispatcher) 已被移除。
+         */
+        kErrorDispatcherNotFound = 12,
+
+        /**
+         * @brief
+         * [!! 新增 !!] 错误：
+         * 事件等待 (co_await bus->Next<...>()) 尚未完成时
+         * PluginManager 清空了注册表 (卸载全部插件或析构)。
+         */
+        kErrorEventWaitCancelled = 13
     };
 
     /**
@@ -153,7 +188,11 @@ namespace z3y {
             {InstanceError::kErrorInterfaceNotImpl, "kErrorInterfaceNotImpl (IID not implemented)"},
             {InstanceError::kErrorVersionMajorMismatch, "kErrorVersionMajorMismatch (Major version mismatch)"},
             {InstanceError::kErrorVersionMinorTooLow, "kErrorVersionMinorTooLow (Plugin version is too old)"},
-            {InstanceError::kErrorInternal, "kErrorInternal"}
+            {InstanceError::kErrorInternal, "kErrorInternal"},
+            {InstanceError::kErrorEventQueueFull, "kErrorEventQueueFull (Async event queue is full)"},
+            {InstanceError::kErrorEventBridge, "kErrorEventBridge (Shared-memory event bridge failure)"},
+            {InstanceError::kErrorDispatcherNotFound, "kErrorDispatcherNotFound (Event dispatcher was removed)"},
+            {InstanceError::kErrorEventWaitCancelled, "kErrorEventWaitCancelled (Event wait was cancelled)"}
         };
 
         auto it = error_map.find(error);
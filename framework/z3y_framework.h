@@ -28,8 +28,10 @@
 
 // 4. 事件系统和内省
 #include "framework/i_event_bus.h"      // 提供 IEventBus
+#include "framework/i_event_bridge.h"   // [!! 新增 !!] 提供 IEventBridge
 #include "framework/i_plugin_query.h"   // 提供 IPluginQuery 
                                         // 
+#include "framework/i_event_stats.h"    // [!! 新增 !!] 提供 IEventStats
 #include "framework/connection_type.h"// IEventBus 依赖
 #include "framework_events.h"         // 框架标准事件
 #include "framework/plugin_exceptions.h" // [!! 
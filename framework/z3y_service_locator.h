@@ -185,24 +185,25 @@ namespace z3y {
      * (ע:  TSubscriber ̳ std::enable_shared_from_this)
      */
     template <typename TEvent, typename TSubscriber, typename TCallback>
-    inline void SubscribeGlobalEvent(std::shared_ptr<TSubscriber> subscriber,
+    inline EventConnection SubscribeGlobalEvent(std::shared_ptr<TSubscriber> subscriber,
         TCallback&& callback,
         ConnectionType type = ConnectionType::kDirect) {
 
         auto manager = PluginManager::GetActiveInstance();
         if (!manager) {
-            return; // Ĭʧ
+            return EventConnection(); // Ĭʧ
         }
 
         try {
             auto bus = manager->GetService<IEventBus>(clsid::kEventBus);
             if (bus) {
-                bus->SubscribeGlobal<TEvent>(subscriber, std::forward<TCallback>(callback), type);
+                return bus->SubscribeGlobal<TEvent>(subscriber, std::forward<TCallback>(callback), type);
             }
         }
         catch (const PluginException&) {
             // 
         }
+        return EventConnection();
     }
 
     /**
@@ -0,0 +1,123 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 事件对象与异步任务的池化分配 (event_pool.h) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 替换全局 operator new 并计数。kDirect、kQueued 与 kQueuedOrdered
+ * 订阅同一事件，预热之后的稳定状态下连续发布 kFires 次：
+ * - 事件对象、共享异步任务与 strand 任务都来自对象池，
+ * 整个过程的堆分配次数是常数级 (不随发布次数增长)。
+ *
+ * @note 共享库对 operator new 的调用只在 ELF 平台上被可执行文件的
+ * 替换版本截获；在 Windows 上 DLL 内的分配不会被计数。
+ *
+ * 用法：event_alloc_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+
+namespace {
+
+    constexpr int kFires = 100000;
+    constexpr long kMaxAllocations = 64;
+    constexpr auto kTimeout = std::chrono::seconds(60);
+
+    std::atomic<bool> g_counting{ false };
+    std::atomic<long> g_allocations{ 0 };
+
+    void* CountedAlloc(std::size_t size) {
+        if (g_counting.load(std::memory_order_relaxed)) {
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        void* p = std::malloc(size ? size : 1);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    class PooledEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(PooledEvent, "z3y-alloc-test-event")
+        explicit PooledEvent(int value) : value(value) {}
+        int value;
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct Counter : std::enable_shared_from_this<Counter> {
+        std::atomic<int> count{ 0 };
+        void OnEvent(const PooledEvent&) { ++count; }
+    };
+
+}  // namespace
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 2;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+    auto counter = std::make_shared<Counter>();
+    bus->SubscribeGlobal<PooledEvent>(counter, &Counter::OnEvent);
+    bus->SubscribeGlobal<PooledEvent>(counter, &Counter::OnEvent,
+        z3y::ConnectionType::kQueued);
+    bus->SubscribeGlobal<PooledEvent>(counter, &Counter::OnEvent,
+        z3y::ConnectionType::kQueuedOrdered);
+
+    // 预热：填满对象池与队列
+    for (int i = 0; i < kFires / 5; ++i) {
+        bus->FireGlobal<PooledEvent>(i);
+    }
+    bool ok = WaitFor([&] { return counter->count == 3 * (kFires / 5); });
+    const int warm = counter->count.load();
+
+    g_counting = true;
+    for (int i = 0; i < kFires; ++i) {
+        bus->FireGlobal<PooledEvent>(i);
+    }
+    ok = ok && WaitFor([&] { return counter->count == warm + 3 * kFires; });
+    g_counting = false;
+
+    // 确认计数生效 (可执行文件自身的分配)
+    g_counting = true;
+    const long before_probe = g_allocations.load();
+    delete new int(0);
+    const bool counting_works = g_allocations.load() == before_probe + 1;
+    g_counting = false;
+
+    const long allocations = before_probe;
+    std::printf("operator new calls for %d fires (3 subscriptions): %ld "
+        "(limit %ld)\n", kFires, allocations, kMaxAllocations);
+    ok = ok && counting_works && allocations <= kMaxAllocations;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] C++20 协程等待 (co_await bus->Next<TEvent>()) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 两个工作线程 (用 Z3Y_SANITIZE_THREAD 构建时在 ThreadSanitizer 下运行)：
+ * - 带谓词的 Next 只被满足谓词的事件恢复，恢复发生在工作线程上；
+ * - NextFor 超时返回空，NextFromFor 只接收指定发送者的事件；
+ * - UnloadAllPlugins 清空注册表时，尚在等待的 Next 以
+ * kErrorEventWaitCancelled 恢复，NextFor 返回空 (不会永久挂起)。
+ *
+ * 用法：event_await_test (退出码 0 表示通过；需要 C++20)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#if !Z3Y_HAS_COROUTINES
+#error "event_await_test requires C++20 coroutines"
+#endif
+
+namespace {
+
+    constexpr int kWaiters = 1000;
+    constexpr int kCancelled = 100;
+    constexpr auto kTimeout = std::chrono::seconds(60);
+
+    class PingEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(PingEvent, "z3y-await-test-ping")
+        explicit PingEvent(int value) : value(value) {}
+        int value;
+    };
+
+    class NeverEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(NeverEvent, "z3y-await-test-never")
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 立即开始、结束时自行销毁的协程。
+     */
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    struct Results {
+        std::thread::id main_thread;
+        std::atomic<int> matched{ 0 };
+        std::atomic<int> mismatched{ 0 };
+        std::atomic<int> on_main_thread{ 0 };
+        std::atomic<int> timed_out{ 0 };
+        std::atomic<int> from_sender{ 0 };
+        std::atomic<int> cancelled{ 0 };
+        std::atomic<int> cancelled_timed{ 0 };
+    };
+
+    Detached AwaitValue(z3y::IEventBus* bus, Results* results, int want) {
+        const PingEvent e = co_await bus->Next<PingEvent>(
+            [want](const PingEvent& ping) { return ping.value == want; });
+        if (std::this_thread::get_id() == results->main_thread) {
+            ++results->on_main_thread;
+        }
+        ++(e.value == want ? results->matched : results->mismatched);
+    }
+
+    Detached AwaitTimeout(z3y::IEventBus* bus, Results* results) {
+        auto e = co_await bus->NextFor<NeverEvent>(std::chrono::milliseconds(20));
+        if (!e) {
+            ++results->timed_out;
+        }
+    }
+
+    Detached AwaitSender(z3y::IEventBus* bus, Results* results,
+        std::shared_ptr<int> sender) {
+        auto e = co_await bus->NextFromFor<PingEvent>(sender,
+            std::chrono::seconds(30));
+        if (e && e->value == -1) {
+            ++results->from_sender;
+        }
+    }
+
+    Detached AwaitCancelled(z3y::IEventBus* bus, Results* results) {
+        try {
+            co_await bus->Next<NeverEvent>();
+        }
+        catch (const z3y::PluginException& e) {
+            if (e.GetError() == z3y::InstanceError::kErrorEventWaitCancelled) {
+                ++results->cancelled;
+            }
+        }
+    }
+
+    Detached AwaitCancelledTimed(z3y::IEventBus* bus, Results* results) {
+        auto e = co_await bus->NextFor<NeverEvent>(std::chrono::hours(1));
+        if (!e) {
+            ++results->cancelled_timed;
+        }
+    }
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 2;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+    Results results;
+    results.main_thread = std::this_thread::get_id();
+
+    // 1. 谓词、超时与发送者
+    auto sender = std::make_shared<int>(0);
+    for (int i = 0; i < kWaiters; ++i) {
+        AwaitValue(bus.get(), &results, i);
+    }
+    AwaitTimeout(bus.get(), &results);
+    AwaitSender(bus.get(), &results, sender);
+    bus->FireGlobal<PingEvent>(-1);  // 不满足任何谓词
+    for (int i = 0; i < kWaiters; ++i) {
+        bus->FireGlobal<PingEvent>(i);
+    }
+    bus->FireToSender<PingEvent>(sender, -1);
+    bool ok = WaitFor([&] {
+        return results.matched == kWaiters && results.timed_out == 1 &&
+            results.from_sender == 1;
+        });
+    std::printf("matched=%d mismatched=%d on_main_thread=%d timed_out=%d "
+        "from_sender=%d\n", results.matched.load(), results.mismatched.load(),
+        results.on_main_thread.load(), results.timed_out.load(),
+        results.from_sender.load());
+    ok = ok && results.mismatched == 0 && results.on_main_thread == 0;
+
+    // 2. 清空注册表时恢复尚在等待的协程
+    for (int i = 0; i < kCancelled; ++i) {
+        AwaitCancelled(bus.get(), &results);
+        AwaitCancelledTimed(bus.get(), &results);
+    }
+    manager->UnloadAllPlugins();
+    std::printf("cancelled: Next=%d NextFor=%d (expected %d each)\n",
+        results.cancelled.load(), results.cancelled_timed.load(), kCancelled);
+    ok = ok && results.cancelled == kCancelled &&
+        results.cancelled_timed == kCancelled;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 事件桥 (IEventBridge) 的跨进程测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 本程序启动自身的第二个实例 (子进程，参数 --child <通道名>)，两个进程
+ * 打开同一个通道：
+ * - 子进程 Export PongEvent、Import PingEvent，反复发布“就绪”直到收到
+ * 第一个 Ping (读者从附加时的 head 开始读，之前的记录不可见)；
+ * - 父进程 Export PingEvent、Import PongEvent，收到“就绪”后发布
+ * kPingCount 个 Ping；
+ * - 子进程校验每条载荷 (序号连续、校验字段与序号一致，撕裂的记录
+ * 无法通过)，再以 Pong 回报收到的条数，父进程据此判定结果。
+ *
+ * 启动子进程之前，父进程先在本地内存上检查 SharedEventRing：槽位仍被
+ * 上一圈的写者占用时，新的写者放弃记录，而不是接管槽位。
+ *
+ * 用法：event_bridge_test (退出码 0 表示通过)
+ *
+ * Windows：解决方案中的 event_bridge_test 项目。
+ * Linux：见仓库根目录的 CMakeLists.txt (ctest 运行本测试)。
+ */
+
+#include "framework/z3y_framework.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shared_event_ring.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr int kPingCount = 500;
+    constexpr int kReady = -1;
+    constexpr uint64_t kCheckMultiplier = 0x9E3779B97F4A7C15ULL;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    struct PingPayload {
+        int32_t sequence;
+        uint64_t check;  //!< sequence * kCheckMultiplier
+        char text[64];
+    };
+
+    struct PongPayload {
+        int32_t received;  //!< 收到的 Ping 数；kReady 表示子进程已就绪
+        int32_t errors;
+    };
+
+    class PingEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(PingEvent, "z3y-bridge-test-ping")
+        Z3Y_DEFINE_EVENT_BRIDGED(payload)
+
+        PingEvent() = default;
+        explicit PingEvent(int32_t sequence) {
+            payload.sequence = sequence;
+            payload.check = static_cast<uint64_t>(sequence) * kCheckMultiplier;
+            std::snprintf(payload.text, sizeof(payload.text), "ping #%d", sequence);
+        }
+
+        PingPayload payload{};
+    };
+
+    class PongEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(PongEvent, "z3y-bridge-test-pong")
+        Z3Y_DEFINE_EVENT_BRIDGED(payload)
+
+        PongEvent() = default;
+        PongEvent(int32_t received, int32_t errors) {
+            payload.received = received;
+            payload.errors = errors;
+        }
+
+        PongPayload payload{};
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    z3y::EventBridgeOptions MakeOptions(const std::string& channel) {
+        z3y::EventBridgeOptions options;
+        options.channel = channel;
+        options.slot_count = 1024;  // 大于 kPingCount：正常情况下不会覆盖
+        return options;
+    }
+
+    // --- 环的单进程检查 ---
+
+    /**
+     * @brief 写者 0 在复制载荷途中停住；写者 2 领取同一槽位，必须放弃记录，
+     * 写者 0 恢复后它的记录完整可读。
+     */
+    bool CheckHeldSlotIsNotTakenOver() {
+        constexpr size_t kSlots = 2;
+        constexpr size_t kSlotSize = 128;
+        std::vector<unsigned char> memory(
+            z3y::SharedEventRing::RequiredSize(kSlots, kSlotSize) + 64);
+        void* base = memory.data() + (64 - reinterpret_cast<uintptr_t>(
+            memory.data()) % 64) % 64;
+        z3y::SharedEventRing::Initialize(base, kSlots, kSlotSize);
+        z3y::SharedEventRing ring;
+        std::string error;
+        if (!ring.Attach(base, z3y::SharedEventRing::RequiredSize(kSlots, kSlotSize),
+            error)) {
+            std::fprintf(stderr, "ring: %s\n", error.c_str());
+            return false;
+        }
+
+        std::atomic<bool> filling{ false };
+        std::atomic<bool> resume{ false };
+        std::thread stalled([&] {
+            ring.Write(1, 7, sizeof(int32_t), [&](void* payload) {
+                filling.store(true);
+                while (!resume.load()) {
+                    std::this_thread::yield();
+                }
+                const int32_t value = 100;
+                std::memcpy(payload, &value, sizeof(value));
+                });
+            });
+        while (!filling.load()) {
+            std::this_thread::yield();
+        }
+        const auto fill = [](int32_t value) {
+            return [value](void* payload) {
+                std::memcpy(payload, &value, sizeof(value));
+                };
+            };
+        const bool wrote_1 = ring.Write(1, 7, sizeof(int32_t), fill(101));
+        const bool wrote_2 = ring.Write(1, 7, sizeof(int32_t), fill(102));  // 槽位 0
+        resume.store(true);
+        stalled.join();
+
+        uint64_t cursor = 0;
+        uint64_t lost = 0;
+        int32_t first = 0;
+        const auto status = ring.Read(cursor, lost, first,
+            [](uint64_t, z3y::EventId, const void* payload, size_t) {
+                int32_t value = 0;
+                std::memcpy(&value, payload, sizeof(value));
+                return value;
+            });
+        if (!wrote_1 || wrote_2 ||
+            status != z3y::SharedEventRing::ReadStatus::kRecord || first != 100) {
+            std::fprintf(stderr, "ring: a held slot was taken over\n");
+            return false;
+        }
+        return true;
+    }
+
+    // --- 子进程 ---
+
+    int RunChild(const std::string& channel) {
+        z3y::PluginPtr<z3y::PluginManager> manager = z3y::PluginManager::Create();
+        z3y::PluginPtr<z3y::IEventBus> bus =
+            manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+        z3y::PluginPtr<z3y::IEventBridge> bridge =
+            manager->GetService<z3y::IEventBridge>(z3y::clsid::kEventBridge);
+        bridge->Export<PongEvent>();
+        bridge->Import<PingEvent>();
+        bridge->Open(MakeOptions(channel));
+
+        std::atomic<int32_t> received{ 0 };
+        std::atomic<int32_t> errors{ 0 };
+        z3y::ScopedEventConnection connection = bus->SubscribeGlobal<PingEvent>(
+            [&](const PingEvent& e) {
+                const PingPayload& p = e.payload;
+                char text[64];
+                std::snprintf(text, sizeof(text), "ping #%d", p.sequence);
+                if (p.sequence != received.load() ||
+                    p.check != static_cast<uint64_t>(p.sequence) * kCheckMultiplier ||
+                    std::strcmp(p.text, text) != 0) {
+                    errors.fetch_add(1);
+                }
+                received.fetch_add(1);
+            });
+
+        // 1. 反复报告就绪，直到父进程的第一个 Ping 到达
+        const bool started = WaitFor([&] {
+            bus->FireGlobal<PongEvent>(kReady, 0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return received.load() != 0;
+            });
+        if (!started) {
+            std::fprintf(stderr, "child: no ping from parent\n");
+            return 2;
+        }
+
+        // 2. 收齐后回报结果
+        WaitFor([&] { return received.load() >= kPingCount; });
+        bus->FireGlobal<PongEvent>(received.load(), errors.load());
+
+        // 等父进程读到结果后再关闭 (读者只读取附加之后的记录，关闭不影响已写入的)
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        bridge->Close();
+        return received.load() == kPingCount && errors.load() == 0 ? 0 : 1;
+    }
+
+    // --- 父进程 ---
+
+#if defined(_WIN32)
+    using ChildHandle = HANDLE;
+
+    ChildHandle SpawnChild(const char*, const std::string& channel) {
+        wchar_t path[MAX_PATH];
+        GetModuleFileNameW(nullptr, path, MAX_PATH);
+        std::wstring command = L"\"" + std::wstring(path) + L"\" --child " +
+            std::wstring(channel.begin(), channel.end());
+        STARTUPINFOW startup{};
+        startup.cb = sizeof(startup);
+        PROCESS_INFORMATION info{};
+        if (!CreateProcessW(path, &command[0], nullptr, nullptr, FALSE, 0,
+            nullptr, nullptr, &startup, &info)) {
+            return nullptr;
+        }
+        CloseHandle(info.hThread);
+        return info.hProcess;
+    }
+
+    int WaitChild(ChildHandle child) {
+        WaitForSingleObject(child, INFINITE);
+        DWORD code = 1;
+        GetExitCodeProcess(child, &code);
+        CloseHandle(child);
+        return static_cast<int>(code);
+    }
+
+    std::string MakeChannelName() {
+        return "z3y-bridge-test-" + std::to_string(GetCurrentProcessId());
+    }
+#else
+    using ChildHandle = pid_t;
+
+    ChildHandle SpawnChild(const char* self, const std::string& channel) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            execl(self, self, "--child", channel.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        return pid;
+    }
+
+    int WaitChild(ChildHandle child) {
+        int status = 0;
+        if (waitpid(child, &status, 0) != child || !WIFEXITED(status)) {
+            return 1;
+        }
+        return WEXITSTATUS(status);
+    }
+
+    std::string MakeChannelName() {
+        return "z3y-bridge-test-" + std::to_string(getpid());
+    }
+#endif
+
+    int RunParent(const char* self) {
+        if (!CheckHeldSlotIsNotTakenOver()) {
+            std::printf("FAILED\n");
+            return 1;
+        }
+        const std::string channel = MakeChannelName();
+
+        z3y::PluginPtr<z3y::PluginManager> manager = z3y::PluginManager::Create();
+        z3y::PluginPtr<z3y::IEventBus> bus =
+            manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+        z3y::PluginPtr<z3y::IEventBridge> bridge =
+            manager->GetService<z3y::IEventBridge>(z3y::clsid::kEventBridge);
+        bridge->Export<PingEvent>();
+        bridge->Import<PongEvent>();
+        z3y::EventBridgeOptions options = MakeOptions(channel);
+        options.remove_on_close = true;
+        bridge->Open(options);
+
+        std::atomic<bool> ready{ false };
+        std::atomic<int32_t> received{ -1 };
+        std::atomic<int32_t> errors{ -1 };
+        z3y::ScopedEventConnection connection = bus->SubscribeGlobal<PongEvent>(
+            [&](const PongEvent& e) {
+                if (e.payload.received == kReady) {
+                    ready.store(true);
+                }
+                else {
+                    errors.store(e.payload.errors);
+                    received.store(e.payload.received);
+                }
+            });
+
+        ChildHandle child = SpawnChild(self, channel);
+        if (!child) {
+            std::fprintf(stderr, "parent: cannot start the child process\n");
+            return 1;
+        }
+
+        bool ok = WaitFor([&] { return ready.load(); });
+        if (ok) {
+            for (int32_t i = 0; i < kPingCount; ++i) {
+                bus->FireGlobal<PingEvent>(i);
+            }
+            ok = WaitFor([&] { return received.load() >= 0; });
+        }
+        const int child_code = WaitChild(child);
+        bridge->Close();
+
+        const z3y::EventBridgeStats stats = bridge->GetStats();
+        std::printf("child received %d/%d pings, %d corrupt; exported=%llu "
+            "imported=%llu lost=%llu; child exit code %d\n",
+            received.load(), kPingCount, errors.load(),
+            static_cast<unsigned long long>(stats.exported),
+            static_cast<unsigned long long>(stats.imported),
+            static_cast<unsigned long long>(stats.lost), child_code);
+        if (!ok || child_code != 0 || received.load() != kPingCount ||
+            errors.load() != 0) {
+            std::printf("FAILED\n");
+            return 1;
+        }
+        std::printf("PASSED\n");
+        return 0;
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::strcmp(argv[1], "--child") == 0) {
+        return RunChild(argv[2]);
+    }
+    return RunParent(argv[0]);
+}
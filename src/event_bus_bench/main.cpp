@@ -0,0 +1,427 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 事件总线的微基准测试 (FireGlobalImpl / FireToSenderImpl /
+ * SubscribeGlobalImpl / Unsubscribe 的回归测量)。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 每个用例输出：操作数、吞吐 (ops/s)、单次操作延迟的 p50 / p99 (纳秒)
+ * 与每次操作的堆分配次数。用例：
+ * - fire_global/direct/N    ：N 个 kDirect 订阅者的全局发布 (N = 0/1/10/1000)
+ * - fire_global/queued/N    ：N 个 kQueued 订阅者；延迟为发布方耗时，
+ *                             吞吐包含工作线程执行完所有回调的时间
+ * - fire_to_sender/S        ：S 个发送者 (各一个订阅者) 轮流发布
+ * - subscribe / unsubscribe ：订阅表中已有 1000 个订阅时的增删
+ * - fire_global/threadsT    ：T 个线程并发发布 (10 个 kDirect 订阅者)
+ * - expired_cleanup/N       ：N 个订阅者同时析构后，从下一次发布发现失效
+ *                             到 GC 全部回收；一次操作 = 回收一个失效订阅，
+ *                             延迟为清扫期间每次发布的耗时
+ *
+ * 用法：event_bus_bench [用例名子串] [--quick]
+ *
+ * Windows：解决方案中的 event_bus_bench 项目 (Release 配置)。
+ * Linux (在仓库根目录，见 CMakeLists.txt)：
+ * @code
+ * cmake -S . -B build/linux -DCMAKE_BUILD_TYPE=Release
+ * cmake --build build/linux --target event_bus_bench -j
+ * build/linux/bin/event_bus_bench --quick
+ * @endcode
+ *
+ * @note 分配计数通过替换本程序的全局 operator new 实现。Linux 上共享库内部的
+ * 分配同样计入；MSVC 下 DLL 使用自己的 CRT 堆，只能计入头文件模板
+ * (例如事件对象的 allocate_shared) 在本程序中产生的分配。
+ */
+
+#include "framework/z3y_framework.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- 分配计数 ---
+
+namespace {
+    std::atomic<uint64_t> g_allocations{ 0 };
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // --- 基准事件与订阅者 ---
+
+    struct BenchEvent : public z3y::Event {
+        Z3Y_DEFINE_EVENT(BenchEvent, "z3y-bench-BenchEvent")
+        explicit BenchEvent(uint64_t v) : value(v) {}
+        uint64_t value;
+    };
+
+    struct Subscriber : public std::enable_shared_from_this<Subscriber> {
+        std::atomic<uint64_t> received{ 0 };
+        void OnEvent(const BenchEvent&) {
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    struct Sender : public std::enable_shared_from_this<Sender> {};
+
+    using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+    // --- 计时与报告 ---
+
+    /**
+     * @struct Result
+     * @brief 一个用例的测量结果。
+     */
+    struct Result {
+        std::string name;
+        uint64_t ops = 0;
+        double seconds = 0.0;
+        std::vector<uint64_t> latencies_ns;  // 单次操作耗时 (可少于 ops)
+        uint64_t allocations = 0;
+    };
+
+    struct Config {
+        std::string filter;
+        bool quick = false;
+        size_t Scale(size_t n) const { return quick ? std::max<size_t>(n / 10, 1) : n; }
+    };
+
+    uint64_t ElapsedNs(Clock::time_point start, Clock::time_point end) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    size_t Warmup(size_t ops) {
+        return std::min<size_t>(ops / 10 + 1, 10000);
+    }
+
+    uint64_t Percentile(std::vector<uint64_t>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        const size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    void PrintHeader() {
+        std::printf("%-28s %10s %14s %10s %10s %10s\n",
+            "benchmark", "ops", "ops/s", "p50(ns)", "p99(ns)", "allocs/op");
+    }
+
+    void Print(Result& r) {
+        std::sort(r.latencies_ns.begin(), r.latencies_ns.end());
+        std::printf("%-28s %10llu %14.0f %10llu %10llu %10.2f\n",
+            r.name.c_str(), static_cast<unsigned long long>(r.ops),
+            r.seconds > 0 ? static_cast<double>(r.ops) / r.seconds : 0.0,
+            static_cast<unsigned long long>(Percentile(r.latencies_ns, 50.0)),
+            static_cast<unsigned long long>(Percentile(r.latencies_ns, 99.0)),
+            r.ops ? static_cast<double>(r.allocations) / static_cast<double>(r.ops) : 0.0);
+        std::fflush(stdout);
+    }
+
+    /**
+     * @brief 执行 ops 次 op，逐次计时。
+     * @details 先以下标 [ops, ops + Warmup(ops)) 预热，再以 [0, ops) 计时。
+     * @param settle 可选：计时结束前调用 (例如等待异步回调执行完)，计入总耗时。
+     */
+    template <typename Op, typename Settle>
+    Result Measure(const std::string& name, size_t ops, Op&& op, Settle&& settle) {
+        Result r;
+        r.name = name;
+        r.ops = ops;
+        r.latencies_ns.resize(ops);  // 预先分配，不计入
+        for (size_t i = ops; i < ops + Warmup(ops); ++i) {
+            op(i);
+        }
+        settle();
+
+        const uint64_t alloc_start = g_allocations.load(std::memory_order_relaxed);
+        const Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < ops; ++i) {
+            const Clock::time_point t0 = Clock::now();
+            op(i);
+            r.latencies_ns[i] = ElapsedNs(t0, Clock::now());
+        }
+        settle();
+        r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        r.allocations = g_allocations.load(std::memory_order_relaxed) - alloc_start;
+        return r;
+    }
+
+    template <typename Op>
+    Result Measure(const std::string& name, size_t ops, Op&& op) {
+        return Measure(name, ops, std::forward<Op>(op), []() {});
+    }
+
+    SubscriberList SubscribeMany(z3y::IEventBus& bus, size_t count,
+        z3y::ConnectionType type) {
+        SubscriberList subs;
+        subs.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            subs.push_back(std::make_shared<Subscriber>());
+            bus.SubscribeGlobal<BenchEvent>(subs.back(), &Subscriber::OnEvent, type);
+        }
+        return subs;
+    }
+
+    void UnsubscribeAll(z3y::IEventBus& bus, SubscriberList& subs) {
+        for (const auto& sub : subs) {
+            bus.Unsubscribe(sub);
+        }
+        subs.clear();
+    }
+
+    uint64_t TotalReceived(const SubscriberList& subs) {
+        uint64_t total = 0;
+        for (const auto& sub : subs) {
+            total += sub->received.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 等待 GC 清空所有待回收的失效订阅。
+     */
+    void WaitForGc(z3y::PluginManager& manager) {
+        for (int i = 0; i < 10000; ++i) {
+            const z3y::EventGcStats stats = manager.GetEventGcStats();
+            if (!stats.sweep_requested && stats.pending_sweep_keys == 0 &&
+                stats.pending_lookup_entries == 0) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // --- 用例 ---
+
+    void BenchFireDirect(z3y::IEventBus& bus, const Config& config,
+        std::vector<Result>& results) {
+        for (size_t fan_out : { 0, 1, 10, 1000 }) {
+            SubscriberList subs = SubscribeMany(bus, fan_out, z3y::ConnectionType::kDirect);
+            const size_t ops = config.Scale(fan_out >= 1000 ? 20000 : 1000000);
+            results.push_back(Measure("fire_global/direct/" + std::to_string(fan_out), ops,
+                [&](size_t i) { bus.FireGlobal<BenchEvent>(i); }));
+            UnsubscribeAll(bus, subs);
+        }
+    }
+
+    void BenchFireQueued(z3y::IEventBus& bus, const Config& config,
+        std::vector<Result>& results) {
+        for (size_t fan_out : { 1, 10, 1000 }) {
+            SubscriberList subs = SubscribeMany(bus, fan_out, z3y::ConnectionType::kQueued);
+            const size_t ops = config.Scale(fan_out >= 1000 ? 20000 : 200000);
+            uint64_t fired = 0;
+            results.push_back(Measure("fire_global/queued/" + std::to_string(fan_out), ops,
+                [&](size_t i) { bus.FireGlobal<BenchEvent>(i); ++fired; },
+                [&]() {
+                    while (TotalReceived(subs) < fired * fan_out) {
+                        std::this_thread::yield();
+                    }
+                }));
+            UnsubscribeAll(bus, subs);
+        }
+    }
+
+    void BenchFireToSender(z3y::IEventBus& bus, const Config& config,
+        std::vector<Result>& results) {
+        const size_t sender_count = 10000;
+        std::vector<std::shared_ptr<Sender>> senders;
+        SubscriberList subs;
+        for (size_t i = 0; i < sender_count; ++i) {
+            senders.push_back(std::make_shared<Sender>());
+            subs.push_back(std::make_shared<Subscriber>());
+            bus.SubscribeToSender<BenchEvent>(senders.back(), subs.back(),
+                &Subscriber::OnEvent);
+        }
+        results.push_back(Measure("fire_to_sender/" + std::to_string(sender_count),
+            config.Scale(1000000),
+            [&](size_t i) {
+                bus.FireToSender<BenchEvent>(senders[i % sender_count], i);
+            }));
+        UnsubscribeAll(bus, subs);
+    }
+
+    void BenchChurn(z3y::IEventBus& bus, const Config& config,
+        std::vector<Result>& results) {
+        SubscriberList background = SubscribeMany(bus, 1000, z3y::ConnectionType::kDirect);
+        const size_t ops = config.Scale(100000);
+        SubscriberList subs;
+        for (size_t i = 0; i < ops + Warmup(ops); ++i) {
+            subs.push_back(std::make_shared<Subscriber>());
+        }
+
+        // 两个用例的预热下标相同：unsubscribe 预热退订的正是 subscribe 预热订阅的
+        results.push_back(Measure("subscribe/1000", ops,
+            [&](size_t i) {
+                bus.SubscribeGlobal<BenchEvent>(subs[i], &Subscriber::OnEvent);
+            }));
+        results.push_back(Measure("unsubscribe/1000", ops,
+            [&](size_t i) { bus.Unsubscribe(subs[i]); }));
+        UnsubscribeAll(bus, subs);
+        UnsubscribeAll(bus, background);
+    }
+
+    void BenchConcurrentFire(z3y::IEventBus& bus, const Config& config,
+        std::vector<Result>& results) {
+        SubscriberList subs = SubscribeMany(bus, 10, z3y::ConnectionType::kDirect);
+        const size_t hardware = std::thread::hardware_concurrency();
+        for (size_t thread_count = 2;
+            thread_count <= std::max<size_t>(std::min<size_t>(hardware, 8), 4);
+            thread_count *= 2) {
+            const size_t per_thread = config.Scale(200000);
+            Result r;
+            r.name = "fire_global/threads" + std::to_string(thread_count);
+            r.ops = per_thread * thread_count;
+            std::vector<std::vector<uint64_t>> latencies(thread_count,
+                std::vector<uint64_t>(per_thread));
+            std::atomic<size_t> ready{ 0 };
+            std::atomic<bool> go{ false };
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&, t]() {
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    for (size_t i = 0; i < per_thread; ++i) {
+                        const Clock::time_point t0 = Clock::now();
+                        bus.FireGlobal<BenchEvent>(i);
+                        latencies[t][i] = ElapsedNs(t0, Clock::now());
+                    }
+                });
+            }
+            while (ready.load() < thread_count) {
+                std::this_thread::yield();
+            }
+            const uint64_t alloc_start = g_allocations.load(std::memory_order_relaxed);
+            const Clock::time_point start = Clock::now();
+            go.store(true, std::memory_order_release);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            r.allocations = g_allocations.load(std::memory_order_relaxed) - alloc_start;
+            for (const auto& per : latencies) {
+                r.latencies_ns.insert(r.latencies_ns.end(), per.begin(), per.end());
+            }
+            results.push_back(std::move(r));
+        }
+        UnsubscribeAll(bus, subs);
+    }
+
+    void BenchExpiredCleanup(z3y::PluginManager& manager, z3y::IEventBus& bus,
+        const Config& config, std::vector<Result>& results) {
+        const size_t count = config.Scale(100000);
+        SubscriberList keep = SubscribeMany(bus, 1, z3y::ConnectionType::kDirect);
+        SubscriberList doomed = SubscribeMany(bus, count, z3y::ConnectionType::kDirect);
+        WaitForGc(manager);
+
+        const z3y::EventGcStats before = manager.GetEventGcStats();
+        Result r;
+        r.name = "expired_cleanup/" + std::to_string(count);
+        r.latencies_ns.reserve(1000000);
+        const uint64_t alloc_start = g_allocations.load(std::memory_order_relaxed);
+        const Clock::time_point start = Clock::now();
+        doomed.clear();  // 订阅者析构，订阅失效但仍留在快照中
+        uint64_t value = 0;
+        for (;;) {
+            const Clock::time_point t0 = Clock::now();
+            bus.FireGlobal<BenchEvent>(value++);
+            if (r.latencies_ns.size() < r.latencies_ns.capacity()) {
+                r.latencies_ns.push_back(ElapsedNs(t0, Clock::now()));
+            }
+            const z3y::EventGcStats stats = manager.GetEventGcStats();
+            if (stats.subscriptions_reclaimed - before.subscriptions_reclaimed >= count) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+        r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        r.allocations = g_allocations.load(std::memory_order_relaxed) - alloc_start;
+        r.ops = count;
+        results.push_back(std::move(r));
+        WaitForGc(manager);
+        UnsubscribeAll(bus, keep);
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            config.quick = true;
+        }
+        else {
+            config.filter = argv[i];
+        }
+    }
+
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 2;
+    z3y::PluginPtr<z3y::PluginManager> manager = z3y::PluginManager::Create(options);
+    z3y::PluginPtr<z3y::IEventBus> bus =
+        manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+
+    struct Suite {
+        const char* name;
+        void (*run)(z3y::PluginManager&, z3y::IEventBus&, const Config&,
+            std::vector<Result>&);
+    };
+    const Suite suites[] = {
+        { "fire_global/direct", [](z3y::PluginManager&, z3y::IEventBus& b,
+            const Config& c, std::vector<Result>& r) { BenchFireDirect(b, c, r); } },
+        { "fire_global/queued", [](z3y::PluginManager&, z3y::IEventBus& b,
+            const Config& c, std::vector<Result>& r) { BenchFireQueued(b, c, r); } },
+        { "fire_to_sender", [](z3y::PluginManager&, z3y::IEventBus& b,
+            const Config& c, std::vector<Result>& r) { BenchFireToSender(b, c, r); } },
+        { "subscribe/unsubscribe", [](z3y::PluginManager&, z3y::IEventBus& b,
+            const Config& c, std::vector<Result>& r) { BenchChurn(b, c, r); } },
+        { "fire_global/threads", [](z3y::PluginManager&, z3y::IEventBus& b,
+            const Config& c, std::vector<Result>& r) { BenchConcurrentFire(b, c, r); } },
+        { "expired_cleanup", [](z3y::PluginManager& m, z3y::IEventBus& b,
+            const Config& c, std::vector<Result>& r) { BenchExpiredCleanup(m, b, c, r); } },
+    };
+
+    PrintHeader();
+    for (const Suite& suite : suites) {
+        if (!config.filter.empty() &&
+            std::string(suite.name).find(config.filter) == std::string::npos) {
+            continue;
+        }
+        std::vector<Result> results;
+        suite.run(*manager, *bus, config, results);
+        for (Result& result : results) {
+            Print(result);
+        }
+    }
+    return 0;
+}
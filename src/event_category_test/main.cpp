@@ -0,0 +1,150 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 事件类别 (Z3Y_DEFINE_EVENT_CATEGORY) 订阅继承的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 类别链 LeafEvent -> MidEvent -> BaseEvent，另有若干首次发布较晚的后代：
+ * - 全局订阅：先订阅类别、后登记后代事件 (继承) 与先登记、后订阅
+ * (传播) 都生效，每个后代事件只投递一次；批量订阅只匹配确切类型；
+ * - 发送者订阅：后代事件晚于订阅登记时，只继承该发送者的类别订阅，
+ * 其他发送者与全局发布不受影响；大量发送者订阅了无关事件时同样正确；
+ * - Unsubscribe 之后登记的后代事件不再继承已移除的订阅
+ * (列表清空的发送者键从类别索引中移除)。
+ *
+ * 用法：event_category_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+    constexpr int kUnrelatedSenders = 1000;
+
+    class BaseEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(BaseEvent, "z3y-category-test-base")
+    };
+
+    class MidEvent : public BaseEvent {
+    public:
+        Z3Y_DEFINE_EVENT(MidEvent, "z3y-category-test-mid")
+        Z3Y_DEFINE_EVENT_CATEGORY(BaseEvent)
+    };
+
+    class LeafEvent : public MidEvent {
+    public:
+        Z3Y_DEFINE_EVENT(LeafEvent, "z3y-category-test-leaf")
+        Z3Y_DEFINE_EVENT_CATEGORY(MidEvent)
+    };
+
+    class LateLeafEvent : public MidEvent {
+    public:
+        Z3Y_DEFINE_EVENT(LateLeafEvent, "z3y-category-test-late-leaf")
+        Z3Y_DEFINE_EVENT_CATEGORY(MidEvent)
+    };
+
+    class LateBaseEvent : public BaseEvent {
+    public:
+        Z3Y_DEFINE_EVENT(LateBaseEvent, "z3y-category-test-late-base")
+        Z3Y_DEFINE_EVENT_CATEGORY(BaseEvent)
+    };
+
+    class AfterUnsubscribeEvent : public BaseEvent {
+    public:
+        Z3Y_DEFINE_EVENT(AfterUnsubscribeEvent,
+            "z3y-category-test-after-unsubscribe")
+        Z3Y_DEFINE_EVENT_CATEGORY(BaseEvent)
+    };
+
+    class UnrelatedEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(UnrelatedEvent, "z3y-category-test-unrelated")
+    };
+
+    struct Receiver : std::enable_shared_from_this<Receiver> {
+        std::atomic<int> base{ 0 };
+        std::atomic<int> mid{ 0 };
+        std::atomic<int> batched{ 0 };
+        std::atomic<int> unrelated{ 0 };
+        void OnBase(const BaseEvent&) { ++base; }
+        void OnMid(const MidEvent&) { ++mid; }
+        void OnBatch(z3y::EventSpan<BaseEvent> events) {
+            batched += static_cast<int>(events.size());
+        }
+        void OnUnrelated(const UnrelatedEvent&) { ++unrelated; }
+    };
+
+}  // namespace
+
+int main() {
+    auto manager = z3y::PluginManager::Create();
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+    bool ok = true;
+
+    // 1. 全局：订阅类别时后代事件尚未登记 (首次发布时继承)
+    auto early = std::make_shared<Receiver>();
+    bus->SubscribeGlobal<BaseEvent>(early, &Receiver::OnBase);
+    bus->SubscribeGlobal<MidEvent>(early, &Receiver::OnMid);
+    bus->SubscribeGlobalBatch<BaseEvent>(early, &Receiver::OnBatch);
+    bus->FireGlobal<LeafEvent>();
+    ok = ok && early->base == 1 && early->mid == 1 && early->batched == 0;
+    bus->FireGlobal<MidEvent>();
+    bus->FireGlobal<BaseEvent>();
+    ok = ok && early->base == 3 && early->mid == 2 && early->batched == 1;
+
+    // 2. 全局：后代事件已登记之后订阅 (传播)
+    auto late = std::make_shared<Receiver>();
+    bus->SubscribeGlobal<BaseEvent>(late, &Receiver::OnBase);
+    bus->FireGlobal<LeafEvent>();
+    bus->FireGlobal<LateBaseEvent>();
+    std::printf("global: early base=%d mid=%d batched=%d late base=%d\n",
+        early->base.load(), early->mid.load(), early->batched.load(),
+        late->base.load());
+    ok = ok && late->base == 2 && early->base == 5 && early->mid == 3;
+
+    // 3. 发送者：大量无关的发送者订阅，后代事件晚于类别订阅登记
+    std::vector<std::shared_ptr<int>> unrelated_senders;
+    auto unrelated = std::make_shared<Receiver>();
+    for (int i = 0; i < kUnrelatedSenders; ++i) {
+        unrelated_senders.push_back(std::make_shared<int>(i));
+        bus->SubscribeToSender<UnrelatedEvent>(unrelated_senders.back(),
+            unrelated, &Receiver::OnUnrelated);
+    }
+    auto sender = std::make_shared<int>(0);
+    auto other = std::make_shared<int>(0);
+    auto from_sender = std::make_shared<Receiver>();
+    bus->SubscribeToSender<BaseEvent>(sender, from_sender, &Receiver::OnBase);
+    bus->SubscribeToSender<MidEvent>(sender, from_sender, &Receiver::OnMid);
+    bus->FireToSender<LateLeafEvent>(sender);
+    bus->FireToSender<LateLeafEvent>(other);
+    bus->FireToSender<UnrelatedEvent>(unrelated_senders.front());
+    std::printf("sender: base=%d mid=%d unrelated=%d\n",
+        from_sender->base.load(), from_sender->mid.load(),
+        unrelated->unrelated.load());
+    ok = ok && from_sender->base == 1 && from_sender->mid == 1 &&
+        unrelated->unrelated == 1;
+    const int global_base = early->base;
+    bus->FireGlobal<LateLeafEvent>();
+    ok = ok && from_sender->base == 1 && early->base == global_base + 1;
+
+    // 4. 移除后登记的后代事件不再继承
+    bus->Unsubscribe(from_sender);
+    bus->Unsubscribe(early);
+    bus->FireToSender<AfterUnsubscribeEvent>(sender);
+    bus->FireGlobal<AfterUnsubscribeEvent>();
+    std::printf("after unsubscribe: sender base=%d early base=%d late base=%d\n",
+        from_sender->base.load(), early->base.load(), late->base.load());
+    ok = ok && from_sender->base == 1 && early->base == global_base + 1 &&
+        late->base == 4;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
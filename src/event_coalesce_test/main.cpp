@@ -0,0 +1,232 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 合并投递 (ConnectionType::kQueuedCoalesced) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 用例：
+ * - blocked_worker：唯一的工作线程被闸门回调占住时连续发布 1000 次
+ * (全局与某个发送者各一个合并订阅)：队列中每个订阅至多一个任务，
+ * 闸门打开后每个订阅只收到一次、且是最后一个事件；之后的批次与
+ * FireGlobalAsync 同样只投递最新的事件；
+ * - parallel：四个工作线程下连续发布，回调从不并发、收到的值单调递增，
+ * 最后一个事件一定被投递；
+ * - dropped：合并任务因队列已满被丢弃时，完成句柄照常完成，
+ * 之后的发布重新投递 (合并槽位没有卡在“已入队”状态)。
+ *
+ * 用法：event_coalesce_test <用例> (退出码 0 表示通过；一个进程只能有一个
+ * PluginManager，因此每次运行一个用例，ctest 逐个运行)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class StateEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(StateEvent, "z3y-coalesce-test-state")
+        explicit StateEvent(int value) : value(value) {}
+        int value;
+    };
+
+    class GateEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(GateEvent, "z3y-coalesce-test-gate")
+    };
+
+    class FillEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(FillEvent, "z3y-coalesce-test-fill")
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 记录收到的状态；发现并发调用或值回退时置位 bad。
+     */
+    struct Receiver : std::enable_shared_from_this<Receiver> {
+        std::atomic<int> count{ 0 };
+        std::atomic<int> last{ -1 };
+        std::atomic<int> inside{ 0 };
+        std::atomic<bool> bad{ false };
+
+        void OnState(const StateEvent& e) {
+            if (inside.fetch_add(1) != 0 || e.value <= last) {
+                bad = true;
+            }
+            last = e.value;
+            ++count;
+            --inside;
+        }
+    };
+
+    struct Gate : std::enable_shared_from_this<Gate> {
+        std::atomic<bool> entered{ false };
+        std::atomic<bool> open{ false };
+
+        void OnGate(const GateEvent&) {
+            entered = true;
+            while (!open.load()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        void OnFill(const FillEvent&) {}
+    };
+
+    struct Fixture {
+        std::shared_ptr<z3y::PluginManager> manager;
+        std::shared_ptr<z3y::IEventBus> bus;
+        std::shared_ptr<Receiver> global = std::make_shared<Receiver>();
+        std::shared_ptr<Receiver> from_sender = std::make_shared<Receiver>();
+        std::shared_ptr<Gate> gate = std::make_shared<Gate>();
+        std::shared_ptr<int> sender = std::make_shared<int>(0);
+
+        explicit Fixture(const z3y::PluginManagerOptions& options) {
+            manager = z3y::PluginManager::Create(options);
+            bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+            bus->SubscribeGlobal<StateEvent>(global, &Receiver::OnState,
+                z3y::ConnectionType::kQueuedCoalesced);
+            bus->SubscribeToSender<StateEvent>(sender, from_sender,
+                &Receiver::OnState, z3y::ConnectionType::kQueuedCoalesced);
+            bus->SubscribeGlobal<GateEvent>(gate, &Gate::OnGate,
+                z3y::ConnectionType::kQueued);
+            bus->SubscribeGlobal<FillEvent>(gate, &Gate::OnFill,
+                z3y::ConnectionType::kQueued);
+        }
+
+        bool BlockWorker() {
+            bus->FireGlobal<GateEvent>();
+            return WaitFor([this] { return gate->entered.load(); });
+        }
+
+        bool Consistent() const {
+            return !global->bad && !from_sender->bad;
+        }
+    };
+
+    bool CheckBlockedWorker() {
+        z3y::PluginManagerOptions options;
+        options.event_worker_count = 1;
+        Fixture f(options);
+        constexpr int kFires = 1000;
+
+        bool ok = f.BlockWorker();
+        for (int i = 0; i < kFires; ++i) {
+            f.bus->FireGlobal<StateEvent>(i);
+            f.bus->FireToSender<StateEvent>(f.sender, i);
+        }
+        const z3y::EventQueueStats blocked = f.manager->GetEventQueueStats();
+        f.gate->open = true;
+        ok = ok && WaitFor([&] {
+            return f.global->last == kFires - 1 &&
+                f.from_sender->last == kFires - 1;
+            });
+        std::printf("behind blocked worker: depth=%zu coalesced=%llu "
+            "delivered global=%d sender=%d\n", blocked.depth,
+            static_cast<unsigned long long>(blocked.coalesced),
+            f.global->count.load(), f.from_sender->count.load());
+        ok = ok && blocked.depth <= 2 &&
+            blocked.coalesced == static_cast<uint64_t>(2 * (kFires - 1)) &&
+            f.global->count == 1 && f.from_sender->count == 1;
+
+        // 批次只投递最后一个事件；异步句柄在投递后完成
+        std::vector<StateEvent> batch;
+        for (int i = kFires; i < kFires + 10; ++i) {
+            batch.emplace_back(i);
+        }
+        f.bus->FireGlobalBatch<StateEvent>(std::move(batch));
+        ok = ok && WaitFor([&] { return f.global->last == kFires + 9; });
+        ok = ok && f.global->count == 2;
+        auto completion = f.bus->FireGlobalAsync<StateEvent>(2 * kFires);
+        ok = ok && completion->WaitFor(kTimeout) && f.global->last == 2 * kFires;
+        return ok && f.Consistent();
+    }
+
+    bool CheckParallel() {
+        z3y::PluginManagerOptions options;
+        options.event_worker_count = 4;
+        Fixture f(options);
+        constexpr int kFires = 200000;
+
+        for (int i = 0; i < kFires; ++i) {
+            f.bus->FireGlobal<StateEvent>(i);
+        }
+        const bool ok = WaitFor([&] { return f.global->last == kFires - 1; });
+        std::printf("4 workers: %d fires, delivered %d, coalesced %llu\n",
+            kFires, f.global->count.load(), static_cast<unsigned long long>(
+                f.manager->GetEventQueueStats().coalesced));
+        return ok && f.Consistent();
+    }
+
+    bool CheckDropped() {
+        z3y::PluginManagerOptions options;
+        options.event_worker_count = 1;
+        options.event_queue_capacity = 2;
+        options.event_queue_overflow_policy = z3y::QueueOverflowPolicy::kDropNewest;
+        Fixture f(options);
+
+        bool ok = f.BlockWorker();
+        f.bus->FireGlobal<FillEvent>();
+        f.bus->FireGlobal<FillEvent>();
+        f.bus->FireGlobal<StateEvent>(1);  // 队列已满，合并任务被丢弃
+        auto completion = f.bus->FireGlobalAsync<StateEvent>(2);
+        const uint64_t dropped = f.manager->GetEventQueueStats().dropped_newest;
+        f.gate->open = true;
+        ok = ok && completion->WaitFor(kTimeout);
+        ok = ok && WaitFor([&] {
+            return f.manager->GetEventQueueStats().depth == 0;
+            });
+        const int delivered_while_full = f.global->count.load();
+
+        f.bus->FireGlobal<StateEvent>(3);
+        ok = ok && WaitFor([&] { return f.global->last == 3; });
+        std::printf("dropped=%llu delivered while full=%d after=%d\n",
+            static_cast<unsigned long long>(dropped), delivered_while_full,
+            f.global->count.load());
+        return ok && dropped > 0 && delivered_while_full == 0 &&
+            f.global->count == 1 && f.Consistent();
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string test_case = argc > 1 ? argv[1] : "";
+    bool ok = false;
+    if (test_case == "blocked_worker") {
+        ok = CheckBlockedWorker();
+    }
+    else if (test_case == "parallel") {
+        ok = CheckParallel();
+    }
+    else if (test_case == "dropped") {
+        ok = CheckDropped();
+    }
+    else {
+        std::printf("usage: event_coalesce_test blocked_worker|parallel|dropped\n");
+        return 2;
+    }
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
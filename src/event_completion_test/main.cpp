@@ -0,0 +1,141 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 异步发布完成句柄 (FireGlobalAsync / EventCompletion) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * kQueued、kQueuedOrdered 与 kDirect 订阅混合在同一事件上：
+ * - 句柄在所有异步回调执行完毕后完成，异步回调的异常汇总到句柄中；
+ * - kDirect 回调抛出时，异常在其余订阅全部入队之后抛给发布者：
+ * 排在它之前和之后的异步订阅都收到事件，之后的 kDirect 订阅不再调用；
+ * - 没有订阅者时句柄立即完成。
+ *
+ * 用法：event_completion_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+    constexpr int kThrowValue = 7;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class CompletionEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(CompletionEvent, "z3y-completion-test-event")
+        explicit CompletionEvent(int value) : value(value) {}
+        int value;
+    };
+
+    class UnobservedEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(UnobservedEvent, "z3y-completion-test-unobserved")
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct Receiver : std::enable_shared_from_this<Receiver> {
+        bool throws = false;
+        std::atomic<int> count{ 0 };
+
+        void OnEvent(const CompletionEvent& e) {
+            ++count;
+            if (throws && e.value == kThrowValue) {
+                throw std::runtime_error("receiver failed");
+            }
+        }
+    };
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 2;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+
+    bool ok = bus->FireGlobalAsync<UnobservedEvent>()->IsReady();
+
+    // 订阅顺序：异步、抛出的 kDirect、kDirect、异步、有序
+    auto queued_before = std::make_shared<Receiver>();
+    auto throwing = std::make_shared<Receiver>();
+    auto direct_after = std::make_shared<Receiver>();
+    auto queued_after = std::make_shared<Receiver>();
+    auto ordered = std::make_shared<Receiver>();
+    throwing->throws = true;
+    ordered->throws = true;
+    bus->SubscribeGlobal<CompletionEvent>(queued_before, &Receiver::OnEvent,
+        z3y::ConnectionType::kQueued);
+    bus->SubscribeGlobal<CompletionEvent>(throwing, &Receiver::OnEvent);
+    bus->SubscribeGlobal<CompletionEvent>(direct_after, &Receiver::OnEvent);
+    bus->SubscribeGlobal<CompletionEvent>(queued_after, &Receiver::OnEvent,
+        z3y::ConnectionType::kQueued);
+    bus->SubscribeGlobal<CompletionEvent>(ordered, &Receiver::OnEvent,
+        z3y::ConnectionType::kQueuedOrdered);
+
+    // 1. 正常发布：句柄覆盖两个 kQueued 与一个 kQueuedOrdered 回调
+    auto completion = bus->FireGlobalAsync<CompletionEvent>(1);
+    ok = ok && completion->WaitFor(kTimeout) && completion->Exceptions().empty();
+    ok = ok && queued_before->count == 1 && queued_after->count == 1 &&
+        ordered->count == 1 && direct_after->count == 1;
+    std::printf("normal: ready=%d queued=%d/%d ordered=%d\n",
+        completion->IsReady() ? 1 : 0, queued_before->count.load(),
+        queued_after->count.load(), ordered->count.load());
+
+    // 2. kDirect 抛出：其余订阅仍然入队，异常随后抛给发布者
+    for (int round = 0; round < 2; ++round) {
+        bool threw = false;
+        try {
+            if (round == 0) {
+                bus->FireGlobal<CompletionEvent>(kThrowValue);
+            }
+            else {
+                bus->FireGlobalAsync<CompletionEvent>(kThrowValue);
+            }
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        const int expected = round + 2;
+        const bool delivered = WaitFor([&] {
+            return queued_before->count == expected &&
+                queued_after->count == expected && ordered->count == expected;
+            });
+        std::printf("direct throw (%s): threw=%d queued=%d/%d ordered=%d "
+            "direct_after=%d\n", round == 0 ? "FireGlobal" : "FireGlobalAsync",
+            threw ? 1 : 0, queued_before->count.load(),
+            queued_after->count.load(), ordered->count.load(),
+            direct_after->count.load());
+        ok = ok && threw && delivered && direct_after->count == 1;
+    }
+
+    // 3. 异步回调的异常汇总到句柄 (kDirect 不抛出时)
+    throwing->throws = false;
+    completion = bus->FireGlobalAsync<CompletionEvent>(kThrowValue);
+    ok = ok && completion->WaitFor(kTimeout) &&
+        completion->Exceptions().size() == 1;
+    std::printf("async exceptions collected: %zu\n",
+        completion->Exceptions().size());
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 连接句柄 (EventConnection) 断开后定向回收的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 一个工作线程。闸门回调占住工作线程期间，同一事件 (全局与某个发送者)
+ * 上的多条订阅先后断开，它们的键在同一个 GC 时间片中重复出现：
+ * - 每条断开的订阅只被回收一次 (subscriptions_reclaimed 精确相等)；
+ * - 同一键上仍然连接的订阅继续收到事件 (发布过滤器的计数没有被重复扣减)；
+ * - 断开的订阅不再收到事件，持有的捕获随回收释放。
+ *
+ * 用法：event_connection_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr int kDisconnected = 8;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class ReclaimEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(ReclaimEvent, "z3y-connection-test-reclaim")
+    };
+
+    class GateEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(GateEvent, "z3y-connection-test-gate")
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct Gate : std::enable_shared_from_this<Gate> {
+        std::atomic<bool> entered{ false };
+        std::atomic<bool> open{ false };
+
+        void OnGate(const GateEvent&) {
+            entered = true;
+            while (!open.load()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    };
+
+    bool GcIdle(z3y::PluginManager& manager) {
+        const z3y::EventGcStats stats = manager.GetEventGcStats();
+        return !stats.sweep_requested && stats.pending_sweep_keys == 0 &&
+            stats.pending_lookup_entries == 0;
+    }
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 1;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+    auto gate = std::make_shared<Gate>();
+    auto sender = std::make_shared<int>(0);
+    bus->SubscribeGlobal<GateEvent>(gate, &Gate::OnGate,
+        z3y::ConnectionType::kQueued);
+
+    // 同一全局键与同一发送者键上：一条保持连接，kDisconnected 条稍后断开
+    std::atomic<int> live_global{ 0 };
+    std::atomic<int> live_sender{ 0 };
+    std::atomic<int> late{ 0 };
+    auto token = std::make_shared<int>(0);
+    z3y::ScopedEventConnection keep_global = bus->SubscribeGlobal<ReclaimEvent>(
+        [&live_global](const ReclaimEvent&) { ++live_global; });
+    z3y::ScopedEventConnection keep_sender = bus->SubscribeToSender<ReclaimEvent>(
+        sender, [&live_sender](const ReclaimEvent&) { ++live_sender; });
+    std::vector<z3y::EventConnection> doomed;
+    for (int i = 0; i < kDisconnected; ++i) {
+        doomed.push_back(bus->SubscribeGlobal<ReclaimEvent>(
+            [&late, token](const ReclaimEvent&) { ++late; }).Release());
+        doomed.push_back(bus->SubscribeToSender<ReclaimEvent>(
+            sender, [&late, token](const ReclaimEvent&) { ++late; }).Release());
+    }
+
+    bool ok = WaitFor([&] { return GcIdle(*manager); });
+    const uint64_t reclaimed_before =
+        manager->GetEventGcStats().subscriptions_reclaimed;
+
+    // 占住唯一的工作线程，使所有断开在同一个 GC 时间片中处理
+    bus->FireGlobal<GateEvent>();
+    ok = ok && WaitFor([&] { return gate->entered.load(); });
+    for (z3y::EventConnection& connection : doomed) {
+        connection.Disconnect();
+    }
+    gate->open = true;
+    ok = ok && WaitFor([&] {
+        return GcIdle(*manager) && token.use_count() == 1;
+        });
+
+    const uint64_t reclaimed =
+        manager->GetEventGcStats().subscriptions_reclaimed - reclaimed_before;
+    bus->FireGlobal<ReclaimEvent>();
+    bus->FireToSender<ReclaimEvent>(sender);
+
+    std::printf("reclaimed=%llu (expected %d) live_global=%d live_sender=%d "
+        "late=%d\n", static_cast<unsigned long long>(reclaimed),
+        2 * kDisconnected, live_global.load(), live_sender.load(), late.load());
+    ok = ok && reclaimed == static_cast<uint64_t>(2 * kDisconnected) &&
+        live_global == 1 && live_sender == 1 && late == 0;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 慢订阅者降级 (slow_callback_demote_after) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 四个工作线程，回调预算 1 ms，超出一次即降级。kQueuedOrdered 订阅者
+ * 的前几个回调很慢，它在 strand 上还有积压任务时被降级到隔离通道，
+ * 之后的事件在旧 strand 排空之前发布：
+ * - 降级前后的回调仍然严格按发布顺序执行、从不并发
+ * (隔离 strand 排在旧 strand 之后启动)；
+ * - 订阅者最终被标记为已降级，所有事件都被投递。
+ * 重复多轮，每轮一个新的订阅者。
+ *
+ * 用法：event_demote_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace {
+
+    constexpr int kRounds = 20;
+    constexpr int kFires = 2000;
+    constexpr int kSlowFires = 40;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class OrderedEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(OrderedEvent, "z3y-demote-test-ordered")
+        explicit OrderedEvent(int value) : value(value) {}
+        int value;
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct SlowReceiver : std::enable_shared_from_this<SlowReceiver> {
+        std::atomic<int> inside{ 0 };
+        std::atomic<int> overlapped{ 0 };
+        std::atomic<int> out_of_order{ 0 };
+        std::atomic<int> count{ 0 };
+        int last = -1;
+
+        void OnEvent(const OrderedEvent& e) {
+            if (inside.fetch_add(1) != 0) {
+                ++overlapped;
+            }
+            if (e.value != last + 1) {
+                ++out_of_order;
+            }
+            last = e.value;
+            if (e.value < kSlowFires) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            --inside;
+            ++count;
+        }
+    };
+
+    bool IsDemoted(z3y::IEventStats& stats, const std::shared_ptr<void>& subscriber) {
+        const std::weak_ptr<void> weak = subscriber;
+        for (const auto& record : stats.GetSlowSubscribers()) {
+            const bool same = !record.subscriber.owner_before(weak) &&
+                !weak.owner_before(record.subscriber);
+            if (same && record.demoted) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 4;
+    options.slow_callback_budget = std::chrono::milliseconds(1);
+    options.slow_callback_demote_after = 1;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+    auto stats = manager->GetService<z3y::IEventStats>(z3y::clsid::kEventStats);
+
+    bool ok = true;
+    for (int round = 0; round < kRounds && ok; ++round) {
+        auto receiver = std::make_shared<SlowReceiver>();
+        bus->SubscribeGlobal<OrderedEvent>(receiver, &SlowReceiver::OnEvent,
+            z3y::ConnectionType::kQueuedOrdered);
+        // 慢回调积压在旧 strand 上；第一个回调超时后订阅者被降级，
+        // 其余事件在旧 strand 尚未排空时投递到隔离 strand
+        for (int i = 0; i < kSlowFires; ++i) {
+            bus->FireGlobal<OrderedEvent>(i);
+        }
+        const bool demoted = WaitFor([&] { return IsDemoted(*stats, receiver); });
+        for (int i = kSlowFires; i < kFires; ++i) {
+            bus->FireGlobal<OrderedEvent>(i);
+        }
+        const bool delivered = WaitFor([&] { return receiver->count == kFires; });
+        if (!delivered || !demoted || receiver->out_of_order != 0 ||
+            receiver->overlapped != 0) {
+            std::printf("round %d: delivered=%d/%d demoted=%d out_of_order=%d "
+                "overlapped=%d\n", round, receiver->count.load(), kFires,
+                demoted ? 1 : 0, receiver->out_of_order.load(),
+                receiver->overlapped.load());
+            ok = false;
+        }
+        bus->Unsubscribe(receiver);
+    }
+    std::printf("%d rounds of demotion with a backlog\n", kRounds);
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
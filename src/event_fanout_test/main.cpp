@@ -0,0 +1,123 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 并行扇出 (event_fan_out_chunk_size) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 四个工作线程，块大小 16。kQueued 订阅者中一半已析构 (尚未被回收)：
+ * - 有效的 64 个订阅恰好拆成 4 个任务 (失效订阅不计入块的大小)；
+ * - 4 个任务分布在 4 个工作线程上同时执行 (每个回调等到 4 个线程都进入)；
+ * - 共享任务进入事件类型的优先级通道，完成句柄覆盖所有块。
+ *
+ * 用法：event_fanout_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr size_t kWorkers = 4;
+    constexpr size_t kChunk = 16;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class SpreadEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(SpreadEvent, "z3y-fanout-test-spread")
+        Z3Y_DEFINE_EVENT_PRIORITY(kHigh)
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 记录执行回调的工作线程；回调等到 kWorkers 个线程都进入后才返回。
+     */
+    struct Spread {
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+        std::atomic<size_t> thread_count{ 0 };
+        std::atomic<int> delivered{ 0 };
+
+        void Enter() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+                thread_count = threads.size();
+            }
+            WaitFor([this] { return thread_count.load() >= kWorkers; });
+            ++delivered;
+        }
+    };
+
+    struct Receiver : std::enable_shared_from_this<Receiver> {
+        Spread* spread = nullptr;
+        void OnEvent(const SpreadEvent&) { spread->Enter(); }
+    };
+
+    uint64_t Executed(const z3y::EventQueueStats& stats, z3y::EventPriority lane) {
+        return stats.lane_executed[static_cast<size_t>(lane)];
+    }
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = kWorkers;
+    options.event_fan_out_chunk_size = kChunk;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+
+    Spread spread;
+    std::vector<std::shared_ptr<Receiver>> receivers;
+    for (size_t i = 0; i < 2 * kWorkers * kChunk; ++i) {
+        auto receiver = std::make_shared<Receiver>();
+        receiver->spread = &spread;
+        bus->SubscribeGlobal<SpreadEvent>(receiver, &Receiver::OnEvent,
+            z3y::ConnectionType::kQueued);
+        receivers.push_back(std::move(receiver));
+    }
+    // 隔一个析构一个：失效订阅留在快照中，直到本次发布请求清扫
+    for (size_t i = 0; i < receivers.size(); i += 2) {
+        receivers[i].reset();
+    }
+    const int live = static_cast<int>(kWorkers * kChunk);
+
+    const z3y::EventQueueStats before = manager->GetEventQueueStats();
+    auto completion = bus->FireGlobalAsync<SpreadEvent>();
+    bool ok = completion->WaitFor(kTimeout);
+    const z3y::EventQueueStats after = manager->GetEventQueueStats();
+
+    const uint64_t high_tasks = Executed(after, z3y::EventPriority::kHigh) -
+        Executed(before, z3y::EventPriority::kHigh);
+    const uint64_t normal_tasks = Executed(after, z3y::EventPriority::kNormal) -
+        Executed(before, z3y::EventPriority::kNormal);
+    std::printf("delivered=%d/%d threads=%zu tasks: high=%llu normal=%llu\n",
+        spread.delivered.load(), live, spread.thread_count.load(),
+        static_cast<unsigned long long>(high_tasks),
+        static_cast<unsigned long long>(normal_tasks));
+    ok = ok && spread.delivered == live && spread.thread_count == kWorkers &&
+        high_tasks == kWorkers && normal_tasks == 0;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 带过滤器的订阅 (在发布者线程上、入队之前求值) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 两个工作线程，kDirect、kQueued、kQueuedOrdered 与 kQueuedCoalesced
+ * 订阅各带一个过滤器：
+ * - 每个订阅只收到满足过滤器的事件；
+ * - 被拒绝的事件不产生异步任务 (工作线程执行的任务数只与通过的事件有关)；
+ * - 同一事件上不带过滤器的 kQueued 订阅不受影响；
+ * - 批次只投递通过过滤的子批次；FireGlobalAsync 的句柄在通过的回调
+ * 执行后完成；保留事件重放、发送者订阅与捕获状态的过滤器同样生效。
+ *
+ * 用法：event_filter_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr int kFires = 1000;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class SampleEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(SampleEvent, "z3y-filter-test-sample")
+        explicit SampleEvent(int value) : value(value) {}
+        int value;
+    };
+
+    class StatusEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(StatusEvent, "z3y-filter-test-status")
+        Z3Y_DEFINE_EVENT_RETAINED()
+        explicit StatusEvent(int value) : value(value) {}
+        int value;
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct Receiver : std::enable_shared_from_this<Receiver> {
+        std::atomic<int> count{ 0 };
+        std::atomic<int> sum{ 0 };
+        void OnSample(const SampleEvent& e) { ++count; sum += e.value; }
+        void OnStatus(const StatusEvent& e) { ++count; sum += e.value; }
+    };
+
+    uint64_t ExecutedTasks(const z3y::PluginManager& manager) {
+        const z3y::EventQueueStats stats = manager.GetEventQueueStats();
+        return std::accumulate(stats.lane_executed.begin(),
+            stats.lane_executed.end(), uint64_t{ 0 });
+    }
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 2;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+
+    auto even = [](const SampleEvent& e) { return e.value % 2 == 0; };
+    auto rare = [](const SampleEvent& e) { return e.value % 100 == 0; };
+    auto direct = std::make_shared<Receiver>();
+    auto queued = std::make_shared<Receiver>();
+    auto ordered = std::make_shared<Receiver>();
+    auto coalesced = std::make_shared<Receiver>();
+    bus->SubscribeGlobal<SampleEvent>(direct, &Receiver::OnSample, even);
+    bus->SubscribeGlobal<SampleEvent>(queued, &Receiver::OnSample, rare,
+        z3y::ConnectionType::kQueued);
+    bus->SubscribeGlobal<SampleEvent>(ordered, &Receiver::OnSample, rare,
+        z3y::ConnectionType::kQueuedOrdered);
+    bus->SubscribeGlobal<SampleEvent>(coalesced, &Receiver::OnSample,
+        [](const SampleEvent& e) { return e.value < 0; },
+        z3y::ConnectionType::kQueuedCoalesced);
+
+    // 1. 被拒绝的事件不入队
+    const uint64_t before = ExecutedTasks(*manager);
+    for (int i = 0; i < kFires; ++i) {
+        bus->FireGlobal<SampleEvent>(i);
+    }
+    bool ok = WaitFor([&] {
+        return queued->count == kFires / 100 && ordered->count == kFires / 100;
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const uint64_t tasks = ExecutedTasks(*manager) - before;
+    std::printf("direct=%d queued=%d ordered=%d coalesced=%d tasks=%llu\n",
+        direct->count.load(), queued->count.load(), ordered->count.load(),
+        coalesced->count.load(), static_cast<unsigned long long>(tasks));
+    ok = ok && direct->count == kFires / 2 && coalesced->count == 0 &&
+        tasks <= static_cast<uint64_t>(2 * (kFires / 100));
+
+    // 2. 不带过滤器的 kQueued 订阅照常收到所有事件
+    auto unfiltered = std::make_shared<Receiver>();
+    bus->SubscribeGlobal<SampleEvent>(unfiltered, &Receiver::OnSample,
+        z3y::ConnectionType::kQueued);
+    for (int i = 0; i < 100; ++i) {
+        bus->FireGlobal<SampleEvent>(i);
+    }
+    ok = ok && WaitFor([&] {
+        return unfiltered->count == 100 && queued->count == kFires / 100 + 1;
+        });
+
+    // 3. 批次：kDirect 只收到通过的子批次
+    std::vector<SampleEvent> batch;
+    for (int i = 0; i < 10; ++i) {
+        batch.emplace_back(i);
+    }
+    const int direct_count = direct->count;
+    const int direct_sum = direct->sum;
+    bus->FireGlobalBatch<SampleEvent>(std::move(batch));
+    ok = ok && direct->count == direct_count + 5 &&
+        direct->sum == direct_sum + (0 + 2 + 4 + 6 + 8);
+    ok = ok && WaitFor([&] { return queued->count == kFires / 100 + 2; });
+
+    // 4. 完成句柄
+    const int queued_count = queued->count;
+    auto completion = bus->FireGlobalAsync<SampleEvent>(200);
+    ok = ok && completion->WaitFor(kTimeout) &&
+        queued->count == queued_count + 1;
+
+    // 5. 发送者订阅与保留事件重放
+    auto sender = std::make_shared<int>(0);
+    auto from_sender = std::make_shared<Receiver>();
+    bus->SubscribeToSender<SampleEvent>(sender, from_sender,
+        &Receiver::OnSample, even);
+    bus->FireToSender<SampleEvent>(sender, 1);
+    bus->FireToSender<SampleEvent>(sender, 2);
+    ok = ok && from_sender->count == 1 && from_sender->sum == 2;
+
+    bus->FireGlobal<StatusEvent>(7);
+    auto rejects_replay = std::make_shared<Receiver>();
+    auto accepts_replay = std::make_shared<Receiver>();
+    bus->SubscribeGlobal<StatusEvent>(rejects_replay, &Receiver::OnStatus,
+        [](const StatusEvent& e) { return e.value > 10; });
+    bus->SubscribeGlobal<StatusEvent>(accepts_replay, &Receiver::OnStatus,
+        [](const StatusEvent& e) { return e.value < 10; });
+    ok = ok && rejects_replay->count == 0 && accepts_replay->count == 1;
+
+    // 6. lambda 回调与捕获状态的过滤器
+    const int threshold = 5;
+    std::atomic<int> seen{ 0 };
+    auto holder = std::make_shared<Receiver>();
+    bus->SubscribeGlobal<SampleEvent>(holder,
+        [&seen](const SampleEvent&) { ++seen; },
+        [threshold](const SampleEvent& e) { return e.value > threshold; });
+    for (int i = 0; i < 10; ++i) {
+        bus->FireGlobal<SampleEvent>(i);
+    }
+    ok = ok && seen == 4;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
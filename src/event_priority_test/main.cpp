@@ -0,0 +1,180 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 异步投递优先级通道 (EventPriority) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 一个工作线程，默认权重 (kLow 1 / kNormal 4 / kHigh 16)。闸门回调占住
+ * 工作线程时，三个通道各积压一批任务，闸门打开后记录执行顺序：
+ * - 每个通道内部按入队顺序 (FIFO) 执行；
+ * - kHigh 通道优先：它清空之前 kLow 只被服务约 (kHigh 任务数 / 16) 次；
+ * - kLow 不会饿死：只要它非空，相邻两次服务之间隔不到 (权重之和) 个任务。
+ *
+ * 用法：event_priority_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    constexpr int kLowCount = 1000;
+    constexpr int kNormalCount = 400;
+    constexpr int kHighCount = 400;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class GateEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(GateEvent, "z3y-priority-test-gate")
+    };
+
+    class LowEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(LowEvent, "z3y-priority-test-low")
+        Z3Y_DEFINE_EVENT_PRIORITY(kLow)
+        explicit LowEvent(int index) : index(index) {}
+        int index;
+    };
+
+    class NormalEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(NormalEvent, "z3y-priority-test-normal")
+        Z3Y_DEFINE_EVENT_PRIORITY(kNormal)
+        explicit NormalEvent(int index) : index(index) {}
+        int index;
+    };
+
+    class HighEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(HighEvent, "z3y-priority-test-high")
+        Z3Y_DEFINE_EVENT_PRIORITY(kHigh)
+        explicit HighEvent(int index) : index(index) {}
+        int index;
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct Recorder : std::enable_shared_from_this<Recorder> {
+        std::atomic<bool> gate_open{ false };
+        std::mutex mutex;
+        std::vector<std::pair<z3y::EventPriority, int>> order;
+
+        void OnGate(const GateEvent&) {
+            while (!gate_open.load()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+
+        template <typename TEvent>
+        void OnLane(const TEvent& e) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.emplace_back(TEvent::kPriority, e.index);
+        }
+
+        size_t Size() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return order.size();
+        }
+    };
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions options;
+    options.event_worker_count = 1;
+    auto manager = z3y::PluginManager::Create(options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+    auto recorder = std::make_shared<Recorder>();
+    const auto& weights = options.event_lane_weights;
+    const size_t cycle = weights[0] + weights[1] + weights[2];
+
+    bus->SubscribeGlobal<GateEvent>(recorder, &Recorder::OnGate,
+        z3y::ConnectionType::kQueued);
+    bus->SubscribeGlobal<LowEvent>(recorder, &Recorder::OnLane<LowEvent>,
+        z3y::ConnectionType::kQueued);
+    bus->SubscribeGlobal<NormalEvent>(recorder, &Recorder::OnLane<NormalEvent>,
+        z3y::ConnectionType::kQueued);
+    bus->SubscribeGlobal<HighEvent>(recorder, &Recorder::OnLane<HighEvent>,
+        z3y::ConnectionType::kQueued);
+
+    bus->FireGlobal<GateEvent>();
+    bool ok = WaitFor([&] {
+        return manager->GetEventQueueStats().depth == 0;
+        });
+    for (int i = 0; i < kLowCount; ++i) {
+        bus->FireGlobal<LowEvent>(i);
+    }
+    for (int i = 0; i < kNormalCount; ++i) {
+        bus->FireGlobal<NormalEvent>(i);
+    }
+    for (int i = 0; i < kHighCount; ++i) {
+        bus->FireGlobal<HighEvent>(i);
+    }
+    recorder->gate_open = true;
+    const size_t total = kLowCount + kNormalCount + kHighCount;
+    ok = ok && WaitFor([&] { return recorder->Size() == total; });
+
+    // 1. 通道内 FIFO
+    int next[z3y::kEventPriorityCount] = { 0, 0, 0 };
+    bool fifo = true;
+    for (const auto& entry : recorder->order) {
+        fifo = fifo && entry.second == next[static_cast<size_t>(entry.first)]++;
+    }
+
+    // 2. kHigh 清空之前服务的 kLow 任务数
+    // 3. kLow 非空期间相邻两次服务之间的最大间隔
+    size_t last_high = 0;
+    for (size_t i = 0; i < recorder->order.size(); ++i) {
+        if (recorder->order[i].first == z3y::EventPriority::kHigh) {
+            last_high = i;
+        }
+    }
+    int low_before_high_done = 0;
+    size_t max_low_gap = 0;
+    size_t since_low = 0;
+    for (size_t i = 0; i < recorder->order.size(); ++i) {
+        if (recorder->order[i].first != z3y::EventPriority::kLow) {
+            ++since_low;
+            continue;
+        }
+        max_low_gap = (std::max)(max_low_gap, since_low);
+        since_low = 0;
+        if (i < last_high) {
+            ++low_before_high_done;
+        }
+    }
+
+    const int high_cycles =
+        static_cast<int>((kHighCount + weights[2] - 1) / weights[2]);
+    std::printf("fifo=%d low served before high drained=%d (cycles %d) "
+        "max low gap=%zu (cycle %zu)\n", fifo ? 1 : 0, low_before_high_done,
+        high_cycles, max_low_gap, cycle);
+    ok = ok && fifo &&
+        low_before_high_done >= high_cycles - 1 &&
+        low_before_high_done <= high_cycles + 1 &&
+        max_low_gap < cycle;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
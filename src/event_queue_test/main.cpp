@@ -0,0 +1,192 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 有界异步事件队列 (QueueOverflowPolicy) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 两个工作线程，队列容量 16。kQueued 订阅者 Burst 在工作线程上连续发布
+ * kBurst 个事件，接收它们的 Sink 在闸门打开前阻塞两个工作线程：
+ * - 工作线程上的发布进入本地队列，本地任务合计达到容量后按策略处理
+ * (kDropNewest / kBlock 丢弃新任务，kReject 抛出异常)，不会无限增长；
+ * - 外部线程的 kDropOldest 丢弃最旧的任务；
+ * - 每个事件要么被投递、要么计入丢弃/拒绝计数。
+ *
+ * 用法：event_queue_test <用例> (退出码 0 表示通过；一个进程只能有一个
+ * PluginManager，因此每次运行一个用例，ctest 逐个运行)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+    constexpr size_t kCapacity = 16;
+    constexpr int kBurst = 10000;
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class BurstEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(BurstEvent, "z3y-queue-test-burst")
+    };
+
+    class SinkEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(SinkEvent, "z3y-queue-test-sink")
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct Sink : std::enable_shared_from_this<Sink> {
+        std::atomic<bool> gate_open{ false };
+        std::atomic<int> entered{ 0 };
+        std::atomic<int> delivered{ 0 };
+
+        void OnSink(const SinkEvent&) {
+            ++entered;
+            while (!gate_open.load()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            ++delivered;
+        }
+    };
+
+    struct Burst : std::enable_shared_from_this<Burst> {
+        z3y::IEventBus* bus = nullptr;
+        std::atomic<bool> done{ false };
+        std::atomic<int> rejected{ 0 };
+
+        void OnBurst(const BurstEvent&) {
+            for (int i = 0; i < kBurst; ++i) {
+                try {
+                    bus->FireGlobal<SinkEvent>();
+                }
+                catch (const z3y::PluginException& e) {
+                    if (e.GetError() == z3y::InstanceError::kErrorEventQueueFull) {
+                        ++rejected;
+                    }
+                }
+            }
+            done = true;
+        }
+    };
+
+    z3y::PluginManagerOptions MakeOptions(z3y::QueueOverflowPolicy policy) {
+        z3y::PluginManagerOptions options;
+        options.event_worker_count = 2;
+        options.event_queue_capacity = kCapacity;
+        options.event_queue_overflow_policy = policy;
+        options.slow_callback_budget = std::chrono::microseconds(0);
+        return options;
+    }
+
+    /**
+     * @brief 工作线程上的突发发布：本地任务受容量约束，其余按策略计数。
+     */
+    bool CheckWorkerBurst(z3y::QueueOverflowPolicy policy, const char* name) {
+        auto manager = z3y::PluginManager::Create(MakeOptions(policy));
+        auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+        auto sink = std::make_shared<Sink>();
+        auto burst = std::make_shared<Burst>();
+        burst->bus = bus.get();
+        bus->SubscribeGlobal<SinkEvent>(sink, &Sink::OnSink,
+            z3y::ConnectionType::kQueued);
+        bus->SubscribeGlobal<BurstEvent>(burst, &Burst::OnBurst,
+            z3y::ConnectionType::kQueued);
+
+        bus->FireGlobal<BurstEvent>();
+        bool ok = WaitFor([&] { return burst->done.load(); });
+        const z3y::EventQueueStats full = manager->GetEventQueueStats();
+        const uint64_t refused = full.dropped_newest + full.rejected;
+
+        sink->gate_open = true;
+        ok = ok && WaitFor([&] {
+            return sink->delivered.load() + refused == static_cast<uint64_t>(kBurst);
+            });
+        const bool bounded = full.depth <= 2 * kCapacity;
+        const bool counted = policy == z3y::QueueOverflowPolicy::kReject
+            ? full.rejected == static_cast<uint64_t>(burst->rejected.load()) &&
+            full.rejected > 0
+            : full.dropped_newest > 0;
+        std::printf("%-12s depth=%zu dropped_newest=%llu rejected=%llu "
+            "delivered=%d\n", name, full.depth,
+            static_cast<unsigned long long>(full.dropped_newest),
+            static_cast<unsigned long long>(full.rejected),
+            sink->delivered.load());
+        return ok && bounded && counted;
+    }
+
+    /**
+     * @brief 外部线程的 kDropOldest：丢弃最旧的任务，队列深度不超过容量。
+     */
+    bool CheckExternalDropOldest() {
+        auto manager = z3y::PluginManager::Create(
+            MakeOptions(z3y::QueueOverflowPolicy::kDropOldest));
+        auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+        auto sink = std::make_shared<Sink>();
+        bus->SubscribeGlobal<SinkEvent>(sink, &Sink::OnSink,
+            z3y::ConnectionType::kQueued);
+
+        constexpr int kCount = 1000;
+        bus->FireGlobal<SinkEvent>();
+        bus->FireGlobal<SinkEvent>();
+        bool ok = WaitFor([&] { return sink->entered.load() == 2; });
+        for (int i = 2; i < kCount; ++i) {
+            bus->FireGlobal<SinkEvent>();
+        }
+        const z3y::EventQueueStats full = manager->GetEventQueueStats();
+        sink->gate_open = true;
+        ok = ok && WaitFor([&] {
+            return sink->delivered.load() + full.dropped_oldest ==
+                static_cast<uint64_t>(kCount);
+            });
+        std::printf("%-12s depth=%zu dropped_oldest=%llu delivered=%d\n",
+            "kDropOldest", full.depth,
+            static_cast<unsigned long long>(full.dropped_oldest),
+            sink->delivered.load());
+        return ok && full.depth <= kCapacity &&
+            full.dropped_oldest == static_cast<uint64_t>(kCount - 2) - kCapacity;
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string test_case = argc > 1 ? argv[1] : "";
+    bool ok = false;
+    if (test_case == "worker_drop_newest") {
+        ok = CheckWorkerBurst(z3y::QueueOverflowPolicy::kDropNewest, "kDropNewest");
+    }
+    else if (test_case == "worker_block") {
+        ok = CheckWorkerBurst(z3y::QueueOverflowPolicy::kBlock, "kBlock");
+    }
+    else if (test_case == "worker_reject") {
+        ok = CheckWorkerBurst(z3y::QueueOverflowPolicy::kReject, "kReject");
+    }
+    else if (test_case == "drop_oldest") {
+        ok = CheckExternalDropOldest();
+    }
+    else {
+        std::printf("usage: event_queue_test "
+            "worker_drop_newest|worker_block|worker_reject|drop_oldest\n");
+        return 2;
+    }
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
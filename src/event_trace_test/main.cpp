@@ -0,0 +1,154 @@
+/**
+ * @file main.cpp
+ * @brief [!! 新增 !!] 事件追踪 (EventTraceBuffer) 的测试。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 一个 kDirect 与一个 kQueued 订阅者，多个工作线程：
+ * - 工作线程上的 kQueuedExecuteStart / kQueuedExecuteEnd 带有所属发布的
+ * EventId 与事件指针，并且能对应到同一发布的 kEventFired / kQueuedEntry；
+ * - 按发布采样：同一次发布的追踪点一起保留或一起丢弃。
+ *
+ * 用法：event_trace_test (退出码 0 表示通过)
+ */
+
+#include "framework/z3y_framework.h"
+#include "z3y_plugin_manager/plugin_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    constexpr auto kTimeout = std::chrono::seconds(20);
+
+    class TracedEvent : public z3y::Event {
+    public:
+        Z3Y_DEFINE_EVENT(TracedEvent, "z3y-trace-test-event")
+        explicit TracedEvent(int value) : value(value) {}
+        int value;
+    };
+
+    bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    struct Counter : std::enable_shared_from_this<Counter> {
+        std::atomic<int> count{ 0 };
+        void OnEvent(const TracedEvent&) { ++count; }
+    };
+
+    /**
+     * @brief 发布 publishes 次并等待异步回调全部执行，返回追踪记录。
+     */
+    std::vector<z3y::EventTraceRecord> Run(z3y::PluginManager& manager,
+        z3y::IEventBus& bus, Counter& queued, uint32_t sample_every,
+        int publishes) {
+        z3y::EventTraceOptions options;
+        options.sample_every = sample_every;
+        options.records_per_thread = 1 << 14;
+        manager.StartEventTrace(options);
+        const int before = queued.count.load();
+        for (int i = 0; i < publishes; ++i) {
+            bus.FireGlobal<TracedEvent>(i);
+        }
+        WaitFor([&] { return queued.count.load() == before + publishes; });
+        // 执行结束记录在回调返回之后写入
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        manager.StopEventTrace();
+        return manager.GetEventTrace();
+    }
+
+    using EventKey = std::pair<z3y::EventId, const void*>;
+    using PointCounts = std::map<z3y::EventTracePoint, int>;
+
+    /**
+     * @brief 把记录按发布分组 (事件对象来自对象池，地址会被之后的发布复用，
+     * 因此同一地址上每条 kEventFired 开始新的一组)；每组的追踪点必须齐全。
+     * @return 被保留的发布数；记录不成组时返回 -1。
+     */
+    int CountCompletePublishes(const std::vector<z3y::EventTraceRecord>& records) {
+        std::vector<PointCounts> publishes;
+        std::map<EventKey, size_t> current;
+        for (const z3y::EventTraceRecord& record : records) {
+            if (record.event_id != TracedEvent::kEventId || !record.event) {
+                std::printf("record without event: point=%d id=%llu\n",
+                    static_cast<int>(record.point),
+                    static_cast<unsigned long long>(record.event_id));
+                return -1;
+            }
+            const EventKey key{ record.event_id, record.event };
+            if (record.point == z3y::EventTracePoint::kEventFired) {
+                current[key] = publishes.size();
+                publishes.emplace_back();
+            }
+            auto it = current.find(key);
+            if (it == current.end()) {
+                std::printf("record before its publish: point=%d\n",
+                    static_cast<int>(record.point));
+                return -1;
+            }
+            ++publishes[it->second][record.point];
+        }
+        for (const PointCounts& points : publishes) {
+            for (z3y::EventTracePoint point : {
+                z3y::EventTracePoint::kEventFired,
+                z3y::EventTracePoint::kDirectCallStart,
+                z3y::EventTracePoint::kDirectCallEnd,
+                z3y::EventTracePoint::kQueuedEntry,
+                z3y::EventTracePoint::kQueuedExecuteStart,
+                z3y::EventTracePoint::kQueuedExecuteEnd }) {
+                auto it = points.find(point);
+                if (it == points.end() || it->second != 1) {
+                    std::printf("incomplete publish: point=%d count=%d\n",
+                        static_cast<int>(point),
+                        it == points.end() ? 0 : it->second);
+                    return -1;
+                }
+            }
+        }
+        return static_cast<int>(publishes.size());
+    }
+
+}  // namespace
+
+int main() {
+    z3y::PluginManagerOptions manager_options;
+    manager_options.event_worker_count = 4;
+    auto manager = z3y::PluginManager::Create(manager_options);
+    auto bus = manager->GetService<z3y::IEventBus>(z3y::clsid::kEventBus);
+    auto direct = std::make_shared<Counter>();
+    auto queued = std::make_shared<Counter>();
+    bus->SubscribeGlobal<TracedEvent>(direct, &Counter::OnEvent);
+    bus->SubscribeGlobal<TracedEvent>(queued, &Counter::OnEvent,
+        z3y::ConnectionType::kQueued);
+
+    bool ok = true;
+    const int all = CountCompletePublishes(
+        Run(*manager, *bus, *queued, 1, 200));
+    std::printf("sample_every=1: %d/200 publishes traced\n", all);
+    ok = ok && all == 200;
+
+    const int sampled = CountCompletePublishes(
+        Run(*manager, *bus, *queued, 4, 400));
+    std::printf("sample_every=4: %d/400 publishes traced\n", sampled);
+    ok = ok && sampled == 100;
+
+    std::printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -43,7 +43,7 @@
 #include <vector>
 #include <iomanip>
 #include <filesystem>
-#include <map> // 用于 EventTracePoint 映射
+#include <fstream> // [!! 修改 !!] 用于导出事件追踪
 
 #ifdef _WIN32
 #include <Windows.h> // 
@@ -54,15 +54,6 @@
 
 namespace {
 
-    // 映射枚举值到可读字符串
-    const std::map<z3y::EventTracePoint, const char*> kTracePointNames = {
-        {z3y::EventTracePoint::kEventFired, "EVENT_FIRED (Published)"},
-        {z3y::EventTracePoint::kDirectCallStart, "DIRECT_CALL (Start)"},
-        {z3y::EventTracePoint::kQueuedEntry, "QUEUED_ENTRY (Enqueued)"},
-        {z3y::EventTracePoint::kQueuedExecuteStart, "QUEUE_EXECUTE (Start)"},
-        {z3y::EventTracePoint::kQueuedExecuteEnd, "QUEUE_EXECUTE (End)"},
-    };
-
     //
     // 
     // 定义一个辅助结构体，
@@ -145,24 +136,9 @@ int main(int argc, char* argv[]) {
         z3y::PluginPtr<z3y::PluginManager> manager = z3y::PluginManager::Create();
 
         // [!! 核心新增 !!] 
-        // 2. 演示设置事件追踪钩子
-        std::cout << "\n[Host] Setting up Event Trace Hook (Multi-Stage Diagnosis)..." << std::endl;
-        // 修正了函数名和 Lambda 签名，使其匹配新的 EventTraceHook
-        manager->SetEventTraceHook(
-            [](z3y::EventTracePoint point, z3y::EventId event_cls_id, void* event_instance_ptr, const char* info) {
-                // 查找追踪点名称
-                const char* point_name = "UNKNOWN";
-                auto it = kTracePointNames.find(point);
-                if (it != kTracePointNames.end()) {
-                    point_name = it->second;
-                }
-
-                std::cout << "[TRACE] [" << point_name << "]"
-                    << " ID: 0x" << std::hex << std::setw(16) << std::setfill('0') << event_cls_id
-                    << " Ptr: 0x" << event_instance_ptr
-                    << std::dec << " Info: " << info
-                    << std::endl;
-            });
+        // 2. [!! 修改 !!] 演示开启事件追踪 (二进制环，结束时导出为 Chrome trace JSON)
+        std::cout << "\n[Host] Starting event trace (Multi-Stage Diagnosis)..." << std::endl;
+        manager->StartEventTrace();
 
 
         // 3. [!! 优化 !!] 
@@ -364,6 +340,15 @@ int main(int argc, char* argv[]) {
         // bus.reset(); // 
         query_service.reset();
 
+        // [!! 新增 !!] 导出追踪记录，可用 chrome://tracing 或 ui.perfetto.dev 打开
+        manager->StopEventTrace();
+        {
+            std::ofstream trace_file("z3y_event_trace.json");
+            manager->ExportEventTrace(trace_file);
+        }
+        std::cout << "[Host] " << manager->GetEventTrace().size()
+            << " trace records written to z3y_event_trace.json" << std::endl;
+
         manager->UnloadAllPlugins();
 
         // 11. [演示] 尝试再次获取服务 (此时应失败)
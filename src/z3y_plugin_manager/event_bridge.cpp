@@ -0,0 +1,372 @@
+/**
+ * @file event_bridge.cpp
+ * @brief [!! 新增 !!] z3y::EventBridge (共享内存事件桥) 的实现。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ */
+
+#include "event_bridge.h"
+#include "plugin_manager.h"
+#include "framework/framework_events.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <utility>
+
+namespace z3y {
+
+    namespace {
+        /**
+         * @brief 读线程正在重新发布时指向该事件桥：
+         * 导出回调据此跳过，避免记录在进程之间来回反弹。
+         */
+        thread_local const void* t_republishing_bridge = nullptr;
+
+        // 读线程空闲时的退避：先自旋，再让步，最后短暂休眠
+        constexpr uint32_t kIdleSpinRounds = 64;
+        constexpr uint32_t kIdleYieldRounds = 256;
+        constexpr auto kIdleSleep = std::chrono::microseconds(200);
+
+        // 每轮最多处理的记录数 (之后重新读取导入表与管理器)
+        constexpr size_t kReadBatch = 256;
+
+        // 槽位超过这么久仍未发布 (而之后的序号已被领取)，视为写者中途退出
+        constexpr auto kStalledSlotTimeout = std::chrono::milliseconds(100);
+
+        size_t RoundUpPowerOfTwo(size_t value) {
+            size_t result = 1;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        uint64_t RandomOrigin() {
+            std::random_device device;
+            const uint64_t high = device();
+            const uint64_t low = device();
+            const uint64_t now = static_cast<uint64_t>(
+                std::chrono::steady_clock::now().time_since_epoch().count());
+            return ((high << 32) | low) ^ (now * 0x9E3779B97F4A7C15ULL);
+        }
+    }  // namespace
+
+    EventBridge::EventBridge()
+        : imports_(std::make_shared<const ImportMap>()),
+        manager_(PluginManager::GetActiveInstance()),
+        origin_(RandomOrigin()) {}
+
+    /**
+     * @brief 析构时关闭通道。
+     * @note 可能在读线程上执行 (读线程释放了本对象的最后一个引用)，
+     * 此时 Close 分离而不是等待读线程。
+     */
+    EventBridge::~EventBridge() {
+        Close();
+    }
+
+    PluginPtr<PluginManager> EventBridge::LockManager() const {
+        PluginPtr<PluginManager> manager = manager_.lock();
+        if (!manager) {
+            throw PluginException(InstanceError::kErrorEventBridge,
+                "Event bridge has no active PluginManager.");
+        }
+        return manager;
+    }
+
+    /**
+     * @brief [IEventBridge 接口实现] 创建或加入通道并启动读线程。
+     */
+    void EventBridge::Open(const EventBridgeOptions& options) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (channel_.Load()) {
+            throw PluginException(InstanceError::kErrorEventBridge,
+                "Event bridge is already open.");
+        }
+        if (options.channel.empty()) {
+            throw PluginException(InstanceError::kErrorEventBridge,
+                "Event bridge channel name is empty.");
+        }
+        PluginPtr<PluginManager> manager = LockManager();
+
+        const size_t slot_count =
+            RoundUpPowerOfTwo(std::max<size_t>(options.slot_count, 2));
+        const size_t slot_size = (std::max(options.slot_size,
+            SharedEventRing::kSlotHeaderSize + 1) +
+            SharedEventRing::kSlotAlignment - 1) /
+            SharedEventRing::kSlotAlignment * SharedEventRing::kSlotAlignment;
+
+        auto channel = std::make_shared<Channel>();
+        channel->name = "bridge." + options.channel;
+        channel->remove_on_close = options.remove_on_close;
+
+        bool created = false;
+        std::string error;
+        channel->region = SharedMemoryRegion::OpenOrCreate(channel->name,
+            SharedEventRing::RequiredSize(slot_count, slot_size), created, error);
+        if (!channel->region) {
+            throw PluginException(InstanceError::kErrorEventBridge,
+                "Cannot open event bridge '" + options.channel + "': " + error);
+        }
+        if (created) {
+            SharedEventRing::Initialize(channel->region->Data(), slot_count,
+                slot_size);
+        }
+        if (!channel->ring.Attach(channel->region->Data(),
+            channel->region->Size(), error)) {
+            throw PluginException(InstanceError::kErrorEventBridge,
+                "Cannot attach to event bridge '" + options.channel + "': " +
+                error);
+        }
+
+        // 已加入的通道可能由使用更小槽位的进程创建
+        for (const ExportEntry& entry : exports_) {
+            if (entry.payload_size > channel->ring.PayloadCapacity()) {
+                throw PluginException(InstanceError::kErrorEventBridge,
+                    "Exported event payload does not fit in an event bridge slot.");
+            }
+        }
+
+        // 只接收 Open 之后写入的记录
+        const uint64_t cursor = channel->ring.Head();
+        channel_.Store(channel);
+        reader_ = std::thread(&EventBridge::ReadLoop, this, channel, cursor);
+    }
+
+    /**
+     * @brief [IEventBridge 接口实现] 停止读线程并解除映射。
+     */
+    void EventBridge::Close() {
+        std::shared_ptr<const Channel> channel;
+        std::thread reader;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            channel = channel_.Load();
+            if (!channel) {
+                return;
+            }
+            channel_.Store(nullptr);
+            channel->closing.store(true, std::memory_order_release);
+            reader = std::move(reader_);
+        }
+
+        if (reader.joinable()) {
+            if (reader.get_id() == std::this_thread::get_id()) {
+                reader.detach();  // 见析构函数
+            }
+            else {
+                reader.join();
+            }
+        }
+        if (channel->remove_on_close) {
+            SharedMemoryRegion::Remove(channel->name);
+        }
+        // 映射随最后一个快照 (可能仍在某个发布者线程上) 一起释放
+    }
+
+    bool EventBridge::IsOpen() const {
+        return static_cast<bool>(channel_.Load());
+    }
+
+    EventBridgeStats EventBridge::GetStats() const {
+        EventBridgeStats stats;
+        stats.exported = exported_.load(std::memory_order_relaxed);
+        stats.imported = imported_.load(std::memory_order_relaxed);
+        stats.lost = lost_.load(std::memory_order_relaxed);
+        stats.rejected = rejected_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /**
+     * @brief [IEventBridge 内部实现] 登记导出类型并订阅它。
+     */
+    void EventBridge::ExportImpl(EventId event_id, size_t payload_size,
+        EncodeFn encode) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const ExportEntry& entry : exports_) {
+            if (entry.event_id == event_id) {
+                return;
+            }
+        }
+        std::shared_ptr<const Channel> channel = channel_.Load();
+        if (channel && payload_size > channel->ring.PayloadCapacity()) {
+            throw PluginException(InstanceError::kErrorEventBridge,
+                "Exported event payload does not fit in an event bridge slot.");
+        }
+
+        ExportEntry entry{ event_id, payload_size, encode };
+        SubscribeExport(*LockManager(), entry);
+        exports_.push_back(entry);
+    }
+
+    /**
+     * @brief [IEventBridge 内部实现] 登记导入类型 (发布新的导入表快照)。
+     */
+    void EventBridge::ImportImpl(EventId event_id, size_t payload_size,
+        DecodeFn decode, bool retained) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto next = std::make_shared<ImportMap>(*imports_.Load());
+        (*next)[event_id] = ImportEntry{ payload_size, decode, retained };
+        imports_.Store(std::move(next));
+    }
+
+    void EventBridge::SubscribeExport(PluginManager& manager,
+        const ExportEntry& entry) {
+        EventDelegate delegate = EventDelegate::Create<ExportEntry>(entry,
+            [](const void* storage, void* target, const Event& e) {
+                static_cast<EventBridge*>(target)->Publish(
+                    EventDelegate::Payload<ExportEntry>(storage), e);
+            });
+        manager.AddGlobalSubscription(entry.event_id,
+            { weak_from_this(), std::weak_ptr<void>(), std::move(delegate),
+             nullptr, ConnectionType::kDirect, nullptr });
+    }
+
+    /**
+     * @brief 把事件的载荷写入共享环 (发布者线程；写环本身无锁)。
+     */
+    void EventBridge::Publish(const ExportEntry& entry, const Event& e) {
+        if (t_republishing_bridge == this) {
+            return;
+        }
+        std::shared_ptr<const Channel> channel = channel_.Load();
+        if (!channel) {
+            return;
+        }
+        if (entry.payload_size > channel->ring.PayloadCapacity()) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const bool written = const_cast<SharedEventRing&>(channel->ring).Write(
+            origin_, entry.event_id, entry.payload_size,
+            [&](void* payload) { entry.encode(e, payload); });
+        (written ? exported_ : lost_).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 读线程：轮询共享环并重新发布导入的记录。
+     * @details 每轮开始时锁定本对象与管理器、读取导入表快照；
+     * 管理器已析构时退出。两个引用在每轮结束时释放，此后只访问 channel
+     * (本对象可能已在这里析构，见析构函数)。
+     */
+    void EventBridge::ReadLoop(std::shared_ptr<const Channel> channel,
+        uint64_t cursor) {
+        const SharedEventRing& ring = channel->ring;
+        uint32_t idle_rounds = 0;
+        uint64_t stalled_at = UINT64_MAX;
+        std::chrono::steady_clock::time_point stalled_since;
+
+        while (!channel->closing.load(std::memory_order_acquire)) {
+            size_t progress = 0;
+            {
+                // 重新发布时导出订阅会临时锁定本对象，
+                // 本轮持有一个强引用，最后一个引用可能在这里释放
+                PluginPtr<EventBridge> self = weak_from_this().lock();
+                if (!self) {
+                    return;  // 正在析构，Close 等待本线程退出
+                }
+                PluginPtr<PluginManager> manager = manager_.lock();
+                if (!manager) {
+                    return;
+                }
+                std::shared_ptr<const ImportMap> imports = imports_.Load();
+
+                auto decode = [&](uint64_t origin, EventId event_id,
+                    const void* payload, size_t size) {
+                    Decoded record;
+                    if (origin == origin_) {
+                        return record;
+                    }
+                    auto it = imports->find(event_id);
+                    if (it == imports->end()) {
+                        return record;
+                    }
+                    record.event_id = event_id;
+                    record.entry = &it->second;
+                    if (size != it->second.payload_size) {
+                        record.rejected = true;
+                    }
+                    else if (it->second.retained ||
+                        manager->IsGlobalSubscribed(event_id)) {
+                        record.event = it->second.decode(payload);
+                    }
+                    return record;
+                    };
+
+                uint64_t lost = 0;
+                for (; progress < kReadBatch; ++progress) {
+                    Decoded record;
+                    SharedEventRing::ReadStatus status =
+                        ring.Read(cursor, lost, record, decode);
+                    if (status == SharedEventRing::ReadStatus::kEmpty) {
+                        break;
+                    }
+                    if (record.rejected) {
+                        rejected_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else if (record.entry) {
+                        imported_.fetch_add(1, std::memory_order_relaxed);
+                        if (record.event) {
+                            Republish(*manager, record);
+                        }
+                    }
+                }
+
+                // 之后的序号已被领取，但 cursor 处的槽位迟迟不发布：写者中途退出
+                if (progress == 0 && ring.Head() > cursor) {
+                    const auto now = std::chrono::steady_clock::now();
+                    if (stalled_at != cursor) {
+                        stalled_at = cursor;
+                        stalled_since = now;
+                    }
+                    else if (now - stalled_since > kStalledSlotTimeout) {
+                        SharedEventRing::Skip(cursor, lost);
+                        progress = 1;
+                    }
+                }
+                if (lost != 0) {
+                    lost_.fetch_add(lost, std::memory_order_relaxed);
+                }
+            }
+
+            if (progress != 0) {
+                idle_rounds = 0;
+            }
+            else if (idle_rounds < kIdleSpinRounds) {
+                ++idle_rounds;
+            }
+            else if (idle_rounds < kIdleSpinRounds + kIdleYieldRounds) {
+                ++idle_rounds;
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+        }
+    }
+
+    /**
+     * @brief 在本进程重新发布一条记录。回调异常以 AsyncExceptionEvent 报告，
+     * 读线程继续运行。
+     */
+    void EventBridge::Republish(PluginManager& manager, const Decoded& record) {
+        t_republishing_bridge = this;
+        try {
+            if (record.entry->retained) {
+                manager.RetainGlobalImpl(record.event_id, record.event);
+            }
+            if (manager.IsGlobalSubscribed(record.event_id)) {
+                manager.FireGlobalImpl(record.event_id, record.event);
+            }
+        }
+        catch (const std::exception& e) {
+            manager.FireGlobal<event::AsyncExceptionEvent>(std::string(e.what()));
+        }
+        catch (...) {
+            manager.FireGlobal<event::AsyncExceptionEvent>(
+                "Unknown exception while republishing a bridged event.");
+        }
+        t_republishing_bridge = nullptr;
+    }
+
+}  // namespace z3y
@@ -0,0 +1,147 @@
+/**
+ * @file event_bridge.h
+ * @brief [内部] 定义 z3y::EventBridge，IEventBridge 的共享内存实现。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 由 PluginManager 注册为单例服务 clsid::kEventBridge；
+ * 不调用 Open 时只是一个空对象 (没有线程，也没有共享内存)。
+ * - Export：以 kDirect 订阅事件，在发布者线程上直接写入共享环；
+ * - Import：读线程轮询共享环 (先自旋、再让步、最后短暂休眠)，
+ * 把其他进程的记录解码后经由 RetainGlobalImpl / FireGlobalImpl 重新发布。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_EVENT_BRIDGE_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_EVENT_BRIDGE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/i_event_bridge.h"
+#include "framework/component_helpers.h"
+#include "framework/plugin_impl.h"
+#include "shared_event_ring.h"
+#include "shared_memory.h"
+#include "snapshot_ptr.h"
+
+namespace z3y {
+
+    class PluginManager;
+
+    /**
+     * @class EventBridge
+     * @brief [!! 新增 !!] 跨进程事件桥。
+     */
+    class EventBridge : public PluginImpl<EventBridge, IEventBridge> {
+    public:
+        Z3Y_DEFINE_COMPONENT_ID("z3y-core-event-bridge-IMPL-UUID")
+
+        EventBridge();
+        ~EventBridge() override;
+
+        void Open(const EventBridgeOptions& options) override;
+        void Close() override;
+        bool IsOpen() const override;
+        EventBridgeStats GetStats() const override;
+
+    protected:
+        void ExportImpl(EventId event_id, size_t payload_size,
+            EncodeFn encode) override;
+        void ImportImpl(EventId event_id, size_t payload_size,
+            DecodeFn decode, bool retained) override;
+
+    private:
+        /**
+         * @struct ExportEntry
+         * @brief 一个导出的事件类型 (同时是导出订阅的委托载荷)。
+         */
+        struct ExportEntry {
+            EventId event_id;
+            size_t payload_size;
+            EncodeFn encode;
+        };
+
+        /**
+         * @struct ImportEntry
+         * @brief 一个导入的事件类型。
+         */
+        struct ImportEntry {
+            size_t payload_size;
+            DecodeFn decode;
+            bool retained;
+        };
+
+        using ImportMap = std::unordered_map<EventId, ImportEntry>;
+
+        /**
+         * @struct Channel
+         * @brief 一次 Open 的映射与环。
+         * 发布者线程持有快照期间映射保持有效 (Close 不会在写入途中解除映射)。
+         */
+        struct Channel {
+            std::unique_ptr<SharedMemoryRegion> region;
+            SharedEventRing ring;
+            std::string name;
+            bool remove_on_close = false;
+            mutable std::atomic<bool> closing{ false };
+        };
+
+        /**
+         * @struct Decoded
+         * @brief 从环中读出的一条记录。
+         */
+        struct Decoded {
+            EventId event_id = 0;
+            const ImportEntry* entry = nullptr;
+            PluginPtr<Event> event;
+            bool rejected = false;
+        };
+
+        /**
+         * @brief 导出订阅的回调 (发布者线程)。
+         */
+        void Publish(const ExportEntry& entry, const Event& e);
+
+        /**
+         * @brief 读线程主循环。
+         */
+        void ReadLoop(std::shared_ptr<const Channel> channel, uint64_t cursor);
+
+        /**
+         * @brief 在本进程重新发布一条导入的记录 (读线程)。
+         */
+        void Republish(PluginManager& manager, const Decoded& record);
+
+        /**
+         * @brief 以 kDirect 订阅一个导出类型。
+         */
+        void SubscribeExport(PluginManager& manager, const ExportEntry& entry);
+
+        PluginPtr<PluginManager> LockManager() const;
+
+        mutable std::mutex mutex_;  // Open / Close / Export / Import 互斥
+        SnapshotPtr<Channel> channel_;
+        SnapshotPtr<ImportMap> imports_;
+        std::vector<ExportEntry> exports_;
+        std::weak_ptr<PluginManager> manager_;
+        std::thread reader_;
+        const uint64_t origin_;  // 本实例的随机标识，用于跳过自己写入的记录
+
+        std::atomic<uint64_t> exported_{ 0 };
+        std::atomic<uint64_t> imported_{ 0 };
+        std::atomic<uint64_t> lost_{ 0 };
+        std::atomic<uint64_t> rejected_{ 0 };
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_EVENT_BRIDGE_H_
@@ -8,25 +8,56 @@
  * [修改]
  * 1. 遵从 Google 命名约定 (EventId,
  * struct members without trailing _)。
+ * 2. [!! COW !!] 订阅表改为不可变快照 (SnapshotPtr)：
+ * Fire 路径不取 event_mutex_、不拷贝列表 (读取快照的代价见 snapshot_ptr.h)；
+ * Subscribe/Unsubscribe 在 event_mutex_ 下复制并替换快照。
  */
 
 #include "plugin_manager.h"
 #include <algorithm>  // 用于 std::remove_if
 #include <chrono>     // [Fix 6] 依赖 std::chrono
+#include <exception>  // [!! 新增 !!] std::exception_ptr
+#include <iterator>   // [!! 新增 !!] std::make_move_iterator
 #include <set>
 #include <utility>
 #include <vector>
-#include <unordered_map> // [!! 新增 !!] 用于 EventMap/SenderMap 实现
+#include <unordered_map> // [!! 新增 !!] 用于 EventMap 实现
 #include <sstream>     // [!! 修正 !!] 缺少此头文件导致 C2079 错误
 
 namespace z3y {
 
+    /**
+     * @brief [辅助函数] 判断订阅是否已失效 (订阅者或发送者已析构)。
+     */
+    bool PluginManager::IsSubscriptionExpired(
+        const PluginManager::Subscription& s, bool check_sender_also) {
+        // [!! 新增 !!] 已经 Disconnect
+        if (s.connection && !s.connection->IsConnected()) {
+            return true;
+        }
+
+        // 检查订阅者是否已失效 (由连接句柄持有的订阅没有订阅者)
+        if (!s.connection_owned && s.subscriber_id.expired()) {
+            return true;
+        }
+
+        // 如果订阅者未失效，
+        // 并且我们需要检查发送者...
+        // (注意: owner_before
+        //  检查确保 sender_id
+        //  非空)
+        return check_sender_also &&
+            !s.sender_id.owner_before(std::weak_ptr<void>()) &&
+            s.sender_id.expired();
+    }
+
     /**
      * @brief [辅助函数] 清理已失效的(expired)订阅者 (weak_ptr)。
      *
      * [Fix 5] (重构):
      * ...
      * [修改] 使用 struct member (s.subscriber_id)
+     * [!! COW !!] 只作用于写者持有的列表副本。
      */
     void PluginManager::CleanupExpiredSubscriptions(
         std::vector<PluginManager::Subscription>& subs, bool check_sender_also,
@@ -36,24 +67,17 @@ namespace z3y {
                 subs.begin(), subs.end(),
                 [&gc_queue, check_sender_also](
                     const PluginManager::Subscription& s) {
-                        // 检查订阅者是否已失效
-                        bool expired = s.subscriber_id.expired();
-
-                        // 如果订阅者未失效，
-                        // 并且我们需要检查发送者...
-                        if (!expired && check_sender_also) {
-                            // 检查发送者是否已失效
-                            // (注意: owner_before
-                            //  检查确保 sender_id
-                            //  非空)
-                            expired = !s.sender_id.owner_before(std::weak_ptr<void>()) &&
-                                s.sender_id.expired();
-                        }
-
-                        if (expired) {
+                        if (IsSubscriptionExpired(s, check_sender_also)) {
                             // [Fix 5] 发现了失效订阅！
                             // 1. 将其放入 GC 队列...
-                            gc_queue.push(s.subscriber_id);
+                            // [!! 修改 !!] 只是断开而订阅者仍存活时，保留它的
+                            // 反向查找项 (其他订阅仍在使用)
+                            if (s.connection_owned || s.subscriber_id.expired()) {
+                                gc_queue.push(s.subscriber_id);
+                            }
+                            if (s.connection) {
+                                s.connection->MarkDisconnected();
+                            }
 
                             // 2. 返回 true...
                             return true;
@@ -63,393 +87,2791 @@ namespace z3y {
             subs.end());
     }
 
+    // --- [!! COW !!] 快照发布 (仅由写者调用) ---
+
+    /**
+     * @brief [!! COW !!] 发布某个全局事件的新订阅者列表。
+     * @details 复制当前 EventMap (仅拷贝 shared_ptr)，替换该键后原子发布。
+     */
+    void PluginManager::PublishGlobalList(EventId event_id,
+        EventCallbackList list) {
+        auto next = std::make_shared<EventMap>(*global_subscribers_.Load());
+
+        // [!! 新增 !!] 过滤器计数的增量：先增后发布，先发布后减，
+        // 保证过滤器永远不会在快照仍有订阅时报告“没有订阅者”。
+        auto it = next->find(event_id);
+        const ptrdiff_t delta = static_cast<ptrdiff_t>(list.size()) -
+            static_cast<ptrdiff_t>(it != next->end() ? it->second->size() : 0);
+        if (delta > 0) {
+            global_filter_.Adjust(event_id, delta);
+        }
+
+        if (list.empty()) {
+            next->erase(event_id);
+        }
+        else {
+            (*next)[event_id] =
+                std::make_shared<const EventCallbackList>(std::move(list));
+        }
+        global_subscribers_.Store(std::move(next));
+
+        if (delta < 0) {
+            global_filter_.Adjust(event_id, delta);
+        }
+    }
+
+    /**
+     * @brief [!! COW !!] 发布某个 (发送者, 事件) 的新订阅者列表。
+     * @details [!! 修改 !!] 根表只拷贝分片指针，
+     * 仅被修改的键所在的分片会被克隆 (见 flat_sender_index.h)。
+     */
+    void PluginManager::PublishSenderList(void* sender_key, EventId event_id,
+        EventCallbackList list) {
+        auto next = std::make_shared<SenderIndex>(*sender_subscribers_.Load());
+
+        // [!! 新增 !!] 过滤器计数的增量 (顺序同 PublishGlobalList)
+        const uint64_t filter_key =
+            SenderFilterKey(sender_key, event_id);
+        const CallbackListPtr* current = next->Find(sender_key, event_id);
+        const ptrdiff_t delta = static_cast<ptrdiff_t>(list.size()) -
+            static_cast<ptrdiff_t>(current ? (*current)->size() : 0);
+        if (delta > 0) {
+            sender_filter_.Adjust(filter_key, delta);
+        }
+
+        if (list.empty()) {
+            ForgetCategorySenderKey(sender_key, event_id);
+        }
+        next->Set(sender_key, event_id, list.empty() ? nullptr :
+            std::make_shared<const EventCallbackList>(std::move(list)));
+        sender_subscribers_.Store(std::move(next));
+
+        if (delta < 0) {
+            sender_filter_.Adjust(filter_key, delta);
+        }
+    }
+
+    // --- [!! 新增 !!] 失效订阅回收 (GC) ---
+
+    /**
+     * @brief [!! 新增 !!] 请求一次 GC。
+     * @details 不再有周期性的唤醒：只有真正产生 GC 工作时才唤醒一个工作线程。
+     */
+    void PluginManager::RequestGarbageCollection() {
+        if (!gc_requested_.load(std::memory_order_relaxed) &&
+            !gc_requested_.exchange(true, std::memory_order_acq_rel)) {
+            work_available_.NotifyOne();
+        }
+    }
+
+    /**
+     * @brief [!! 新增 !!] Fire 路径发现失效订阅时调用。
+     * @details
+     * Fire 路径只读快照，不能就地删除失效订阅；
+     * 它只置位 gc_sweep_pending_，由工作线程增量清扫。
+     */
+    void PluginManager::RequestExpiredSweep() {
+        if (!gc_sweep_pending_.load(std::memory_order_relaxed)) {
+            gc_sweep_pending_.store(true, std::memory_order_relaxed);
+            RequestGarbageCollection();
+        }
+    }
+
+    void PluginManager::QueueDisconnectedConnection(
+        std::shared_ptr<SubscriptionConnection> connection) {
+        {
+            std::lock_guard<std::mutex> lock(gc_disconnect_mutex_);
+            gc_disconnected_.push_back(std::move(connection));
+        }
+        RequestGarbageCollection();
+    }
+
+    /**
+     * @brief [!! 新增 !!] 执行一个 GC 时间片。
+     * @details
+     * 每批工作都单独获取一次 event_mutex_，批与批之间 Subscribe /
+     * Unsubscribe 可以插入；超出时间预算后返回，
+     * 让工作线程先处理排队的事件，剩余工作通过 RequestGarbageCollection 续上。
+     */
+    void PluginManager::RunGarbageCollectionSlice() {
+        constexpr size_t kGcBatch = 64;
+        const auto deadline =
+            std::chrono::steady_clock::now() + options_.event_gc_slice_budget;
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+            ++gc_slices_;
+
+            // 1. 开始新的清扫：记录当前快照中的所有键
+            // (清扫是幂等的，进行中的清扫直接重新开始)
+            if (gc_sweep_pending_.exchange(false, std::memory_order_relaxed)) {
+                gc_global_cursor_.clear();
+                for (const auto& pair : *global_subscribers_.Load()) {
+                    gc_global_cursor_.push_back(pair.first);
+                }
+                gc_sender_cursor_.clear();
+                sender_subscribers_.Load()->ForEach(
+                    [this](const SenderIndex::Entry& entry) {
+                        gc_sender_cursor_.emplace_back(entry.sender_key,
+                            entry.event_id);
+                    });
+            }
+
+            // 2. [!! 新增 !!] 已断开的连接：只清扫它们所在的键
+            std::vector<std::shared_ptr<SubscriptionConnection>> disconnected;
+            {
+                std::lock_guard<std::mutex> pending_lock(gc_disconnect_mutex_);
+                disconnected.swap(gc_disconnected_);
+            }
+            for (const auto& connection : disconnected) {
+                gc_global_cursor_.insert(gc_global_cursor_.end(),
+                    connection->global_keys.begin(), connection->global_keys.end());
+                gc_sender_cursor_.insert(gc_sender_cursor_.end(),
+                    connection->sender_keys.begin(), connection->sender_keys.end());
+            }
+        }
+
+        // 3. 按批推进，直到没有工作或超出预算
+        bool more_work = true;
+        while (std::chrono::steady_clock::now() < deadline) {
+            std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+            if (!gc_global_cursor_.empty()) {
+                SweepGlobalBatch(kGcBatch);
+            }
+            else if (!gc_sender_cursor_.empty()) {
+                SweepSenderBatch(kGcBatch);
+            }
+            else if (!gc_queue_.empty()) {
+                ReclaimLookupBatch(kGcBatch);
+            }
+            else {
+                more_work = false;
+                break;
+            }
+        }
+
+        if (more_work || gc_sweep_pending_.load(std::memory_order_relaxed)) {
+            RequestGarbageCollection();
+        }
+    }
+
+    /**
+     * @brief [!! COW !!] 清扫一批全局键，整批只复制/发布一次 EventMap。
+     */
+    void PluginManager::SweepGlobalBatch(size_t max_keys) {
+        EventMapPtr current = global_subscribers_.Load();
+        std::shared_ptr<EventMap> next;
+        std::vector<std::pair<EventId, ptrdiff_t>> removed;
+
+        for (size_t i = 0; i < max_keys && !gc_global_cursor_.empty(); ++i) {
+            const EventId event_id = gc_global_cursor_.back();
+            gc_global_cursor_.pop_back();
+
+            // 同一个键可能在一批中出现多次 (断开的连接与全量清扫)：
+            // 已改写过的键必须读改写后的列表，否则同一订阅会被重复计数
+            const EventMap& source = next ? *next : *current;
+            auto it = source.find(event_id);
+            if (it == source.end()) {
+                continue;
+            }
+            EventCallbackList list = *it->second;
+            const size_t before = list.size();
+            CleanupExpiredSubscriptions(list, false, gc_queue_);
+            if (list.size() == before) {
+                continue;
+            }
+
+            if (!next) {
+                next = std::make_shared<EventMap>(*current);
+            }
+            removed.emplace_back(event_id,
+                static_cast<ptrdiff_t>(list.size()) -
+                static_cast<ptrdiff_t>(before));
+            if (list.empty()) {
+                next->erase(event_id);
+            }
+            else {
+                (*next)[event_id] =
+                    std::make_shared<const EventCallbackList>(std::move(list));
+            }
+        }
+
+        if (!next) {
+            return;
+        }
+        global_subscribers_.Store(std::move(next));
+        // 过滤器计数只减不增，必须在发布之后调整
+        for (const auto& pair : removed) {
+            global_filter_.Adjust(pair.first, pair.second);
+            gc_subscriptions_reclaimed_ += static_cast<uint64_t>(-pair.second);
+        }
+    }
+
+    /**
+     * @brief [!! COW !!] 清扫一批 (发送者, 事件) 键，整批只复制/发布一次根表
+     * (同一分片内的多次修改只克隆该分片一次)。
+     */
+    void PluginManager::SweepSenderBatch(size_t max_keys) {
+        std::shared_ptr<const SenderIndex> current = sender_subscribers_.Load();
+        std::shared_ptr<SenderIndex> next;
+        std::vector<std::pair<uint64_t, ptrdiff_t>> removed;
+
+        for (size_t i = 0; i < max_keys && !gc_sender_cursor_.empty(); ++i) {
+            const auto key = gc_sender_cursor_.back();
+            gc_sender_cursor_.pop_back();
+
+            // 与 SweepGlobalBatch 相同：重复的键读改写后的表
+            const CallbackListPtr* subs = next ? next->Find(key.first, key.second)
+                : current->Find(key.first, key.second);
+            if (!subs) {
+                continue;
+            }
+            EventCallbackList list = **subs;
+            const size_t before = list.size();
+            CleanupExpiredSubscriptions(list, true, gc_queue_);
+            if (list.size() == before) {
+                continue;
+            }
+
+            if (!next) {
+                next = std::make_shared<SenderIndex>(*current);
+            }
+            removed.emplace_back(SenderFilterKey(key.first, key.second),
+                static_cast<ptrdiff_t>(list.size()) -
+                static_cast<ptrdiff_t>(before));
+            if (list.empty()) {
+                ForgetCategorySenderKey(key.first, key.second);
+            }
+            next->Set(key.first, key.second, list.empty() ? nullptr :
+                std::make_shared<const EventCallbackList>(std::move(list)));
+        }
+
+        if (!next) {
+            return;
+        }
+        sender_subscribers_.Store(std::move(next));
+        for (const auto& pair : removed) {
+            sender_filter_.Adjust(pair.first, pair.second);
+            gc_subscriptions_reclaimed_ += static_cast<uint64_t>(-pair.second);
+        }
+    }
+
+    /**
+     * @brief 从 gc_queue_ 回收一批反向查找项 (及其 strand)。
+     */
+    void PluginManager::ReclaimLookupBatch(size_t max_entries) {
+        for (size_t i = 0; i < max_entries && !gc_queue_.empty(); ++i) {
+            const std::weak_ptr<void> expired = std::move(gc_queue_.front());
+            gc_queue_.pop();
+            // Note: global_sub_lookup_ / sender_sub_lookup_ are std::map
+            global_sub_lookup_.erase(expired);
+            sender_sub_lookup_.erase(expired);
+            subscriber_strands_.erase(expired);
+            ++gc_lookup_entries_reclaimed_;
+        }
+    }
+
+    /**
+     * @brief [!! 新增 !!] 获取失效订阅回收 (GC) 的计数器。
+     */
+    EventGcStats PluginManager::GetEventGcStats() {
+        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+        EventGcStats stats;
+        stats.sweep_requested =
+            gc_sweep_pending_.load(std::memory_order_relaxed);
+        stats.pending_sweep_keys =
+            gc_global_cursor_.size() + gc_sender_cursor_.size();
+        stats.pending_lookup_entries = gc_queue_.size();
+        stats.slices = gc_slices_;
+        stats.subscriptions_reclaimed = gc_subscriptions_reclaimed_;
+        stats.lookup_entries_reclaimed = gc_lookup_entries_reclaimed_;
+        return stats;
+    }
+
     // --- [!! 新增 !!] IEventBus 订阅查询接口实现 ---
 
     /**
      * @brief [IEventBus 内部实现] 检查是否有全局订阅者。
+     * [!! COW !!] 不取 event_mutex_：只读取当前快照。
+     * [!! 优化 !!] 先查过滤器：没有订阅时只需一次 relaxed 原子读取。
      */
     bool PluginManager::IsGlobalSubscribed(EventId event_id) {
-        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+        if (!global_filter_.MayContain(event_id)) {
+            return false;
+        }
+
+        EventMapPtr globals = global_subscribers_.Load();
 
         // 查找事件ID
-        auto it = global_subscribers_.find(event_id);
-        if (it == global_subscribers_.end()) {
+        auto it = globals->find(event_id);
+        if (it == globals->end()) {
             return false;
         }
 
-        // 清理已过期的订阅，并检查剩余数量
-        CleanupExpiredSubscriptions(it->second, false, gc_queue_);
-
-        return !it->second.empty();
+        // 检查是否仍有存活的订阅者
+        for (const auto& sub : *it->second) {
+            if (!IsSubscriptionExpired(sub, false)) {
+                return true;
+            }
+        }
+        RequestExpiredSweep();
+        return false;
     }
 
     /**
      * @brief [IEventBus 内部实现] 检查是否有特定发送者的订阅者。
+     * [!! COW !!] 不取 event_mutex_：只读取当前快照。
+     * [!! 优化 !!] 先查过滤器：没有订阅时只需一次 relaxed 原子读取。
      */
     bool PluginManager::IsSenderSubscribed(void* sender_key, EventId event_id) {
-        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+        if (!sender_filter_.MayContain(
+            SenderFilterKey(sender_key, event_id))) {
+            return false;
+        }
 
-        // 1. 查找发送者
-        auto sender_it = sender_subscribers_.find(sender_key);
-        if (sender_it == sender_subscribers_.end()) {
+        std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+
+        // [!! 修改 !!] 一次扁平表查找 (原为 发送者 -> 事件ID 两次查找)
+        const CallbackListPtr* subs = senders->Find(sender_key, event_id);
+        if (!subs) {
             return false;
         }
 
-        // 2. 查找事件ID
-        auto event_it = sender_it->second.find(event_id);
-        if (event_it == sender_it->second.end()) {
+        // 检查是否仍有存活的订阅者
+        for (const auto& sub : **subs) {
+            if (!IsSubscriptionExpired(sub, true)) {
+                return true;
+            }
+        }
+        RequestExpiredSweep();
+        return false;
+    }
+
+    // --- 1. 事件循环 (Event Loop) ---
+
+    namespace {
+        /**
+         * @brief [!! 新增 !!] 当前线程所属的 PluginManager (非工作线程为 nullptr)。
+         */
+        thread_local const void* t_worker_owner = nullptr;
+        /**
+         * @brief [!! 新增 !!] 当前工作线程的序号。
+         */
+        thread_local size_t t_worker_index = 0;
+        /**
+         * @brief [!! 新增 !!] 看门狗开启时，当前工作线程 (或隔离线程) 所属的
+         * PluginManager；回调执行期间置空，因此嵌套的回调不会重复计时。
+         */
+        thread_local PluginManager* t_watchdog_owner = nullptr;
+
+        /**
+         * @brief [!! 新增 !!] 当前线程正在处理的事件的统计条目 (统计关闭时为 nullptr)。
+         * 由发布路径与 RunEventTask 设置；EnqueueEventTask 据此为任务打戳，
+         * InvokeSubscription 据此为回调计时。
+         */
+        thread_local EventStatsEntry* t_stats_entry = nullptr;
+
+        /**
+         * @brief [!! 新增 !!] 在作用域内切换 t_stats_entry (嵌套发布后恢复外层)。
+         */
+        class StatsEntryScope {
+        public:
+            explicit StatsEntryScope(EventStatsEntry* entry)
+                : previous_(t_stats_entry) {
+                t_stats_entry = entry;
+            }
+            ~StatsEntryScope() { t_stats_entry = previous_; }
+
+            StatsEntryScope(const StatsEntryScope&) = delete;
+            StatsEntryScope& operator=(const StatsEntryScope&) = delete;
+
+        private:
+            EventStatsEntry* previous_;
+        };
+
+        /**
+         * @struct TraceContext
+         * @brief [!! 新增 !!] 当前线程正在分发的、被采样追踪的发布。
+         */
+        struct TraceContext {
+            EventId event_id;
+            const void* event;
+        };
+
+        /**
+         * @brief [!! 新增 !!] 由 DispatchToList 设置 (本次发布未被采样时为 nullptr)；
+         * 入队的任务据此打上追踪戳，执行时沿用发布的采样结果。
+         */
+        thread_local const TraceContext* t_trace_context = nullptr;
+
+        /**
+         * @brief [!! 新增 !!] 在作用域内切换 t_trace_context (与 StatsEntryScope 相同)。
+         */
+        class TraceContextScope {
+        public:
+            explicit TraceContextScope(const TraceContext* context)
+                : previous_(t_trace_context) {
+                t_trace_context = context;
+            }
+            ~TraceContextScope() { t_trace_context = previous_; }
+
+            TraceContextScope(const TraceContextScope&) = delete;
+            TraceContextScope& operator=(const TraceContextScope&) = delete;
+
+        private:
+            const TraceContext* previous_;
+        };
+
+        /**
+         * @brief [!! 新增 !!] 为被追踪的发布投递的任务打上追踪戳。
+         */
+        void StampTrace(EventTask& task) {
+            if (t_trace_context && !task.Traced()) {
+                task.StampTrace(t_trace_context->event_id, t_trace_context->event);
+            }
+        }
+
+        /**
+         * @brief [!! 新增 !!] 发布开始：统计开启时取得条目并计数。
+         */
+        EventStatsEntry* BeginFireStats(EventStatsTable& table, EventId event_id) {
+            if (!table.Enabled()) {
+                return nullptr;
+            }
+            EventStatsEntry* entry = table.Acquire(event_id);
+            entry->fired.fetch_add(1, std::memory_order_relaxed);
+            return entry;
+        }
+
+        void RecordFanOut(size_t fan_out) {
+            if (t_stats_entry) {
+                t_stats_entry->fan_out.Record(fan_out);
+            }
+        }
+
+        /**
+         * @brief [!! 新增 !!] 为一次回调计时 (回调抛出异常时也记录)。
+         */
+        class CallbackTimer {
+        public:
+            CallbackTimer()
+                : entry_(t_stats_entry),
+                start_ns_(entry_ ? EventStatsTable::NowNanoseconds() : 0) {}
+            ~CallbackTimer() {
+                if (entry_) {
+                    entry_->callback_ns.Record(
+                        EventStatsTable::NowNanoseconds() - start_ns_);
+                }
+            }
+
+            CallbackTimer(const CallbackTimer&) = delete;
+            CallbackTimer& operator=(const CallbackTimer&) = delete;
+
+        private:
+            EventStatsEntry* entry_;
+            uint64_t start_ns_;
+        };
+    }  // namespace
+
+    /**
+     * @class PluginManager::SlowCallbackWatch
+     * @brief [!! 新增 !!] 看门狗计时：只在工作线程/隔离线程的最外层回调上生效。
+     * @details 回调正常返回后由 Finish 检查预算并报告；
+     * 回调抛出异常时只恢复线程状态 (异常由 RunEventTask 报告)。
+     */
+    class PluginManager::SlowCallbackWatch {
+    public:
+        SlowCallbackWatch() : owner_(t_watchdog_owner), start_ns_(0) {
+            if (owner_) {
+                t_watchdog_owner = nullptr;
+                start_ns_ = EventStatsTable::NowNanoseconds();
+            }
+        }
+        ~SlowCallbackWatch() {
+            if (owner_) {
+                t_watchdog_owner = owner_;
+            }
+        }
+
+        SlowCallbackWatch(const SlowCallbackWatch&) = delete;
+        SlowCallbackWatch& operator=(const SlowCallbackWatch&) = delete;
+
+        void Finish(const Subscription& sub) {
+            if (!owner_) {
+                return;
+            }
+            PluginManager* owner = std::exchange(owner_, nullptr);
+            t_watchdog_owner = owner;
+            const uint64_t elapsed = EventStatsTable::NowNanoseconds() - start_ns_;
+            const auto budget = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                owner->options_.slow_callback_budget).count();
+            if (elapsed > static_cast<uint64_t>(budget)) {
+                owner->ReportSlowCallback(sub, elapsed);
+            }
+        }
+
+    private:
+        PluginManager* owner_;
+        uint64_t start_ns_;
+    };
+
+    /**
+     * @brief [!! 新增 !!] 将异步任务投递给工作线程池。
+     * @details
+     * [!! 修改 !!] 全局队列改为有界环形队列 (event_queues_)，
+     * 入队失败时按 options_.event_queue_overflow_policy 处理。
+     * [!! 修改 !!] 每个优先级一个通道；溢出策略只作用于本通道
+     * (kDropOldest 丢弃的是同一通道中最旧的任务)。
+     * @throws z3y::PluginException (kErrorEventQueueFull)
+     * 队列已满且策略为 kReject。
+     */
+    void PluginManager::EnqueueEventTask(EventTask task,
+        EventPriority priority) {
+        const size_t lane = static_cast<size_t>(priority);
+        EventRingBuffer<EventTask>& queue = *event_queues_[lane];
+
+        // [!! 新增 !!] 统计：在发布路径上入队的任务记下事件与入队时间
+        if (t_stats_entry && !task.StatsEntry()) {
+            task.Stamp(t_stats_entry, EventStatsTable::NowNanoseconds());
+        }
+        StampTrace(task);
+        if (event_stats_.Enabled()) {
+            RecordQueueDepth(lane);
+        }
+
+        // 1. 工作线程内部投递 (例如回调中再次 Fire)：
+        //    多工作线程时放入本地队列，空闲的工作线程可以窃取；
+        //    单工作线程时优先走全局队列以保持 FIFO。
+        //    [!! 修改 !!] 各工作线程的本地队列合计同样以队列容量为上限
+        //    (见 EnqueueLocalEventTask)。
+        if (t_worker_owner == this) {
+            if (worker_queues_.size() > 1 ||
+                !queue.TryPush(std::move(task))) {
+                EnqueueLocalEventTask(std::move(task), lane);
+                return;
+            }
+            work_available_.NotifyOne();
+            return;
+        }
+
+        // 2. 外部线程投递：放入全局环形队列
+        if (queue.TryPush(std::move(task))) {
+            work_available_.NotifyOne();  // 仅在有空闲线程时才唤醒
+            return;
+        }
+
+        // 3. [!! 新增 !!] 队列已满：应用溢出策略
+        switch (options_.event_queue_overflow_policy) {
+        case QueueOverflowPolicy::kDropNewest:
+            queue_dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+            return;
+
+        case QueueOverflowPolicy::kDropOldest: {
+            EventTask oldest;
+            while (!queue.TryPush(std::move(task))) {
+                if (!running_.load(std::memory_order_acquire)) {
+                    return;  // 正在关闭，与 kBlock 相同
+                }
+                if (queue.TryPop(oldest)) {
+                    oldest = nullptr;
+                    queue_dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();  // 空位被其他发布者抢走
+                }
+            }
+            work_available_.NotifyOne();
+            return;
+        }
+
+        case QueueOverflowPolicy::kReject:
+            queue_rejected_.fetch_add(1, std::memory_order_relaxed);
+            throw PluginException(InstanceError::kErrorEventQueueFull,
+                "Async event queue is full (capacity " +
+                std::to_string(queue.Capacity()) + ").");
+
+        case QueueOverflowPolicy::kBlock:
+        default:
+            queue_blocked_.fetch_add(1, std::memory_order_relaxed);
+            while (!queue.TryPush(std::move(task))) {
+                if (!running_.load(std::memory_order_acquire)) {
+                    return;  // 正在关闭，不再等待
+                }
+                EventCount::Key key = space_available_.PrepareWait();
+                if (queue.TryPush(std::move(task))) {
+                    space_available_.CancelWait();
+                    break;
+                }
+                space_available_.Wait(key);
+            }
+            work_available_.NotifyOne();
+            return;
+        }
+    }
+
+    /**
+     * @brief [!! 新增 !!] 工作线程上的投递放入它的本地队列。
+     * @details 所有工作线程在该通道的本地任务合计达到队列容量时应用溢出策略；
+     * 工作线程是消费者，不能阻塞 (会死锁)，因此 kBlock 在这里按 kDropNewest 处理，
+     * kDropOldest 丢弃本线程本地队列 (或全局队列) 中最旧的任务。
+     * @throws z3y::PluginException (kErrorEventQueueFull) 策略为 kReject。
+     */
+    void PluginManager::EnqueueLocalEventTask(EventTask task, size_t lane) {
+        WorkerQueue& local = *worker_queues_[t_worker_index];
+        std::atomic<size_t>& local_count = local_task_counts_[lane];
+        const size_t capacity = event_queues_[lane]->Capacity();
+
+        if (local_count.load(std::memory_order_relaxed) >= capacity) {
+            switch (options_.event_queue_overflow_policy) {
+            case QueueOverflowPolicy::kReject:
+                queue_rejected_.fetch_add(1, std::memory_order_relaxed);
+                throw PluginException(InstanceError::kErrorEventQueueFull,
+                    "Worker-local event queue is full (capacity " +
+                    std::to_string(capacity) + ").");
+
+            case QueueOverflowPolicy::kDropOldest: {
+                EventTask oldest;
+                {
+                    std::lock_guard<std::mutex> lock(local.mutex);
+                    if (!local.tasks[lane].empty()) {
+                        oldest = std::move(local.tasks[lane].front());
+                        local.tasks[lane].pop_front();
+                        local.tasks[lane].push_back(std::move(task));
+                    }
+                }
+                if (oldest) {
+                    // 替换，本地计数不变
+                    queue_dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+                    work_available_.NotifyOne();
+                    return;
+                }
+                if (event_queues_[lane]->TryPop(oldest)) {
+                    queue_dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+                    if (event_queues_[lane]->TryPush(std::move(task))) {
+                        work_available_.NotifyOne();
+                        return;
+                    }
+                }
+                queue_dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            case QueueOverflowPolicy::kDropNewest:
+            case QueueOverflowPolicy::kBlock:
+            default:
+                queue_dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(local.mutex);
+            local.tasks[lane].push_back(std::move(task));
+        }
+        local_count.fetch_add(1, std::memory_order_release);
+        work_available_.NotifyOne();
+    }
+
+    /**
+     * @details 块按订阅列表的顺序切分，每块恰好含 chunk 个有效的共享订阅
+     * (最后一块可能更少)；每个任务入队时各唤醒一个空闲的工作线程。
+     */
+    template <typename TMakeTask>
+    void PluginManager::EnqueueSharedFanOut(const CallbackListPtr& subs,
+        bool check_sender_also, size_t queued_count, EventPriority priority,
+        const TMakeTask& make_task) {
+        const size_t chunk = options_.event_worker_count > 1
+            ? options_.event_fan_out_chunk_size : 0;
+        const size_t size = subs->size();
+        if (chunk == 0 || queued_count <= chunk) {
+            EnqueueEventTask(make_task(0, size), priority);
+            return;
+        }
+        size_t begin = 0;
+        size_t in_chunk = 0;
+        for (size_t i = 0; i < size; ++i) {
+            const Subscription& sub = (*subs)[i];
+            if (!IsSharedQueued(sub) ||
+                IsSubscriptionExpired(sub, check_sender_also)) {
+                continue;
+            }
+            if (++in_chunk == chunk) {
+                EnqueueEventTask(make_task(begin, i + 1), priority);
+                begin = i + 1;
+                in_chunk = 0;
+            }
+        }
+        if (in_chunk != 0) {
+            EnqueueEventTask(make_task(begin, size), priority);
+        }
+    }
+
+    /**
+     * @brief [!! 新增 !!] 获取异步事件队列的计数器。
+     */
+    EventQueueStats PluginManager::GetEventQueueStats() const {
+        EventQueueStats stats;
+        stats.capacity = event_queues_[0]->Capacity();
+        stats.depth = 0;
+        for (size_t lane = 0; lane < kEventPriorityCount; ++lane) {
+            stats.lane_depth[lane] = event_queues_[lane]->SizeApprox() +
+                local_task_counts_[lane].load(std::memory_order_relaxed);
+            stats.depth += stats.lane_depth[lane];
+
+            stats.lane_executed[lane] = 0;
+            for (const auto& worker_queue : worker_queues_) {
+                stats.lane_executed[lane] +=
+                    worker_queue->executed[lane].load(std::memory_order_relaxed);
+            }
+        }
+        stats.dropped_oldest =
+            queue_dropped_oldest_.load(std::memory_order_relaxed);
+        stats.dropped_newest =
+            queue_dropped_newest_.load(std::memory_order_relaxed);
+        stats.rejected = queue_rejected_.load(std::memory_order_relaxed);
+        stats.blocked = queue_blocked_.load(std::memory_order_relaxed);
+        stats.coalesced = queue_coalesced_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void PluginManager::RecordQueueDepth(size_t lane) {
+        size_t lane_depth = 0;
+        size_t total = 0;
+        for (size_t i = 0; i < kEventPriorityCount; ++i) {
+            const size_t depth = event_queues_[i]->SizeApprox() +
+                local_task_counts_[i].load(std::memory_order_relaxed);
+            if (i == lane) {
+                lane_depth = depth;
+            }
+            total += depth;
+        }
+        event_stats_.RecordQueueDepth(lane, lane_depth, total);
+    }
+
+    // --- [!! 新增 !!] IEventStats 接口实现 ---
+
+    void PluginManager::EnableEventStats(bool enabled) {
+        event_stats_.Enable(enabled);
+    }
+
+    bool PluginManager::IsEventStatsEnabled() const {
+        return event_stats_.Enabled();
+    }
+
+    std::vector<EventStats> PluginManager::GetAllEventStats() const {
+        return event_stats_.Snapshot();
+    }
+
+    bool PluginManager::GetEventStats(EventId event_id,
+        EventStats& out_stats) const {
+        return event_stats_.Snapshot(event_id, out_stats);
+    }
+
+    EventQueueDepthStats PluginManager::GetQueueDepthStats() const {
+        return event_stats_.QueueDepth();
+    }
+
+    void PluginManager::ResetEventStats() {
+        event_stats_.Reset();
+    }
+
+    std::vector<SlowSubscriberStats> PluginManager::GetSlowSubscribers() const {
+        std::vector<SlowSubscriberStats> result;
+        {
+            std::lock_guard<std::mutex> lock(watchdog_mutex_);
+            for (const auto& pair : slow_subscribers_) {
+                if (!pair.first.expired()) {
+                    result.push_back(pair.second);
+                }
+            }
+        }
+        std::stable_sort(result.begin(), result.end(),
+            [](const SlowSubscriberStats& a, const SlowSubscriberStats& b) {
+                return a.overruns > b.overruns;
+            });
+        return result;
+    }
+
+    /**
+     * @brief [!! 修改 !!] 按加权轮转选择通道并取任务。
+     * @details
+     * 每个工作线程持有各通道的额度 (WorkerQueue::credits)：
+     * 1. 从高到低，取第一个“仍有额度且非空”的通道；
+     * 2. 有任务的通道额度都已用完时，重置额度开始新的周期。
+     * 因此高优先级通道连续取 weights[kHigh] 个任务后，
+     * 较低的非空通道必定被服务一次 (防饿死)；
+     * 只有一个通道有任务时它可以独占线程 (不浪费额度)。
+     */
+    bool PluginManager::TryDequeueEventTask(size_t worker_index,
+        EventTask& out_task) {
+        WorkerQueue& self = *worker_queues_[worker_index];
+
+        // 1. 本周期内仍有额度的通道
+        bool exhausted_lane = false;
+        for (size_t lane = kEventPriorityCount; lane-- > 0;) {
+            if (self.credits[lane] == 0) {
+                exhausted_lane = true;
+                continue;
+            }
+            if (TryDequeueFromLane(worker_index, lane, out_task)) {
+                --self.credits[lane];
+                self.executed[lane].fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        if (!exhausted_lane) {
             return false;
         }
 
-        // 清理已过期的订阅，并检查剩余数量
-        CleanupExpiredSubscriptions(event_it->second, true, gc_queue_);
-
-        return !event_it->second.empty();
+        // 2. 只剩额度用完的通道有任务：开始新的周期
+        for (size_t lane = kEventPriorityCount; lane-- > 0;) {
+            if (self.credits[lane] == 0 &&
+                TryDequeueFromLane(worker_index, lane, out_task)) {
+                for (size_t i = 0; i < kEventPriorityCount; ++i) {
+                    self.credits[i] = options_.event_lane_weights[i];
+                }
+                --self.credits[lane];
+                self.executed[lane].fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 从一个通道按“本地队列 → 全局队列 → 窃取”的顺序取任务。
+     */
+    bool PluginManager::TryDequeueFromLane(size_t worker_index, size_t lane,
+        EventTask& out_task) {
+        const size_t worker_count = worker_queues_.size();
+        std::atomic<size_t>& local_count = local_task_counts_[lane];
+
+        // 1. 本地队列 (队头，保持 FIFO)
+        if (local_count.load(std::memory_order_acquire) > 0) {
+            WorkerQueue& local = *worker_queues_[worker_index];
+            std::lock_guard<std::mutex> lock(local.mutex);
+            if (!local.tasks[lane].empty()) {
+                out_task = std::move(local.tasks[lane].front());
+                local.tasks[lane].pop_front();
+                local_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // 2. 全局环形队列
+        if (event_queues_[lane]->TryPop(out_task)) {
+            space_available_.NotifyOne();  // 可能有被阻塞的发布者 (kBlock)
+            return true;
+        }
+
+        // 3. 从其他工作线程的队尾窃取
+        if (local_count.load(std::memory_order_acquire) > 0) {
+            for (size_t i = 1; i < worker_count; ++i) {
+                WorkerQueue& victim =
+                    *worker_queues_[(worker_index + i) % worker_count];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks[lane].empty()) {
+                    out_task = std::move(victim.tasks[lane].back());
+                    victim.tasks[lane].pop_back();
+                    local_count.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 执行一个异步任务 (含追踪与异常转发)。
+     */
+    void PluginManager::RunEventTask(EventTask& task) {
+        // [!! 新增 !!] 统计：入队到开始执行的延迟；回调计时归属于任务的事件
+        EventStatsEntry* stats = task.StatsEntry();
+        if (stats) {
+            const uint64_t now = EventStatsTable::NowNanoseconds();
+            const uint64_t enqueued = task.EnqueuedNanoseconds();
+            stats->queue_latency_ns.Record(now > enqueued ? now - enqueued : 0);
+        }
+        StatsEntryScope stats_scope(stats);
+        // [!! 修改 !!] 追踪：沿用发布时的采样结果，以发布的事件 ID 与事件指针
+        // 记录开始/结束 (与 kEventFired / kQueuedEntry 对应)；
+        // 任务中再次入队的工作不继承它 (嵌套发布各自采样)
+        TraceContextScope no_trace(nullptr);
+        const bool traced = task.Traced();
+        const EventId traced_id = task.TraceEventId();
+        const void* traced_event = task.TraceEvent();
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kQueuedExecuteStart, traced_id,
+                traced_event);
+        }
+
+        try {
+            task();  // 在工作线程上执行回调
+        }
+        catch (const std::exception& e) {
+            //
+            // FireGlobal<...>
+            //
+            this->FireGlobal<event::AsyncExceptionEvent>(
+                std::string(e.what()));
+        }
+        catch (...) {
+            this->FireGlobal<event::AsyncExceptionEvent>(
+                "Unknown exception in async event loop.");
+        }
+
+        // [!! 新增 !!] 追踪：异步执行结束
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kQueuedExecuteEnd, traced_id,
+                traced_event);
+        }
+    }
+
+    // --- [!! 新增 !!] 串行执行器 (Strand) ---
+
+    /**
+     * @brief [!! 新增 !!] 获取 (或创建) 订阅者的 strand。
+     * @details 同一订阅者对象的所有 kQueuedOrdered 订阅共享一个 strand，
+     * 因此它的回调 (跨事件类型、跨发送者) 都按发布顺序执行。
+     */
+    std::shared_ptr<PluginManager::EventStrand>
+        PluginManager::GetSubscriberStrand(
+            const std::weak_ptr<void>& subscriber) {
+        auto& strand = subscriber_strands_[subscriber];
+        if (!strand) {
+            strand = std::make_shared<EventStrand>();
+        }
+        return strand;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 向 strand 投递任务。
+     * @details 只有当 strand 当前没有被调度时才投递一次排空任务，
+     * 因此同一 strand 的任务永远不会在两个工作线程上同时执行。
+     */
+    void PluginManager::PostToStrand(const std::shared_ptr<EventStrand>& strand,
+        EventPriority priority, EventTask task) {
+        if (t_stats_entry && !task.StatsEntry()) {
+            task.Stamp(t_stats_entry, EventStatsTable::NowNanoseconds());
+        }
+        StampTrace(task);
+        EventPriority lane;
+        {
+            std::unique_lock<std::mutex> lock(strand->mutex);
+            if (strand->successor) {
+                // [!! 新增 !!] 已被隔离 strand 取代：转投，保持投递顺序
+                std::shared_ptr<EventStrand> successor = strand->successor;
+                lock.unlock();
+                PostToStrand(successor, priority, std::move(task));
+                return;
+            }
+            strand->pending.push_back(std::move(task));
+            // [!! 新增 !!] strand 内必须保持 FIFO，因此排空任务按
+            // 待处理任务中的最高优先级调度 (低优先级任务随之“提速”)
+            if (priority > strand->lane) {
+                strand->lane = priority;
+            }
+            if (strand->scheduled) {
+                return;
+            }
+            strand->scheduled = true;
+            lane = strand->lane;
+        }
+        // [!! 新增 !!] 排空任务不属于任何事件 (strand 内的任务各自带有入队时间与追踪戳)
+        StatsEntryScope no_stats(nullptr);
+        TraceContextScope no_trace(nullptr);
+        ScheduleStrandDrain(strand, lane);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 排空 strand。
+     * @details 每次最多执行 kStrandBatch 个任务，之后若仍有剩余则重新入队，
+     * 避免一个繁忙的订阅者长期独占工作线程。
+     * 每个任务单独经过 RunEventTask，异常不会中断排空。
+     */
+    void PluginManager::DrainStrand(const std::shared_ptr<EventStrand>& strand) {
+        constexpr size_t kStrandBatch = 64;
+
+        for (size_t i = 0; i < kStrandBatch; ++i) {
+            EventTask task;
+            {
+                std::lock_guard<std::mutex> lock(strand->mutex);
+                if (strand->pending.empty()) {
+                    strand->scheduled = false;
+                    strand->lane = EventPriority::kLow;
+                    return;
+                }
+                task = std::move(strand->pending.front());
+                strand->pending.pop_front();
+            }
+            RunEventTask(task);
+        }
+
+        EventPriority lane;
+        {
+            std::lock_guard<std::mutex> lock(strand->mutex);
+            if (strand->pending.empty()) {
+                strand->scheduled = false;
+                strand->lane = EventPriority::kLow;
+                return;
+            }
+            lane = strand->lane;
+        }
+        // 仍有剩余：保持 scheduled，让出线程后继续
+        ScheduleStrandDrain(strand, lane);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 调度 strand 的排空任务。
+     * @details isolated 在 strand 发布前设置且之后不变，无需加锁读取。
+     */
+    void PluginManager::ScheduleStrandDrain(
+        const std::shared_ptr<EventStrand>& strand, EventPriority lane) {
+        if (strand->isolated) {
+            PostIsolatedTask([this, strand]() { DrainStrand(strand); });
+            return;
+        }
+        EnqueueEventTask([this, strand]() { DrainStrand(strand); }, lane);
+    }
+
+    // --- [!! 新增 !!] 慢回调看门狗 ---
+
+    /**
+     * @brief [!! 新增 !!] 记录一次超时；按策略降级订阅者，再发布 SlowCallbackEvent。
+     * @details 在超时回调所在的线程上、回调返回之后执行。
+     * 插件路径只在订阅者第一次超时时查找 (需要 registry_mutex_)。
+     */
+    void PluginManager::ReportSlowCallback(const Subscription& sub,
+        uint64_t elapsed_ns) {
+        const std::weak_ptr<void>& subscriber = sub.subscriber_id;
+        std::string plugin_path;
+        bool known = false;
+        {
+            std::lock_guard<std::mutex> lock(watchdog_mutex_);
+            auto it = slow_subscribers_.find(subscriber);
+            if (it != slow_subscribers_.end()) {
+                plugin_path = it->second.source_plugin_path;
+                known = true;
+            }
+        }
+        if (!known) {
+            plugin_path = FindSubscriberPlugin(subscriber);
+        }
+
+        uint64_t overruns = 0;
+        bool demoted = false;
+        {
+            std::lock_guard<std::mutex> lock(watchdog_mutex_);
+            auto it = slow_subscribers_.find(subscriber);
+            if (it == slow_subscribers_.end()) {
+                // 新记录：顺带剔除已析构订阅者的记录
+                for (auto stale = slow_subscribers_.begin();
+                    stale != slow_subscribers_.end();) {
+                    stale = stale->first.expired()
+                        ? slow_subscribers_.erase(stale) : std::next(stale);
+                }
+                it = slow_subscribers_.emplace(subscriber, SlowSubscriberStats()).first;
+                it->second.subscriber = subscriber;
+                it->second.source_plugin_path = plugin_path;
+            }
+            SlowSubscriberStats& record = it->second;
+            record.last_event_id = sub.event_id;
+            record.max_duration_ns = std::max(record.max_duration_ns, elapsed_ns);
+            overruns = ++record.overruns;
+            demoted = record.demoted;
+        }
+
+        const uint32_t demote_after = options_.slow_callback_demote_after;
+        if (!demoted && demote_after != 0 && overruns >= demote_after &&
+            DemoteSubscriber(subscriber)) {
+            demoted = true;
+            std::lock_guard<std::mutex> lock(watchdog_mutex_);
+            auto it = slow_subscribers_.find(subscriber);
+            if (it != slow_subscribers_.end()) {
+                it->second.demoted = true;
+            }
+        }
+
+        FireGlobal<event::SlowCallbackEvent>(subscriber, sub.event_id,
+            std::chrono::nanoseconds(elapsed_ns),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                options_.slow_callback_budget),
+            std::move(plugin_path), overruns, demoted);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 把订阅者的 kQueued / kQueuedOrdered 订阅改为经
+     * 隔离 strand 顺序执行，kQueuedCoalesced 订阅的投递任务改投隔离通道；
+     * 它们都降为 kLow。kDirect 与宿主调度器订阅不受影响
+     * (在发布者线程 / 宿主线程上执行)。
+     * @details 隔离 strand 排在旧 strand 之后：旧 strand 中尚未执行的任务
+     * 先在工作线程池上按原顺序执行完，隔离 strand 才开始排空，
+     * 之后投递到旧 strand 的任务转投隔离 strand，因此 kQueuedOrdered 的
+     * FIFO 在降级前后保持不变。已在工作线程池中排队的 kQueued 任务
+     * (本来就不保证顺序) 照常执行，可能与隔离通道上的新任务短暂并行。
+     */
+    bool PluginManager::DemoteSubscriber(const std::weak_ptr<void>& subscriber) {
+        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+        auto global_it = global_sub_lookup_.find(subscriber);
+        auto sender_it = sender_sub_lookup_.find(subscriber);
+        if (global_it == global_sub_lookup_.end() &&
+            sender_it == sender_sub_lookup_.end()) {
+            return false;  // 已退订或已失效
+        }
+        std::shared_ptr<EventStrand>& strand = subscriber_strands_[subscriber];
+        if (strand && strand->isolated) {
+            return false;
+        }
+        std::shared_ptr<EventStrand> previous = std::move(strand);
+        strand = std::make_shared<EventStrand>();
+        strand->isolated = true;
+        if (previous) {
+            std::lock_guard<std::mutex> previous_lock(previous->mutex);
+            previous->successor = strand;
+            if (previous->scheduled) {
+                // 旧 strand 还有任务：隔离 strand 保持 scheduled (只入队不排空)，
+                // 由排在旧任务之后的屏障任务启动它的排空
+                strand->scheduled = true;
+                previous->pending.push_back([this, isolated = strand]() {
+                    ScheduleStrandDrain(isolated, EventPriority::kLow);
+                    });
+            }
+        }
+
+        // [!! COW !!] 复制含有该订阅者的列表，改写后重新发布
+        auto demote = [&](const EventCallbackList& list) {
+            EventCallbackList copy = list;
+            for (Subscription& sub : copy) {
+                if (!sub.subscriber_id.owner_before(subscriber) &&
+                    !subscriber.owner_before(sub.subscriber_id)) {
+                    ApplySubscriberIsolation(sub);
+                }
+            }
+            return copy;
+            };
+
+        if (global_it != global_sub_lookup_.end()) {
+            for (const EventId event_id : global_it->second) {
+                EventMapPtr globals = global_subscribers_.Load();
+                auto list_it = globals->find(event_id);
+                if (list_it != globals->end()) {
+                    PublishGlobalList(event_id, demote(*list_it->second));
+                }
+            }
+        }
+        if (sender_it != sender_sub_lookup_.end()) {
+            for (const auto& pair : sender_it->second) {
+                std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+                if (const CallbackListPtr* current =
+                    senders->Find(pair.first, pair.second)) {
+                    PublishSenderList(pair.first, pair.second, demote(**current));
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 订阅者已被降级时，把订阅改为走隔离通道。
+     */
+    void PluginManager::ApplySubscriberIsolation(Subscription& sub) {
+        // 调度器订阅必须留在宿主线程上
+        if (sub.connection_type == ConnectionType::kDirect || sub.dispatcher) {
+            return;
+        }
+        auto it = subscriber_strands_.find(sub.subscriber_id);
+        if (it == subscriber_strands_.end() || !it->second->isolated) {
+            return;
+        }
+        sub.isolated = true;
+        sub.priority = EventPriority::kLow;
+        if (sub.connection_type != ConnectionType::kQueuedCoalesced) {
+            sub.connection_type = ConnectionType::kQueuedOrdered;
+            sub.strand = it->second;
+        }
+    }
+
+    /**
+     * @brief [!! 新增 !!] 投递任务到隔离通道。
+     */
+    void PluginManager::PostIsolatedTask(EventTask task) {
+        {
+            std::lock_guard<std::mutex> lock(isolated_mutex_);
+            if (isolated_stopping_) {
+                return;
+            }
+            isolated_tasks_.push_back(std::move(task));
+            if (!isolated_thread_.joinable()) {
+                isolated_thread_ = std::thread(&PluginManager::IsolatedLoop, this);
+            }
+        }
+        isolated_cv_.notify_one();
+    }
+
+    /**
+     * @brief [!! 新增 !!] 隔离线程：逐个执行降级订阅者的任务。
+     */
+    void PluginManager::IsolatedLoop() {
+        if (options_.slow_callback_budget.count() > 0) {
+            t_watchdog_owner = this;
+        }
+        std::unique_lock<std::mutex> lock(isolated_mutex_);
+        while (true) {
+            isolated_cv_.wait(lock, [this]() {
+                return isolated_stopping_ || !isolated_tasks_.empty();
+                });
+            if (isolated_stopping_) {
+                return;
+            }
+            EventTask task = std::move(isolated_tasks_.front());
+            isolated_tasks_.pop_front();
+            lock.unlock();
+            RunEventTask(task);
+            task = nullptr;  // 在锁外释放捕获的事件与订阅列表
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief 事件循环工作线程的主函数。
+     *
+     * ... (Fix 6 日志) ...
+     * [!! 修改 !!] 现在由 options_.event_worker_count 个线程共同运行；
+     * 任意线程都可以领取 GC 时间片 (RequestGarbageCollection)。
+     */
+    void PluginManager::EventLoop(size_t worker_index) {
+        t_worker_owner = this;
+        t_worker_index = worker_index;
+        if (options_.slow_callback_budget.count() > 0) {
+            t_watchdog_owner = this;  // [!! 新增 !!] 看门狗
+        }
+
+        // [!! 修改 !!] 纯事件驱动：没有任务、也没有 GC 请求时无限期休眠，
+        // 不再每 50ms 醒来一次。
+        while (true) {
+            // --- 0. [!! 新增 !!] 到期的定时器 (协程超时等) ---
+            if (IsTimerDue()) {
+                RunDueTimers();
+                continue;
+            }
+
+            // --- 1. 垃圾回收 (GC) 时间片 ---
+            // 在任务之间检查，因此持续负载下 GC 也不会饿死；
+            // 每个时间片有预算，不会长期占用工作线程。
+            if (gc_requested_.load(std::memory_order_relaxed) &&
+                gc_requested_.exchange(false, std::memory_order_acq_rel)) {
+                RunGarbageCollectionSlice();
+                continue;
+            }
+
+            // --- 2. 异步事件 (EventTask) ---
+            EventTask task_to_run;
+            if (TryDequeueEventTask(worker_index, task_to_run)) {
+                RunEventTask(task_to_run);
+                continue;
+            }
+
+            // --- 3. 休眠 ---
+            // EventCount 等待：先登记，再复查，最后才睡眠，
+            // 因此不会丢失唤醒，发布者在没有空闲线程时也无需进入内核。
+            EventCount::Key key = work_available_.PrepareWait();
+            if (gc_requested_.load(std::memory_order_relaxed) ||
+                IsTimerDue() ||
+                TryDequeueEventTask(worker_index, task_to_run)) {
+                work_available_.CancelWait();
+                if (task_to_run) {
+                    RunEventTask(task_to_run);
+                }
+                continue;
+            }
+            if (!running_.load(std::memory_order_acquire)) {
+                // 析构函数已发出停止信号，
+                // 并且所有队列已清空，
+                // 安全退出线程。
+                work_available_.CancelWait();
+                return;
+            }
+
+            // [!! 新增 !!] 有定时器时，由一个空闲线程 (keeper) 等到最早的到期时刻，
+            // 其余线程照常无限期休眠
+            const int64_t deadline =
+                next_timer_deadline_.load(std::memory_order_acquire);
+            if (deadline != kNoTimer &&
+                !timer_keeper_claimed_.exchange(true, std::memory_order_acq_rel)) {
+                const auto now = std::chrono::steady_clock::now()
+                    .time_since_epoch();
+                work_available_.WaitFor(key, std::chrono::nanoseconds(deadline) -
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now));
+                timer_keeper_claimed_.store(false, std::memory_order_release);
+                // 若是被任务唤醒 (而非到期)，交给另一个空闲线程继续看守
+                if (!IsTimerDue() && next_timer_deadline_.load(
+                    std::memory_order_acquire) != kNoTimer) {
+                    work_available_.NotifyOne();
+                }
+            }
+            else {
+                work_available_.Wait(key);
+            }
+        }
+    }
+
+    // --- [!! 新增 !!] 定时器 (Timers) ---
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 登记一个一次性定时器。
+     * @details 新定时器成为最早到期者时唤醒所有空闲线程，
+     * 让 keeper 按新的到期时刻重新等待。
+     */
+    void PluginManager::ScheduleTimerImpl(std::chrono::nanoseconds delay,
+        std::weak_ptr<void> owner,
+        EventDelegate cb) {
+        if (delay >= kTimerUntilCleared) {
+            // [!! 新增 !!] 永不到期：只在清空注册表时触发；
+            // 等待结束后 owner 失效，超过阈值时批量剔除
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            if (clear_only_timers_.size() >= clear_only_timers_purge_at_) {
+                clear_only_timers_.erase(std::remove_if(clear_only_timers_.begin(),
+                    clear_only_timers_.end(), [](const EventTimer& timer) {
+                        return timer.owner.expired();
+                    }), clear_only_timers_.end());
+                clear_only_timers_purge_at_ =
+                    std::max<size_t>(64, clear_only_timers_.size() * 2);
+            }
+            clear_only_timers_.push_back({ std::chrono::steady_clock::time_point::max(),
+                timer_sequence_++, std::move(owner), std::move(cb) });
+            return;
+        }
+        const auto deadline = std::chrono::steady_clock::now() +
+            std::max(delay, std::chrono::nanoseconds::zero());
+        const int64_t deadline_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline.time_since_epoch()).count();
+
+        bool earliest = false;
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            timers_.push({ deadline, timer_sequence_++, std::move(owner),
+                std::move(cb) });
+            if (deadline_ns < next_timer_deadline_.load(std::memory_order_relaxed)) {
+                next_timer_deadline_.store(deadline_ns, std::memory_order_release);
+                earliest = true;
+            }
+        }
+        if (earliest) {
+            work_available_.NotifyAll();
+        }
+    }
+
+    /**
+     * @brief [!! 新增 !!] 最早的定时器是否已到期。
+     */
+    bool PluginManager::IsTimerDue() const {
+        const int64_t deadline =
+            next_timer_deadline_.load(std::memory_order_acquire);
+        if (deadline == kNoTimer) {
+            return false;
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count() >=
+            deadline;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 执行所有已到期的定时器。
+     * @details 先在锁内摘下到期项，再逐个经由 RunEventTask 执行
+     * (与异步回调一样转发异常)；owner 已析构的定时器直接丢弃。
+     */
+    void PluginManager::RunDueTimers() {
+        std::vector<EventTimer> due;
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            const auto now = std::chrono::steady_clock::now();
+            while (!timers_.empty() && timers_.top().deadline <= now) {
+                due.push_back(std::move(const_cast<EventTimer&>(timers_.top())));
+                timers_.pop();
+            }
+            next_timer_deadline_.store(timers_.empty() ? kNoTimer :
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    timers_.top().deadline.time_since_epoch()).count(),
+                std::memory_order_release);
+        }
+
+        for (EventTimer& timer : due) {
+            std::shared_ptr<void> target = timer.owner.lock();
+            if (!target) {
+                continue;
+            }
+            const event::TimerElapsedEvent elapsed(timer.deadline);
+            EventTask task = [&timer, &target, &elapsed]() {
+                timer.callback(target.get(), elapsed);
+                };
+            RunEventTask(task);
+        }
+    }
+
+    /**
+     * @details 到期顺序与 RunDueTimers 相同 (永不到期的排在最后)。
+     * 定时器回调可能登记新的定时器 (例如恢复的协程再次等待)，
+     * 因此反复摘取，直到没有定时器 (最多 kMaxRounds 轮，之后剩余的直接丢弃)。
+     */
+    void PluginManager::FireAllTimersForClear() {
+        constexpr int kMaxRounds = 16;
+        for (int round = 0; round < kMaxRounds; ++round) {
+            std::vector<EventTimer> pending;
+            {
+                std::lock_guard<std::mutex> lock(timer_mutex_);
+                while (!timers_.empty()) {
+                    pending.push_back(std::move(const_cast<EventTimer&>(timers_.top())));
+                    timers_.pop();
+                }
+                std::move(clear_only_timers_.begin(), clear_only_timers_.end(),
+                    std::back_inserter(pending));
+                clear_only_timers_.clear();
+                next_timer_deadline_.store(kNoTimer, std::memory_order_release);
+            }
+            if (pending.empty()) {
+                return;
+            }
+            for (EventTimer& timer : pending) {
+                std::shared_ptr<void> target = timer.owner.lock();
+                if (!target) {
+                    continue;
+                }
+                const event::TimerElapsedEvent elapsed(timer.deadline);
+                EventTask task = [&timer, &target, &elapsed]() {
+                    timer.callback(target.get(), elapsed);
+                    };
+                RunEventTask(task);
+            }
+        }
+    }
+
+
+    // --- [!! 新增 !!] 分发循环 (所有发布路径共用) ---
+
+    namespace {
+        /**
+         * @brief 以 kErrorEventQueueFull 结束一个未执行就被丢弃的任务。
+         */
+        void CompleteDiscarded(EventCompletion& completion) noexcept {
+            try {
+                completion.AddError(std::make_exception_ptr(PluginException(
+                    InstanceError::kErrorEventQueueFull,
+                    "Async event task was discarded before it ran.")));
+            }
+            catch (...) {
+                // 内存不足时只保证完成，不记录原因
+            }
+            completion.Complete();
+        }
+
+        /**
+         * @brief 异步任务在完成句柄上持有的一个计数。
+         * @details 任务执行后调用 Finish；任务未执行就被销毁时
+         * (溢出策略丢弃、关闭时清空队列)，以 kErrorEventQueueFull 结束，
+         * 保证句柄总能完成。
+         */
+        class CompletionToken {
+        public:
+            explicit CompletionToken(const PluginPtr<EventCompletion>& completion)
+                : completion_(completion) {
+                completion_->AddPending(1);
+            }
+
+            CompletionToken(CompletionToken&&) noexcept = default;
+            CompletionToken& operator=(CompletionToken&&) = delete;
+
+            ~CompletionToken() {
+                if (completion_) {
+                    CompleteDiscarded(*completion_);
+                }
+            }
+
+            EventCompletion* operator->() const { return completion_.get(); }
+
+            void Finish() {
+                completion_->Complete();
+                completion_.reset();
+            }
+
+        private:
+            PluginPtr<EventCompletion> completion_;
+        };
+
+        /**
+         * @brief 生成一个投递任务：deliver(errors) 执行投递。
+         * @details completion 为空时 errors 为 nullptr，回调的异常照常传播；
+         * 否则任务持有一个 CompletionToken，异常记录到句柄上。
+         */
+        template <typename TDeliver>
+        EventTask MakeDeliveryTask(const PluginPtr<EventCompletion>& completion,
+            TDeliver deliver) {
+            if (!completion) {
+                return EventTask([deliver = std::move(deliver)]() mutable {
+                    deliver(nullptr);
+                    });
+            }
+            return EventTask([deliver = std::move(deliver),
+                token = CompletionToken(completion)]() mutable {
+                    deliver(token.operator->());
+                    token.Finish();
+                });
+        }
+    }  // namespace
+
+    /**
+     * @details errors 不为空时逐个订阅捕获异常 (一个回调失败不会跳过其余回调)。
+     */
+    template <typename TPayload>
+    void PluginManager::InvokeReporting(EventCompletion* errors,
+        const Subscription& sub, const TPayload& payload) {
+        if (!errors) {
+            InvokeSubscription(sub, payload);
+            return;
+        }
+        try {
+            InvokeSubscription(sub, payload);
+        }
+        catch (...) {
+            errors->AddError(std::current_exception());
+        }
+    }
+
+    const PluginPtr<Event>* PluginManager::PayloadFor(const Subscription& sub,
+        const PluginPtr<Event>& e_ptr, PluginPtr<Event>&) {
+        return sub.Accepts(*e_ptr) ? &e_ptr : nullptr;
+    }
+
+    const PluginPtr<EventBatch>* PluginManager::PayloadFor(
+        const Subscription& sub, const PluginPtr<EventBatch>& batch,
+        PluginPtr<EventBatch>& filtered) {
+        if (!sub.filter) {
+            return &batch;
+        }
+        filtered = FilterBatch(sub, batch);
+        return filtered ? &filtered : nullptr;
+    }
+
+    void PluginManager::PostCoalescedPayload(const CallbackListPtr& subs,
+        const Subscription& sub, const PluginPtr<Event>& e_ptr,
+        const PluginPtr<EventCompletion>& completion) {
+        PostCoalesced(subs, sub, e_ptr, completion);
+    }
+
+    void PluginManager::PostCoalescedPayload(const CallbackListPtr& subs,
+        const Subscription& sub, const PluginPtr<EventBatch>& batch,
+        const PluginPtr<EventCompletion>& completion) {
+        // 整批只保留最后一个事件 (别名指针共享批次的引用计数)
+        const size_t count = batch->Size();
+        queue_coalesced_.fetch_add(count - 1, std::memory_order_relaxed);
+        PostCoalesced(subs, sub,
+            PluginPtr<const Event>(batch, &batch->At(count - 1)), completion);
+    }
+
+    /**
+     * @details
+     * - kDirect 订阅在发布者线程上直接调用；
+     * - 宿主调度器、kQueuedOrdered、kQueuedCoalesced 与带过滤器的 kQueued
+     * 订阅各自投递 (TPayload 为批次时，过滤后的子批次只投递给该订阅)；
+     * - 其余 kQueued 订阅共享异步任务 (扇出较大时拆成多个)。
+     * 每个任务捕获 subs 快照，sub_ptr 在任务执行前保持有效。
+     * completion 不为空时每个任务持有一个计数；发布者自身的计数在返回
+     * (或 kDirect 回调抛出) 时释放。
+     * kDirect 回调抛出时不再调用之后的 kDirect 订阅，但其余订阅照常投递，
+     * 全部入队之后才把异常重新抛给发布者。
+     */
+    template <typename TPayload>
+    void PluginManager::DispatchToList(EventId event_id,
+        const CallbackListPtr& subs, bool check_sender_also,
+        const PluginPtr<TPayload>& payload,
+        const PluginPtr<EventCompletion>& completion, bool traced) {
+        struct PublisherCount {
+            const PluginPtr<EventCompletion>& completion;
+            ~PublisherCount() {
+                if (completion) {
+                    completion->Complete();
+                }
+            }
+        } publisher_count{ completion };
+
+        void* event_ptr = payload.get(); // 获取原始指针用于追踪
+        // [!! 新增 !!] 本次分发投递的任务携带追踪戳；未被采样时遮蔽外层发布
+        const TraceContext trace_context{ event_id, event_ptr };
+        TraceContextScope trace_scope(traced ? &trace_context : nullptr);
+        size_t queued_count = 0;  // 共享任务中的订阅数 (并行扇出)
+        // 共享任务取其中最高的优先级，不会把高优先级订阅放进低优先级通道
+        EventPriority queued_priority = EventPriority::kLow;
+        bool saw_expired = false;
+        size_t fan_out = 0;  // 统计：本次投递到的订阅数
+        std::exception_ptr direct_error;  // 第一个抛出的 kDirect 回调
+        for (const auto& sub : *subs) {
+            if (IsSubscriptionExpired(sub, check_sender_also)) {
+                // [!! COW !!] 不能就地删除，交给事件循环清理
+                saw_expired = true;
+                continue;
+            }
+            // 过滤器在发布者线程上、入队之前执行
+            PluginPtr<TPayload> filtered;
+            const PluginPtr<TPayload>* delivered = PayloadFor(sub, payload, filtered);
+            if (!delivered) {
+                continue;
+            }
+            ++fan_out;
+            const Subscription* sub_ptr = &sub;
+            auto single_task = [&]() {
+                return MakeDeliveryTask(completion,
+                    [payload = *delivered, subs, sub_ptr](EventCompletion* errors) {
+                        InvokeReporting(errors, *sub_ptr, *payload);
+                    });
+                };
+            if (sub.dispatcher) {
+                // 直接放入宿主调度器的收件箱
+                PostToDispatcher(sub, single_task());
+                continue;
+            }
+            if (sub.connection_type == ConnectionType::kQueuedOrdered) {
+                // 在发布者线程上按发布顺序投递到 strand
+                PostToStrand(sub.strand, sub.priority, single_task());
+                continue;
+            }
+            if (sub.connection_type == ConnectionType::kQueuedCoalesced) {
+                PostCoalescedPayload(subs, sub, *delivered, completion);
+                continue;
+            }
+            if (sub.filter && sub.connection_type == ConnectionType::kQueued) {
+                // 已通过过滤的订阅单独投递，共享任务跳过它
+                EnqueueEventTask(single_task(), sub.priority);
+                continue;
+            }
+            if (sub.connection_type != ConnectionType::kDirect) {
+                ++queued_count;
+                queued_priority = (std::max)(queued_priority, sub.priority);
+                continue;
+            }
+            if (direct_error) {
+                continue;
+            }
+            // 追踪：同步调用开始
+            if (traced) {
+                event_trace_.Record(EventTracePoint::kDirectCallStart, event_id, event_ptr);
+            }
+            try {
+                InvokeSubscription(sub, **delivered);
+            }
+            catch (...) {
+                direct_error = std::current_exception();
+            }
+            if (traced) {
+                event_trace_.Record(EventTracePoint::kDirectCallEnd, event_id, event_ptr);
+            }
+        }
+        RecordFanOut(fan_out);
+        if (saw_expired) {
+            RequestExpiredSweep();
+        }
+
+        if (queued_count != 0) {
+            if (traced) {
+                event_trace_.Record(EventTracePoint::kQueuedEntry, event_id, event_ptr);
+            }
+
+            // 扇出较大时拆成多个任务并行执行，每块持有自己的完成计数
+            EnqueueSharedFanOut(subs, check_sender_also, queued_count,
+                queued_priority,
+                [&payload, &subs, &completion](size_t begin, size_t end) {
+                    return MakeDeliveryTask(completion,
+                        [payload, subs, begin, end](EventCompletion* errors) {
+                            for (size_t i = begin; i < end; ++i) {
+                                const Subscription& sub = (*subs)[i];
+                                if (IsSharedQueued(sub)) {
+                                    InvokeReporting(errors, sub, *payload);
+                                }
+                            }
+                        });
+                });
+        }
+
+        if (direct_error) {
+            std::rethrow_exception(direct_error);
+        }
+    }
+
+    // --- 2. 全局事件 (Global Events) ---
+
+    /**
+     * @brief [IEventBus 内部实现] 订阅一个全局事件。
+     *
+     * [修改]
+     * 参数 'type'
+     * 已重命名为 'event_id'
+     * (类型已从 ClassId
+     * 更改为 EventId)。
+     */
+    void PluginManager::SubscribeGlobalImpl(
+        EventId event_id,                       // <-- [修改]
+        std::weak_ptr<void> sub,              // 订阅者
+        std::function<void(const Event&)> cb,
+        ConnectionType connection_type) {
+        // [!! 修改 !!] 1.0 兼容入口：把 std::function 装入委托
+        AddGlobalSubscription(event_id,
+            { std::move(sub), std::weak_ptr<void>(),
+             WrapLegacyCallback(std::move(cb)), nullptr, connection_type,
+             nullptr });
+    }
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 订阅一个全局事件并返回连接状态。
+     */
+    PluginPtr<EventConnectionState> PluginManager::SubscribeGlobalConnectedImpl(
+        EventId event_id,
+        std::weak_ptr<void> sub,
+        EventDelegate cb,
+        EventBatchDelegate batch_cb,
+        EventFilterDelegate filter,
+        ConnectionType connection_type) {
+        Subscription subscription{ std::move(sub), std::weak_ptr<void>(),
+            std::move(cb), std::move(batch_cb), connection_type, nullptr };
+        subscription.filter = std::move(filter);
+        PluginPtr<EventConnectionState> connection =
+            AttachConnection(subscription);
+        AddGlobalSubscription(event_id, std::move(subscription));
+        return connection;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 追加一条全局订阅并发布新快照。
+     */
+    void PluginManager::AddGlobalSubscription(EventId event_id,
+        Subscription sub) {
+        if (IsDispatcherConnection(sub.connection_type)) {
+            sub.dispatcher = ResolveDispatcher(sub.connection_type);  // [!! 新增 !!]
+        }
+        std::unique_lock<std::recursive_mutex> lock(event_mutex_);
+
+        // 1. [!! COW !!] 复制当前列表，顺带剔除失效订阅
+        EventCallbackList list;
+        EventMapPtr globals = global_subscribers_.Load();
+        auto it = globals->find(event_id);
+        if (it != globals->end()) {
+            list = *it->second;
+            CleanupExpiredSubscriptions(list, false, gc_queue_);
+            if (!gc_queue_.empty()) {
+                RequestGarbageCollection();
+            }
+        }
+
+        // 2. [Fix 4] 添加到反向查找表
+        // [修改] 插入 event_id
+        // Note: global_sub_lookup_ is std::map
+        global_sub_lookup_[sub.subscriber_id].insert(event_id);
+        if (sub.connection) {
+            sub.connection->global_keys.push_back(event_id);
+        }
+
+        // 3. 追加并发布新快照
+        if (sub.connection_type == ConnectionType::kQueuedOrdered) {
+            sub.strand = GetSubscriberStrand(sub.subscriber_id);
+        }
+        else if (sub.connection_type == ConnectionType::kQueuedCoalesced) {
+            sub.coalesce = std::make_shared<EventCoalesceSlot>();
+        }
+        sub.priority = LookupEventPriority(event_id);
+        sub.event_id = event_id;
+        ApplySubscriberIsolation(sub);  // [!! 新增 !!]
+        PropagateCategorySubscription(nullptr, sub);  // [!! 新增 !!] 后代事件
+        list.push_back(std::move(sub));
+        PublishGlobalList(event_id, std::move(list));
+
+        // 4. [!! 新增 !!] 重放保留事件。发布之后再读取：此后的 Fire 必然看到
+        //    新订阅，因此不会漏掉比重放值更新的事件 (至多重复收到一次)
+        PluginPtr<const Event> retained =
+            FindRetainedEvent(event_id, nullptr, std::weak_ptr<void>());
+        if (!retained) {
+            return;
+        }
+        CallbackListPtr subs = global_subscribers_.Load()->at(event_id);
+        lock.unlock();
+        if (subs->back().Accepts(*retained)) {
+            DeliverToSubscription(subs, subs->back(), retained);
+        }
+    }
+
+    /**
+     * @brief [IEventBus 内部实现] 发布一个全局事件。
+     *
+     * ... (Fix 5/6 日志) ...
+     *
+     * [修改]
+     * 参数 'type'
+     * 已重命名为 'event_id'
+     * (类型已从 ClassId
+     * 更改为 EventId)。
+     */
+    void PluginManager::FireGlobalImpl(EventId event_id,
+        PluginPtr<Event> e_ptr)  // <-- [修改]
+    {
+        void* event_ptr = e_ptr.get(); // 获取原始指针用于追踪
+
+        // [!! 新增 !!] 追踪：事件发布开始
+        // [!! 修改 !!] 采样结果决定本次发布的所有追踪点 (关闭时只是一次原子读取)
+        const bool traced = event_trace_.Sample();
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kEventFired, event_id, event_ptr);
+        }
+        // [!! 新增 !!] 统计：本次发布的条目 (未开启时为空)，结束后恢复外层发布的条目
+        StatsEntryScope stats_scope(BeginFireStats(event_stats_, event_id));
+
+        // [!! COW !!] 读取快照 (不取 event_mutex_)；快照在本函数 (及异步任务)
+        // 持有期间保持不变，无需拷贝任何回调。
+        CallbackListPtr subs;
+        {
+            EventMapPtr globals = global_subscribers_.Load();
+            // [修改] 使用 event_id 查找
+            auto it = globals->find(event_id);
+            if (it == globals->end()) {
+                return;
+            }
+            subs = it->second;
+        }
+
+        // 4. [!! 修改 !!] 同步调用 kDirect 订阅，其余按连接方式入队
+        DispatchToList(event_id, subs, false, e_ptr, nullptr, traced);
+    }
+
+    // --- 3. 实例事件 (Sender-Specific Events) ---
+
+    /**
+     * @brief [IEventBus 内部实现] 订阅一个特定发送者的事件。
+     *
+     * [修改]
+     * ... (同上, 切换到 EventId) ...
+     */
+    void PluginManager::SubscribeToSenderImpl(
+        void* sender_key,
+        EventId event_id,  // <-- [修改]
+        std::weak_ptr<void> sub_id,              // 订阅者
+        std::weak_ptr<void> sender_id,           // 发送者 (用于清理)
+        std::function<void(const Event&)> cb,
+        ConnectionType connection_type) {
+        // [!! 修改 !!] 1.0 兼容入口：把 std::function 装入委托
+        AddSenderSubscription(sender_key, event_id,
+            { std::move(sub_id), std::move(sender_id),
+             WrapLegacyCallback(std::move(cb)), nullptr, connection_type,
+             nullptr });
+    }
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 订阅一个特定发送者的事件并返回连接状态。
+     */
+    PluginPtr<EventConnectionState> PluginManager::SubscribeToSenderConnectedImpl(
+        void* sender_key,
+        EventId event_id,
+        std::weak_ptr<void> sub_id,
+        std::weak_ptr<void> sender_id,
+        EventDelegate cb,
+        EventBatchDelegate batch_cb,
+        EventFilterDelegate filter,
+        ConnectionType connection_type) {
+        Subscription subscription{ std::move(sub_id), std::move(sender_id),
+            std::move(cb), std::move(batch_cb), connection_type, nullptr };
+        subscription.filter = std::move(filter);
+        PluginPtr<EventConnectionState> connection =
+            AttachConnection(subscription);
+        AddSenderSubscription(sender_key, event_id, std::move(subscription));
+        return connection;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 追加一条发送者订阅并发布新快照。
+     */
+    void PluginManager::AddSenderSubscription(void* sender_key,
+        EventId event_id, Subscription sub) {
+        if (IsDispatcherConnection(sub.connection_type)) {
+            sub.dispatcher = ResolveDispatcher(sub.connection_type);  // [!! 新增 !!]
+        }
+        std::unique_lock<std::recursive_mutex> lock(event_mutex_);
+
+        // 1. [!! COW !!] 复制当前列表，顺带剔除失效订阅
+        EventCallbackList list;
+        std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+        if (const CallbackListPtr* current = senders->Find(sender_key, event_id)) {
+            list = **current;
+            CleanupExpiredSubscriptions(list, true, gc_queue_);
+            if (!gc_queue_.empty()) {
+                RequestGarbageCollection();
+            }
+        }
+
+        // 2. [Fix 4] 添加到反向查找表
+        // [修改] 插入 event_id
+        // Note: sender_sub_lookup_ is std::map
+        sender_sub_lookup_[sub.subscriber_id].insert({ sender_key, event_id });
+        if (sub.connection) {
+            sub.connection->sender_keys.emplace_back(sender_key, event_id);
+        }
+
+        // 3. 追加并发布新快照
+        if (sub.connection_type == ConnectionType::kQueuedOrdered) {
+            sub.strand = GetSubscriberStrand(sub.subscriber_id);
+        }
+        else if (sub.connection_type == ConnectionType::kQueuedCoalesced) {
+            sub.coalesce = std::make_shared<EventCoalesceSlot>();
+        }
+        sub.priority = LookupEventPriority(event_id);
+        sub.event_id = event_id;
+        ApplySubscriberIsolation(sub);  // [!! 新增 !!]
+        PropagateCategorySubscription(sender_key, sub);  // [!! 新增 !!] 后代事件
+        std::weak_ptr<void> sender_id = sub.sender_id;
+        list.push_back(std::move(sub));
+        PublishSenderList(sender_key, event_id, std::move(list));
+
+        // 4. [!! 新增 !!] 重放保留事件 (同 AddGlobalSubscription)
+        PluginPtr<const Event> retained =
+            FindRetainedEvent(event_id, sender_key, sender_id);
+        if (!retained) {
+            return;
+        }
+        CallbackListPtr subs =
+            *sender_subscribers_.Load()->Find(sender_key, event_id);
+        lock.unlock();
+        if (subs->back().Accepts(*retained)) {
+            DeliverToSubscription(subs, subs->back(), retained);
+        }
+    }
+
+    /**
+     * @brief [IEventBus 内部实现] 发布一个特定发送者的事件。
+     *
+     * ... (Fix 6, EventId 修改日志) ...
+     */
+    void PluginManager::FireToSenderImpl(void* sender_key,
+        EventId event_id,  // <-- [修改]
+        PluginPtr<Event> e_ptr) {
+
+        void* event_ptr = e_ptr.get(); // 获取原始指针用于追踪
+        // [!! 新增 !!] 追踪：事件发布开始
+        const bool traced = event_trace_.Sample();
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kEventFired, event_id, event_ptr);
+        }
+        // [!! 新增 !!] 统计：本次发布的条目 (未开启时为空)，结束后恢复外层发布的条目
+        StatsEntryScope stats_scope(BeginFireStats(event_stats_, event_id));
+
+        // [!! COW !!] 读取快照 (不取 event_mutex_)
+        CallbackListPtr subs;
+        {
+            // [!! 修改 !!] 一次扁平表查找 (发送者与 event_id 组合为一个键)
+            std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+            const CallbackListPtr* found = senders->Find(sender_key, event_id);
+            if (!found) {
+                return;
+            }
+            subs = *found;
+        }
+
+        // 1. [!! 修改 !!] 同步调用 kDirect 订阅，其余按连接方式入队
+        DispatchToList(event_id, subs, true, e_ptr, nullptr, traced);
+    }
+
+    // --- [!! 新增 !!] 3b. 批量发布 (Batch) ---
+
+    namespace {
+        /**
+         * @brief 把单个事件包装成长度为 1 的批次 (栈上对象，无分配)。
+         */
+        class SingleEventBatch final : public EventBatch {
+        public:
+            explicit SingleEventBatch(const Event& e) : event_(e) {}
+            size_t Size() const override { return 1; }
+            const Event& At(size_t) const override { return event_; }
+
+        private:
+            const Event& event_;
+        };
+    }  // namespace
+
+    /**
+     * @brief [!! 新增 !!] 取得回调目标。
+     * @details 已在队列中的任务也在这里检查连接：Disconnect 之后不再开始新的回调。
+     */
+    bool PluginManager::LockSubscriptionTarget(const Subscription& sub,
+        std::shared_ptr<void>& target) {
+        if (sub.connection && !sub.connection->IsConnected()) {
+            return false;
+        }
+        if (sub.connection_owned) {
+            return true;  // 回调是自由函数 / lambda，不使用 target
+        }
+        target = sub.subscriber_id.lock();
+        return static_cast<bool>(target);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 以单个事件调用订阅。
+     */
+    void PluginManager::InvokeSubscription(const Subscription& sub,
+        const Event& e) {
+        // [!! 修改 !!] 在此处 (而不是在每个回调内部) 锁定订阅者
+        std::shared_ptr<void> target;
+        if (!LockSubscriptionTarget(sub, target)) {
+            return;
+        }
+        CallbackTimer timer;  // [!! 新增 !!] 统计开启时记录回调耗时
+        SlowCallbackWatch watch;  // [!! 新增 !!] 工作线程上的看门狗
+        if (sub.callback) {
+            sub.callback(target.get(), e);
+        }
+        else {
+            sub.batch_callback(target.get(), SingleEventBatch(e));
+        }
+        watch.Finish(sub);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 以整批事件调用订阅。
+     */
+    void PluginManager::InvokeSubscription(const Subscription& sub,
+        const EventBatch& batch) {
+        std::shared_ptr<void> target;
+        if (!LockSubscriptionTarget(sub, target)) {
+            return;
+        }
+        CallbackTimer timer;
+        SlowCallbackWatch watch;
+        if (sub.batch_callback) {
+            sub.batch_callback(target.get(), batch);
+        }
+        else {
+            const size_t count = batch.Size();
+            for (size_t i = 0; i < count; ++i) {
+                sub.callback(target.get(), batch.At(i));
+            }
+        }
+        watch.Finish(sub);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 把 1.0 接口传入的 std::function 装入委托。
+     */
+    EventDelegate PluginManager::WrapLegacyCallback(
+        std::function<void(const Event&)> cb) {
+        using LegacyCallback = std::function<void(const Event&)>;
+        return EventDelegate::Create<LegacyCallback>(std::move(cb),
+            [](const void* storage, void*, const Event& e) {
+                EventDelegate::Payload<LegacyCallback>(storage)(e);
+            });
+    }
+
+    namespace {
+        /**
+         * @brief 原批次中通过过滤的子集 (持有原批次，不复制事件)。
+         */
+        class FilteredEventBatch final : public EventBatch {
+        public:
+            FilteredEventBatch(PluginPtr<EventBatch> source,
+                std::vector<size_t> indices)
+                : source_(std::move(source)), indices_(std::move(indices)) {}
+            size_t Size() const override { return indices_.size(); }
+            const Event& At(size_t index) const override {
+                return source_->At(indices_[index]);
+            }
+
+        private:
+            PluginPtr<EventBatch> source_;
+            std::vector<size_t> indices_;
+        };
+    }  // namespace
+
+    /**
+     * @brief [!! 新增 !!] 在发布者线程上以订阅的过滤器筛选一批事件。
+     */
+    PluginPtr<EventBatch> PluginManager::FilterBatch(const Subscription& sub,
+        const PluginPtr<EventBatch>& batch) {
+        const size_t count = batch->Size();
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < count; ++i) {
+            if (sub.Accepts(batch->At(i))) {
+                indices.push_back(i);
+            }
+        }
+        if (indices.empty()) {
+            return nullptr;
+        }
+        if (indices.size() == count) {
+            return batch;
+        }
+        return std::allocate_shared<FilteredEventBatch>(
+            internal::PoolAllocator<FilteredEventBatch>(), batch,
+            std::move(indices));
+    }
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 批量发布全局事件。
+     */
+    void PluginManager::FireGlobalBatchImpl(EventId event_id,
+        PluginPtr<EventBatch> batch) {
+        const bool traced = event_trace_.Sample();
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kEventFired, event_id, batch.get());
+        }
+        StatsEntryScope stats_scope(BeginFireStats(event_stats_, event_id));
+
+        CallbackListPtr subs;
+        {
+            EventMapPtr globals = global_subscribers_.Load();
+            auto it = globals->find(event_id);
+            if (it == globals->end()) {
+                return;
+            }
+            subs = it->second;
+        }
+
+        DispatchToList(event_id, subs, false, batch, nullptr, traced);
+    }
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 向特定发送者的订阅者批量发布事件。
+     */
+    void PluginManager::FireToSenderBatchImpl(void* sender_key,
+        EventId event_id, PluginPtr<EventBatch> batch) {
+        const bool traced = event_trace_.Sample();
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kEventFired, event_id, batch.get());
+        }
+        StatsEntryScope stats_scope(BeginFireStats(event_stats_, event_id));
+
+        CallbackListPtr subs;
+        {
+            std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+            const CallbackListPtr* found = senders->Find(sender_key, event_id);
+            if (!found) {
+                return;
+            }
+            subs = *found;
+        }
+
+        DispatchToList(event_id, subs, true, batch, nullptr, traced);
+    }
+
+    // --- [!! 新增 !!] 3c. 带完成句柄的发布 (FireGlobalAsync / FireToSenderAsync) ---
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 发布全局事件并报告完成。
+     */
+    void PluginManager::FireGlobalAsyncImpl(EventId event_id,
+        PluginPtr<Event> e_ptr, PluginPtr<EventCompletion> completion) {
+        const bool traced = event_trace_.Sample();
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kEventFired, event_id, e_ptr.get());
+        }
+        StatsEntryScope stats_scope(BeginFireStats(event_stats_, event_id));
+
+        CallbackListPtr subs;
+        {
+            EventMapPtr globals = global_subscribers_.Load();
+            auto it = globals->find(event_id);
+            if (it == globals->end()) {
+                completion->Complete();
+                return;
+            }
+            subs = it->second;
+        }
+
+        DispatchToList(event_id, subs, false, e_ptr, completion, traced);
     }
 
-    // --- 1. 事件循环 (Event Loop) ---
-
     /**
-     * @brief 事件循环工作线程的主函数。
-     *
-     * ... (Fix 6 日志) ...
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 发布发送者事件并报告完成。
      */
-    void PluginManager::EventLoop() {
-        // [Fix 6] 定义一个循环超时时间
-        const auto kLoopTimeout = std::chrono::milliseconds(50);
-
-        while (true) {
-            EventTask task_to_run;
-            std::weak_ptr<void> expired_sub_to_gc;
+    void PluginManager::FireToSenderAsyncImpl(void* sender_key,
+        EventId event_id, PluginPtr<Event> e_ptr,
+        PluginPtr<EventCompletion> completion) {
+        const bool traced = event_trace_.Sample();
+        if (traced) {
+            event_trace_.Record(EventTracePoint::kEventFired, event_id, e_ptr.get());
+        }
+        StatsEntryScope stats_scope(BeginFireStats(event_stats_, event_id));
 
-            // --- 1. 异步事件 (EventTask) 阶段 ---
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
+        CallbackListPtr subs;
+        {
+            std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+            const CallbackListPtr* found = senders->Find(sender_key, event_id);
+            if (!found) {
+                completion->Complete();
+                return;
+            }
+            subs = *found;
+        }
 
-                // [Fix 6] 使用 wait_for 替代 wait
-                queue_cv_.wait_for(lock, kLoopTimeout, [this] {
-                    // 谓词 (predicate) 不变：
-                    // 仅当有任务或停止时才“立即”唤醒
-                    return !event_queue_.empty() || !running_;
-                    });
+        DispatchToList(event_id, subs, true, e_ptr, completion, traced);
+    }
 
-                // 检查退出条件
-                if (!running_ && event_queue_.empty()) {
-                    // 析构函数已发出停止信号，
-                    // 并且队列已清空，
-                    // 安全退出线程。
+    // --- [!! 新增 !!] 3d. 合并投递 (kQueuedCoalesced) ---
+
+    namespace {
+        /**
+         * @brief 投递任务对合并槽 scheduled 状态的所有权。
+         * @details 任务未执行就被销毁时 (溢出策略丢弃、关闭时清空队列)
+         * 清除 scheduled 并丢弃槽中的事件，使下一次发布能重新调度；
+         * 否则该订阅将再也收不到事件。
+         * (模板参数只是为了避免在此命名 PluginManager 的私有类型)
+         */
+        template <typename TSlot>
+        class CoalesceToken {
+        public:
+            explicit CoalesceToken(std::shared_ptr<TSlot> slot)
+                : slot_(std::move(slot)) {}
+
+            CoalesceToken(CoalesceToken&&) noexcept = default;
+            CoalesceToken& operator=(CoalesceToken&&) = delete;
+
+            ~CoalesceToken() {
+                if (!slot_) {
                     return;
                 }
-
-                // 如果是“谓词” (有任务)
-                // 或“超时”后发现有任务
-                if (!event_queue_.empty()) {
-                    task_to_run = std::move(event_queue_.front());
-                    event_queue_.pop();
-                }
-
-            }  // 释放 queue_mutex_ 锁
-
-            // 1a. (如果有) 执行异步事件
-            if (task_to_run) {
-                // [!! 新增 !!] 追踪：异步执行开始 (EventTask 不直接暴露事件指针，但这是执行的开始点)
-                // EventTask 是一个 lambda，它在内部捕获了 PluginPtr<Event>
-                if (event_trace_hook_) {
-                    event_trace_hook_(EventTracePoint::kQueuedExecuteStart, 0, nullptr, "Async Task Execution Start");
-                }
-
-                try {
-                    task_to_run();  // 在工作线程上执行回调
-                }
-                catch (const std::exception& e) {
-                    //
-                    // FireGlobal<...>
-                    //
-                    this->FireGlobal<event::AsyncExceptionEvent>(
-                        std::string(e.what()));
+                PluginPtr<EventCompletion> completion;
+                {
+                    std::lock_guard<std::mutex> lock(slot_->mutex);
+                    slot_->scheduled = false;
+                    slot_->pending.reset();
+                    completion = std::move(slot_->completion);
                 }
-                catch (...) {
-                    this->FireGlobal<event::AsyncExceptionEvent>(
-                        "Unknown exception in async event loop.");
-                }
-
-                // [!! 新增 !!] 追踪：异步执行结束
-                if (event_trace_hook_) {
-                    event_trace_hook_(EventTracePoint::kQueuedExecuteEnd, 0, nullptr, "Async Task Execution End");
+                if (completion) {
+                    CompleteDiscarded(*completion);
                 }
             }
 
-            // --- 2. [Fix 5/6] 垃圾回收 (GC) 阶段 ---
-            //
-            // ... (GC 阶段注释) ...
+            /**
+             * @brief 任务开始执行：所有权交给 RunCoalesced。
+             */
+            void Release() { slot_.reset(); }
 
-            // 2a. 尝试从 GC 队列中获取一个失效指针
-            {
-                // gc_queue_
-                // 由 event_mutex_ 保护
-                std::lock_guard<std::recursive_mutex> lock(event_mutex_);
-                if (!gc_queue_.empty()) {
-                    expired_sub_to_gc = gc_queue_.front();
-                    gc_queue_.pop();
-                }
-            }  // 释放 event_mutex_
+        private:
+            std::shared_ptr<TSlot> slot_;
+        };
+    }  // namespace
+
+    /**
+     * @brief [!! 新增 !!] 把事件放入 kQueuedCoalesced 订阅的槽。
+     * @details 槽中已有未投递的事件时直接替换 (被替换事件的完成句柄随即完成：
+     * 订阅者将看到更新的值)；否则置 scheduled 并调度一次投递。
+     */
+    void PluginManager::PostCoalesced(const CallbackListPtr& subs,
+        const Subscription& sub, PluginPtr<const Event> e_ptr,
+        PluginPtr<EventCompletion> completion) {
+        EventCoalesceSlot& slot = *sub.coalesce;
+        if (completion) {
+            completion->AddPending(1);
+        }
 
-            // 2b. (如果获取到) 执行清理
-            if (!expired_sub_to_gc.owner_before(std::weak_ptr<void>())) {
-                // 重新获取锁并安全地
-                // 清理两个反向查找表
-                std::lock_guard<std::recursive_mutex> lock(event_mutex_);
-                // Note: global_sub_lookup_ is std::map
-                global_sub_lookup_.erase(expired_sub_to_gc);
-                // Note: sender_sub_lookup_ is std::map
-                sender_sub_lookup_.erase(expired_sub_to_gc);
+        PluginPtr<EventCompletion> superseded;
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if (slot.pending) {
+                queue_coalesced_.fetch_add(1, std::memory_order_relaxed);
             }
-        }  // end while(true)
+            slot.pending = std::move(e_ptr);
+            superseded = std::exchange(slot.completion, std::move(completion));
+            if (!slot.scheduled) {
+                slot.scheduled = true;
+                schedule = true;
+            }
+        }
+        if (superseded) {
+            superseded->Complete();
+        }
+        if (schedule) {
+            ScheduleCoalesced(subs, sub);
+        }
     }
 
-
-    // --- 2. 全局事件 (Global Events) ---
-
     /**
-     * @brief [IEventBus 内部实现] 订阅一个全局事件。
-     *
-     * [修改]
-     * 参数 'type'
-     * 已重命名为 'event_id'
-     * (类型已从 ClassId
-     * 更改为 EventId)。
+     * @brief [!! 新增 !!] 为槽调度一个投递任务。
+     * @details 捕获 subs 以保证 sub 在任务执行前保持有效 (与 strand 任务相同)。
      */
-    void PluginManager::SubscribeGlobalImpl(
-        EventId event_id,                       // <-- [修改]
-        std::weak_ptr<void> sub,              // 订阅者
-        std::function<void(const Event&)> cb,
-        ConnectionType connection_type) {
-        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
-
-        // 1. 添加到主订阅列表
-        // [修改] 使用 event_id 作为键
-        // Note: global_subscribers_ (EventMap) is now unordered_map.
-        global_subscribers_[event_id].push_back(
-            { std::move(sub), std::weak_ptr<void>(), std::move(cb),
-             connection_type });
-
-        // 2. [Fix 4] 添加到反向查找表
-        // [修改] 插入 event_id
-        // Note: global_sub_lookup_ is std::map
-        global_sub_lookup_[global_subscribers_[event_id].back().subscriber_id]
-            .insert(event_id);
+    void PluginManager::ScheduleCoalesced(const CallbackListPtr& subs,
+        const Subscription& sub) {
+        const Subscription* sub_ptr = &sub;
+        EventTask task = [this, subs, sub_ptr,
+            token = CoalesceToken<EventCoalesceSlot>(sub.coalesce)]() mutable {
+                token.Release();
+                RunCoalesced(subs, *sub_ptr);
+            };
+        if (sub.isolated) {
+            PostIsolatedTask(std::move(task));  // [!! 新增 !!] 已被看门狗降级
+            return;
+        }
+        EnqueueEventTask(std::move(task), sub.priority);
     }
 
     /**
-     * @brief [IEventBus 内部实现] 发布一个全局事件。
-     *
-     * ... (Fix 5/6 日志) ...
-     *
-     * [修改]
-     * 参数 'type'
-     * 已重命名为 'event_id'
-     * (类型已从 ClassId
-     * 更改为 EventId)。
+     * @brief [!! 新增 !!] 投递槽中的最新事件。
+     * @details 回调返回之后才检查槽：执行期间到达的新事件由下一轮投递
+     * (重新入队而不是在此循环，避免高频事件独占工作线程)。
+     * 没有完成句柄时，回调异常在收尾后重新抛出，交给 RunEventTask 处理。
      */
-    void PluginManager::FireGlobalImpl(EventId event_id,
-        PluginPtr<Event> e_ptr)  // <-- [修改]
-    {
-        void* event_ptr = e_ptr.get(); // 获取原始指针用于追踪
-
-        // [!! 新增 !!] 追踪：事件发布开始
-        if (event_trace_hook_) {
-            event_trace_hook_(EventTracePoint::kEventFired, event_id, event_ptr, "Global Event Fired");
+    void PluginManager::RunCoalesced(const CallbackListPtr& subs,
+        const Subscription& sub) {
+        EventCoalesceSlot& slot = *sub.coalesce;
+        PluginPtr<const Event> latest;
+        PluginPtr<EventCompletion> completion;
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            latest = std::move(slot.pending);
+            completion = std::move(slot.completion);
         }
 
-        std::vector<std::function<void(const Event&)>> direct_calls;
-        std::vector<std::function<void(const Event&)>> queued_calls;
-        // [Fix 6] 移除 bool did_gc_queue = false;
+        std::exception_ptr error;
+        if (latest) {
+            try {
+                InvokeSubscription(sub, *latest);
+            }
+            catch (...) {
+                if (completion) {
+                    completion->AddError(std::current_exception());
+                }
+                else {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (completion) {
+            completion->Complete();
+        }
 
+        bool more;
         {
-            std::lock_guard<std::recursive_mutex> lock(event_mutex_);
-            // [修改] 使用 event_id 查找
-            // Note: global_subscribers_ (EventMap) is now unordered_map.
-            auto it = global_subscribers_.find(event_id);
-            if (it == global_subscribers_.end()) {
-                return;
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            more = static_cast<bool>(slot.pending);
+            if (!more) {
+                slot.scheduled = false;
             }
+        }
+        if (more) {
+            ScheduleCoalesced(subs, sub);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // --- [!! 新增 !!] 3e. 保留事件 (Retained) ---
 
-            // [Fix 5] (核心)
-            // 将 gc_queue_ 传给清理函数。
-            CleanupExpiredSubscriptions(it->second, false, gc_queue_);
-            // [Fix 6]
-            // (不再需要检查 gc_queue_
-            //  的大小或设置 did_gc_queue)
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 保存全局保留事件。
+     * @details 被替换的旧实例在锁外释放 (其析构函数可能较重)。
+     */
+    void PluginManager::RetainGlobalImpl(EventId event_id,
+        PluginPtr<const Event> e_ptr) {
+        std::lock_guard<std::mutex> lock(retained_mutex_);
+        std::swap(retained_global_[event_id], e_ptr);
+    }
 
-            // 3. 将回调分类
-            for (const auto& sub : it->second) {
-                if (sub.connection_type == ConnectionType::kDirect) {
-                    direct_calls.push_back(sub.callback);
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 保存发送者的保留事件。
+     * @details 表的大小每翻一倍清理一次已析构发送者的条目 (均摊 O(1))，
+     * 避免不断创建、销毁的发送者让保留事件无限累积。
+     */
+    void PluginManager::RetainToSenderImpl(void* sender_key,
+        std::weak_ptr<void> sender_id, EventId event_id,
+        PluginPtr<const Event> e_ptr) {
+        std::vector<PluginPtr<const Event>> released;
+        std::lock_guard<std::mutex> lock(retained_mutex_);
+        RetainedSenderEvent& entry = retained_sender_[{ sender_key, event_id }];
+        entry.sender_id = std::move(sender_id);
+        std::swap(entry.event, e_ptr);
+
+        if (retained_sender_.size() >= retained_sender_purge_at_) {
+            for (auto it = retained_sender_.begin(); it != retained_sender_.end();) {
+                if (it->second.sender_id.expired()) {
+                    released.push_back(std::move(it->second.event));
+                    it = retained_sender_.erase(it);
                 }
                 else {
-                    queued_calls.push_back(sub.callback);
+                    ++it;
                 }
             }
-        }  // 释放 event_mutex_ 锁
+            retained_sender_purge_at_ = (std::max)(kRetainedSenderPurgeMin,
+                retained_sender_.size() * 2);
+        }
+    }
 
-        // 4. [同步] 立即在发布者线程上执行
-        for (const auto& cb : direct_calls) {
-            // [!! 新增 !!] 追踪：同步调用开始
-            if (event_trace_hook_) {
-                event_trace_hook_(EventTracePoint::kDirectCallStart, event_id, event_ptr, "Executing Direct Callback");
+    /**
+     * @brief [!! 新增 !!] [IEventBus 公共接口] 丢弃某个事件类型的所有保留实例。
+     */
+    void PluginManager::ClearRetainedEvent(EventId event_id) {
+        std::vector<PluginPtr<const Event>> released;
+        std::lock_guard<std::mutex> lock(retained_mutex_);
+        auto global_it = retained_global_.find(event_id);
+        if (global_it != retained_global_.end()) {
+            released.push_back(std::move(global_it->second));
+            retained_global_.erase(global_it);
+        }
+        for (auto it = retained_sender_.begin(); it != retained_sender_.end();) {
+            if (it->first.second == event_id) {
+                released.push_back(std::move(it->second.event));
+                it = retained_sender_.erase(it);
             }
-            cb(*e_ptr);
+            else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * @brief [!! 新增 !!] 查找保留事件。
+     */
+    PluginPtr<const Event> PluginManager::FindRetainedEvent(EventId event_id,
+        void* sender_key, const std::weak_ptr<void>& sender_id) {
+        std::lock_guard<std::mutex> lock(retained_mutex_);
+        if (!sender_key) {
+            auto it = retained_global_.find(event_id);
+            return it != retained_global_.end() ? it->second : nullptr;
         }
-        // [!! 新增 !!] 追踪：同步调用结束 (可以合并到上一个 Hook, 但分离更有利于调试)
-        // if (event_trace_hook_ && !direct_calls.empty()) {
-        //     event_trace_hook_(EventTracePoint::kDirectCallEnd, event_id, event_ptr, "Finished Direct Calls");
-        // }
 
+        auto it = retained_sender_.find({ sender_key, event_id });
+        if (it == retained_sender_.end()) {
+            return nullptr;
+        }
+        // 同一地址上的新对象不是原来的发送者
+        const std::weak_ptr<void>& owner = it->second.sender_id;
+        if (owner.owner_before(sender_id) || sender_id.owner_before(owner) ||
+            owner.expired()) {
+            return nullptr;
+        }
+        return it->second.event;
+    }
 
-        // 5. [异步] 将 kQueued 回调推入队列
-        if (!queued_calls.empty()) {
+    /**
+     * @brief [!! 新增 !!] 按订阅自身的连接方式投递一个事件。
+     * @details kDirect 在订阅者线程上 (订阅调用返回前) 同步执行，
+     * 其余连接方式与 Fire 路径相同。
+     */
+    void PluginManager::DeliverToSubscription(const CallbackListPtr& subs,
+        const Subscription& sub, const PluginPtr<const Event>& e_ptr) {
+        const Subscription* sub_ptr = &sub;
+        if (sub.dispatcher) {
+            PostToDispatcher(sub, [e_ptr, subs, sub_ptr]() {
+                InvokeSubscription(*sub_ptr, *e_ptr);
+                });
+            return;
+        }
+        switch (sub.connection_type) {
+        case ConnectionType::kDirect:
+            InvokeSubscription(sub, *e_ptr);
+            break;
+
+        case ConnectionType::kQueuedOrdered:
+            PostToStrand(sub.strand, sub.priority, [e_ptr, subs, sub_ptr]() {
+                InvokeSubscription(*sub_ptr, *e_ptr);
+                });
+            break;
+
+        case ConnectionType::kQueuedCoalesced:
+            PostCoalesced(subs, sub, e_ptr);
+            break;
+
+        case ConnectionType::kQueued:
+        default:
+            EnqueueEventTask([e_ptr, subs, sub_ptr]() {
+                InvokeSubscription(*sub_ptr, *e_ptr);
+                }, sub.priority);
+            break;
+        }
+    }
 
-            // [!! 新增 !!] 追踪：事件推入异步队列
-            if (event_trace_hook_) {
-                event_trace_hook_(EventTracePoint::kQueuedEntry, event_id, event_ptr, "Event Enqueued");
-            }
+    // --- [!! 新增 !!] 3f. 宿主调度器 ---
 
-            EventTask task = [e_ptr, queued_calls]() {
-                // e_ptr 被捕获，引用计数增加
-                for (const auto& cb : queued_calls) {
-                    cb(*e_ptr);
-                }
-                };
+    /**
+     * @brief [!! 新增 !!] [IEventBus 公共接口] 获取 (或创建) 具名宿主调度器。
+     */
+    PluginPtr<EventDispatcher> PluginManager::GetDispatcher(
+        const std::string& name) {
+        std::lock_guard<std::mutex> lock(dispatcher_mutex_);
+        std::shared_ptr<HostDispatcher>& dispatcher = dispatchers_[name];
+        if (!dispatcher) {
+            dispatcher = std::make_shared<HostDispatcher>(this, name,
+                next_dispatcher_slot_++);
+        }
+        return dispatcher;
+    }
 
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                event_queue_.push(std::move(task));
+    /**
+     * @brief [!! 新增 !!] [IEventBus 公共接口] 移除宿主调度器。
+     * @details 订阅仍引用已关闭的调度器，投递到它的任务直接被丢弃；
+     * 这些订阅随订阅者析构或 Unsubscribe 移除。
+     */
+    void PluginManager::RemoveDispatcher(const std::string& name) {
+        std::shared_ptr<HostDispatcher> removed;
+        {
+            std::lock_guard<std::mutex> lock(dispatcher_mutex_);
+            auto it = dispatchers_.find(name);
+            if (it == dispatchers_.end()) {
+                return;
             }
-            queue_cv_.notify_one();  // 唤醒事件循环 (处理 EventTask)
+            removed = std::move(it->second);
+            dispatchers_.erase(it);
         }
-        // [Fix 6]
-        // 移除了 (else if (did_gc_queue)) 分支，
-        // 因为不再需要它。
+        removed->Close();
     }
 
-    // --- 3. 实例事件 (Sender-Specific Events) ---
+    std::shared_ptr<HostDispatcher> PluginManager::ResolveDispatcher(
+        ConnectionType type) {
+        {
+            std::lock_guard<std::mutex> lock(dispatcher_mutex_);
+            for (const auto& pair : dispatchers_) {
+                if (pair.second->Connection() == type) {
+                    return pair.second;
+                }
+            }
+        }
+        throw PluginException(InstanceError::kErrorDispatcherNotFound,
+            "No event dispatcher for connection slot " +
+            std::to_string(DispatcherSlotOf(type)));
+    }
 
     /**
-     * @brief [IEventBus 内部实现] 订阅一个特定发送者的事件。
-     *
-     * [修改]
-     * ... (同上, 切换到 EventId) ...
+     * @details 与 EnqueueEventTask 一样为任务打上统计戳；
+     * 调度器已关闭时任务在此销毁 (完成句柄随之结束)。
      */
-    void PluginManager::SubscribeToSenderImpl(
-        void* sender_key,
-        EventId event_id,  // <-- [修改]
-        std::weak_ptr<void> sub_id,              // 订阅者
-        std::weak_ptr<void> sender_id,           // 发送者 (用于清理)
-        std::function<void(const Event&)> cb,
-        ConnectionType connection_type) {
-        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
-
-        // 1. 添加到主订阅列表
-        // [修改] 使用 event_id 作为内部 map 的键
-        // Note: sender_subscribers_ (SenderMap) is now unordered_map.
-        sender_subscribers_[sender_key][event_id].push_back(
-            { std::move(sub_id), std::move(sender_id), std::move(cb),
-             connection_type });
+    void PluginManager::PostToDispatcher(const Subscription& sub,
+        EventTask task) {
+        if (t_stats_entry) {
+            task.Stamp(t_stats_entry, EventStatsTable::NowNanoseconds());
+        }
+        StampTrace(task);
+        sub.dispatcher->Post(std::move(task));
+    }
 
-        // 2. [Fix 4] 添加到反向查找表
-        // [修改] 插入 event_id
-        // Note: sender_sub_lookup_ is std::map
-        sender_sub_lookup_
-            [sender_subscribers_[sender_key][event_id].back().subscriber_id]
-            .insert({ sender_key, event_id });
+    void PluginManager::DiscardDispatcherTasks() {
+        std::vector<std::shared_ptr<HostDispatcher>> dispatchers;
+        {
+            std::lock_guard<std::mutex> lock(dispatcher_mutex_);
+            for (const auto& pair : dispatchers_) {
+                dispatchers.push_back(pair.second);
+            }
+        }
+        for (const auto& dispatcher : dispatchers) {
+            dispatcher->DiscardPending();
+        }
     }
 
+    // --- [!! 新增 !!] 3g. 连接句柄 (EventConnection) ---
+    //
+    // Disconnect 只清除连接标志 (O(1)，不取 event_mutex_)；发布路径与
+    // 排队的任务都不再投递它，订阅本身由下一次 GC 时间片从它所在的
+    // 列表中移出 (连接记录了这些键，不需要清扫全部列表)。
+
     /**
-     * @brief [IEventBus 内部实现] 发布一个特定发送者的事件。
-     *
-     * ... (Fix 6, EventId 修改日志) ...
+     * @brief [!! 新增 !!] 断开后交给 GC 定点回收 (PluginManager 已析构时什么也不做)。
      */
-    void PluginManager::FireToSenderImpl(void* sender_key,
-        EventId event_id,  // <-- [修改]
-        PluginPtr<Event> e_ptr) {
+    void PluginManager::SubscriptionConnection::OnDisconnected() {
+        if (PluginPtr<PluginManager> owner = owner_.lock()) {
+            owner->QueueDisconnectedConnection(shared_from_this());
+        }
+    }
 
-        void* event_ptr = e_ptr.get(); // 获取原始指针用于追踪
-        // [!! 新增 !!] 追踪：事件发布开始
-        if (event_trace_hook_) {
-            std::stringstream ss;
-            ss << "Sender Event Fired. Sender Key: 0x" << std::hex << sender_key;
-            event_trace_hook_(EventTracePoint::kEventFired, event_id, event_ptr, ss.str().c_str());
+    /**
+     * @details 订阅者为空时，subscriber_id 改为指向连接状态本身：
+     * 反向查找表、strand 与看门狗都以它标识这条订阅，回收方式与普通订阅相同。
+     */
+    PluginPtr<EventConnectionState> PluginManager::AttachConnection(
+        Subscription& sub) {
+        auto connection = std::make_shared<SubscriptionConnection>(weak_from_this());
+        const std::weak_ptr<void> none;
+        if (!sub.subscriber_id.owner_before(none) &&
+            !none.owner_before(sub.subscriber_id)) {
+            sub.subscriber_id = connection;
+            sub.connection_owned = true;
         }
+        sub.connection = connection;
+        return connection;
+    }
 
-        std::vector<std::function<void(const Event&)>> direct_calls;
-        std::vector<std::function<void(const Event&)>> queued_calls;
-        // [Fix 6] 移除 bool did_gc_queue = false;
+    // --- [!! 新增 !!] 3h. 事件类别 (Z3Y_DEFINE_EVENT_CATEGORY) ---
+    //
+    // 类别订阅在订阅时 (以及后代事件首次登记时) 被复制进每个后代事件的
+    // 订阅列表，发布路径仍只查找一次，不必逐级向上查找祖先。
+    // 副本保留原订阅的 event_id (所订阅的类别) 与反向查找项，
+    // 因此 Unsubscribe / GC 与普通订阅相同。
+    // 批量订阅只匹配确切的事件类型 (EventSpan 的步长按订阅的类型计算)；
+    // 保留事件也只重放给确切类型的订阅。
 
-        {
-            std::lock_guard<std::recursive_mutex> lock(event_mutex_);
-            // Note: sender_subscribers_ (SenderMap) is now unordered_map.
-            auto sender_it = sender_subscribers_.find(sender_key);
-            if (sender_it == sender_subscribers_.end()) {
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 登记事件的类别链。
+     * @details 由近及远逐级登记，遇到已登记的层级即停止
+     * (它的祖先必然也已登记)。
+     */
+    void PluginManager::DeclareEventCategoryImpl(EventId event_id,
+        const EventId* ancestors, size_t count) {
+        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+        for (size_t level = 0; level < count; ++level) {
+            const EventId id = level == 0 ? event_id : ancestors[level - 1];
+            if (event_ancestors_.count(id) != 0) {
                 return;
             }
-
-            // [修改] 使用 event_id 查找
-            // Note: sender_it->second (EventMap) is now unordered_map.
-            auto event_it = sender_it->second.find(event_id);
-            if (event_it == sender_it->second.end()) {
-                return;
+            std::vector<EventId>& chain = event_ancestors_[id];
+            chain.assign(ancestors + level, ancestors + count);
+            for (EventId ancestor : chain) {
+                category_descendants_[ancestor].push_back(id);
             }
+            InheritCategorySubscriptions(id);
+        }
+    }
 
-            // [Fix 5] (核心)
-            // 将 gc_queue_ 传入清理函数
-            CleanupExpiredSubscriptions(event_it->second, true, gc_queue_);
-            // [Fix 6] (不再需要 did_gc_queue)
+    PluginManager::Subscription PluginManager::MakeCategoryCopy(
+        const Subscription& sub, EventId descendant) const {
+        Subscription copy = sub;
+        if (!copy.isolated) {  // 降级的订阅保持 kLow
+            copy.priority = LookupEventPriority(descendant);
+        }
+        if (copy.coalesce) {
+            // 每个后代事件各用一个槽：合并只发生在同一 EventId 之间
+            copy.coalesce = std::make_shared<EventCoalesceSlot>();
+        }
+        return copy;
+    }
 
-            // 分类回调
-            for (const auto& sub : event_it->second) {
-                if (sub.connection_type == ConnectionType::kDirect) {
-                    direct_calls.push_back(sub.callback);
+    /**
+     * @brief [!! COW !!] 在 Add*Subscription 中调用 (新订阅尚未加入自己的列表)。
+     */
+    void PluginManager::PropagateCategorySubscription(void* sender_key,
+        const Subscription& sub) {
+        if (sub.batch_callback) {
+            return;
+        }
+        if (sender_key) {
+            category_sender_keys_[sub.event_id].insert(sender_key);
+        }
+        auto it = category_descendants_.find(sub.event_id);
+        if (it == category_descendants_.end()) {
+            return;
+        }
+        for (EventId descendant : it->second) {
+            EventCallbackList list;
+            if (!sender_key) {
+                global_sub_lookup_[sub.subscriber_id].insert(descendant);
+                if (sub.connection) {
+                    sub.connection->global_keys.push_back(descendant);
                 }
-                else {
-                    queued_calls.push_back(sub.callback);
+                EventMapPtr globals = global_subscribers_.Load();
+                auto list_it = globals->find(descendant);
+                if (list_it != globals->end()) {
+                    list = *list_it->second;
                 }
+                list.push_back(MakeCategoryCopy(sub, descendant));
+                PublishGlobalList(descendant, std::move(list));
             }
-        }  // 释放 event_mutex_ 锁
-
-        // 1. [同步] 立即在发布者线程上执行
-        for (const auto& cb : direct_calls) {
-            // [!! 新增 !!] 追踪：同步调用开始
-            if (event_trace_hook_) {
-                event_trace_hook_(EventTracePoint::kDirectCallStart, event_id, event_ptr, "Executing Sender Direct Callback");
+            else {
+                sender_sub_lookup_[sub.subscriber_id].insert(
+                    { sender_key, descendant });
+                if (sub.connection) {
+                    sub.connection->sender_keys.emplace_back(sender_key, descendant);
+                }
+                std::shared_ptr<const SenderIndex> senders =
+                    sender_subscribers_.Load();
+                if (const CallbackListPtr* current =
+                    senders->Find(sender_key, descendant)) {
+                    list = **current;
+                }
+                list.push_back(MakeCategoryCopy(sub, descendant));
+                PublishSenderList(sender_key, descendant, std::move(list));
             }
-            cb(*e_ptr);
         }
-        // [!! 新增 !!] 追踪：同步调用结束 (可选)
-        // if (event_trace_hook_ && !direct_calls.empty()) {
-        //     event_trace_hook_(EventTracePoint::kDirectCallEnd, event_id, event_ptr, "Finished Sender Direct Calls");
-        // }
+    }
 
+    /**
+     * @brief [!! COW !!] 复制各祖先类别“自己的”订阅 (event_id 为该祖先，
+     * 不含其他类别的副本)，追加到 event_id 的全局与发送者列表。
+     */
+    void PluginManager::InheritCategorySubscriptions(EventId event_id) {
+        const std::vector<EventId>& ancestors = event_ancestors_[event_id];
+        auto inherits = [&ancestors](const Subscription& sub, EventId owner) {
+            return sub.event_id == owner && !sub.batch_callback &&
+                std::find(ancestors.begin(), ancestors.end(), owner) !=
+                ancestors.end();
+            };
 
-        // 2. [异步] 将任务推入队列
-        if (!queued_calls.empty()) {
-            // [!! 新增 !!] 追踪：事件推入异步队列
-            if (event_trace_hook_) {
-                event_trace_hook_(EventTracePoint::kQueuedEntry, event_id, event_ptr, "Sender Event Enqueued");
+        // 1. 全局表
+        EventMapPtr globals = global_subscribers_.Load();
+        EventCallbackList inherited;
+        for (EventId ancestor : ancestors) {
+            auto it = globals->find(ancestor);
+            if (it == globals->end()) {
+                continue;
             }
-
-            EventTask task = [e_ptr, queued_calls]() {
-                for (const auto& cb : queued_calls) {
-                    cb(*e_ptr);
+            for (const Subscription& sub : *it->second) {
+                if (inherits(sub, ancestor) && !IsSubscriptionExpired(sub, false)) {
+                    global_sub_lookup_[sub.subscriber_id].insert(event_id);
+                    if (sub.connection) {
+                        sub.connection->global_keys.push_back(event_id);
+                    }
+                    inherited.push_back(MakeCategoryCopy(sub, event_id));
                 }
-                };
+            }
+        }
+        if (!inherited.empty()) {
+            EventCallbackList list;
+            auto it = globals->find(event_id);
+            if (it != globals->end()) {
+                list = *it->second;
+            }
+            list.insert(list.end(), std::make_move_iterator(inherited.begin()),
+                std::make_move_iterator(inherited.end()));
+            PublishGlobalList(event_id, std::move(list));
+        }
 
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                event_queue_.push(std::move(task));
+        // 2. 发送者表：只访问持有祖先订阅的发送者键 (category_sender_keys_)，
+        // 先收集 (读取的是已发布的快照)，再逐个发布
+        std::shared_ptr<const SenderIndex> snapshot = sender_subscribers_.Load();
+        std::map<void*, EventCallbackList> by_sender;
+        for (EventId ancestor : ancestors) {
+            auto keys_it = category_sender_keys_.find(ancestor);
+            if (keys_it == category_sender_keys_.end()) {
+                continue;
+            }
+            for (void* sender_key : keys_it->second) {
+                const CallbackListPtr* subs = snapshot->Find(sender_key, ancestor);
+                if (!subs) {
+                    continue;
+                }
+                for (const Subscription& sub : **subs) {
+                    if (inherits(sub, ancestor) && !IsSubscriptionExpired(sub, true)) {
+                        sender_sub_lookup_[sub.subscriber_id].insert(
+                            { sender_key, event_id });
+                        if (sub.connection) {
+                            sub.connection->sender_keys.emplace_back(
+                                sender_key, event_id);
+                        }
+                        by_sender[sender_key].push_back(
+                            MakeCategoryCopy(sub, event_id));
+                    }
+                }
+            }
+        }
+        for (auto& pair : by_sender) {
+            EventCallbackList list;
+            std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+            if (const CallbackListPtr* current = senders->Find(pair.first, event_id)) {
+                list = **current;
             }
-            queue_cv_.notify_one();  // 唤醒 (处理 EventTask)
+            list.insert(list.end(), std::make_move_iterator(pair.second.begin()),
+                std::make_move_iterator(pair.second.end()));
+            PublishSenderList(pair.first, event_id, std::move(list));
+        }
+    }
+
+    void PluginManager::ForgetCategorySenderKey(void* sender_key,
+        EventId event_id) {
+        auto it = category_sender_keys_.find(event_id);
+        if (it == category_sender_keys_.end()) {
+            return;
+        }
+        it->second.erase(sender_key);
+        if (it->second.empty()) {
+            category_sender_keys_.erase(it);
         }
-        // [Fix 6] 移除 (else if (did_gc_queue))
     }
 
     // --- 4. 手动生命周期管理 ---
@@ -465,8 +2887,14 @@ namespace z3y {
         std::weak_ptr<void> weak_id = subscriber;
 
         auto is_same_subscriber = [&weak_id](const Subscription& s) {
-            return !s.subscriber_id.owner_before(weak_id) &&
-                !weak_id.owner_before(s.subscriber_id);
+            if (s.subscriber_id.owner_before(weak_id) ||
+                weak_id.owner_before(s.subscriber_id)) {
+                return false;
+            }
+            if (s.connection) {
+                s.connection->MarkDisconnected();  // [!! 新增 !!] 句柄随之断开
+            }
+            return true;
             };
 
 
@@ -479,13 +2907,15 @@ namespace z3y {
             // -> 'event_id'
             // (类型已变为 EventId)
             for (const EventId& event_id : global_it->second) {
-                // Note: global_subscribers_ (EventMap) is now unordered_map.
-                auto event_list_it = global_subscribers_.find(event_id);
-                if (event_list_it != global_subscribers_.end()) {
-                    auto& subs = event_list_it->second;
+                // [!! COW !!] 复制、过滤并重新发布
+                EventMapPtr globals = global_subscribers_.Load();
+                auto event_list_it = globals->find(event_id);
+                if (event_list_it != globals->end()) {
+                    EventCallbackList subs = *event_list_it->second;
                     subs.erase(std::remove_if(subs.begin(), subs.end(),
                         is_same_subscriber),
                         subs.end());
+                    PublishGlobalList(event_id, std::move(subs));
                 }
             }
             // 从反向查找表中移除
@@ -507,22 +2937,110 @@ namespace z3y {
                 // (类型已变为 EventId)
                 const EventId& event_id = pair.second;
 
-                // Note: sender_subscribers_ (SenderMap) is now unordered_map.
-                auto sender_map_it = sender_subscribers_.find(sender_key);
-                if (sender_map_it != sender_subscribers_.end()) {
-                    // Note: sender_map_it->second (EventMap) is now unordered_map.
-                    auto event_list_it = sender_map_it->second.find(event_id);
-                    if (event_list_it != sender_map_it->second.end()) {
-                        auto& subs = event_list_it->second;
-                        subs.erase(std::remove_if(subs.begin(), subs.end(),
-                            is_same_subscriber),
-                            subs.end());
-                    }
+                // [!! COW !!] 复制、过滤并重新发布
+                std::shared_ptr<const SenderIndex> senders =
+                    sender_subscribers_.Load();
+                if (const CallbackListPtr* current =
+                    senders->Find(sender_key, event_id)) {
+                    EventCallbackList subs = **current;
+                    subs.erase(std::remove_if(subs.begin(), subs.end(),
+                        is_same_subscriber),
+                        subs.end());
+                    PublishSenderList(sender_key, event_id,
+                        std::move(subs));
                 }
             }
             // 从反向查找表中移除
             sender_sub_lookup_.erase(sender_it);
         }
+
+        // --- 5. [!! 新增 !!] 释放 strand (已投递的任务仍持有它) ---
+        subscriber_strands_.erase(weak_id);
+    }
+
+    // --- 5. [!! 新增 !!] 异步优先级 (Priority Lanes) ---
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 内部实现] 登记事件类型声明的默认优先级。
+     * @details 由 Subscribe* 模板在事件类型带有 Z3Y_DEFINE_EVENT_PRIORITY 时调用；
+     * 已被 SetEventPriority 覆盖的事件类型保持不变。
+     */
+    void PluginManager::DeclareEventPriorityImpl(EventId event_id,
+        EventPriority priority) {
+        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+        auto it = event_priorities_.find(event_id);
+        if (it != event_priorities_.end() &&
+            (it->second.overridden || it->second.priority == priority)) {
+            return;
+        }
+        ApplyEventPriority(event_id, priority, false);
+    }
+
+    /**
+     * @brief [!! 新增 !!] [IEventBus 实现] 设置事件类型的异步投递优先级。
+     */
+    void PluginManager::SetEventPriority(EventId event_id,
+        EventPriority priority) {
+        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
+        ApplyEventPriority(event_id, priority, true);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 查询事件类型当前的优先级 (未登记时为 kNormal)。
+     */
+    EventPriority PluginManager::LookupEventPriority(EventId event_id) const {
+        auto it = event_priorities_.find(event_id);
+        return it != event_priorities_.end()
+            ? it->second.priority : EventPriority::kNormal;
+    }
+
+    /**
+     * @brief [!! COW !!] 记录优先级，并把已有订阅以新的优先级重新发布。
+     * @details 全局表与发送者表各只复制/发布一次；订阅数量不变，过滤器无需调整。
+     */
+    void PluginManager::ApplyEventPriority(EventId event_id,
+        EventPriority priority, bool overridden) {
+        const EventPriority previous = LookupEventPriority(event_id);
+        event_priorities_[event_id] = { priority, overridden };
+        if (previous == priority) {
+            return;
+        }
+
+        auto restamp = [priority](const CallbackListPtr& list) {
+            EventCallbackList copy = *list;
+            for (Subscription& sub : copy) {
+                if (!sub.isolated) {  // [!! 新增 !!] 降级的订阅保持 kLow
+                    sub.priority = priority;
+                }
+            }
+            return std::make_shared<const EventCallbackList>(std::move(copy));
+            };
+
+        // 1. 全局表
+        EventMapPtr globals = global_subscribers_.Load();
+        auto it = globals->find(event_id);
+        if (it != globals->end()) {
+            auto next = std::make_shared<EventMap>(*globals);
+            (*next)[event_id] = restamp(it->second);
+            global_subscribers_.Store(std::move(next));
+        }
+
+        // 2. 发送者表 (遍历已发布的快照，修改草稿)
+        std::shared_ptr<const SenderIndex> senders = sender_subscribers_.Load();
+        std::shared_ptr<SenderIndex> next_senders;
+        senders->ForEach([&](const SenderIndex::Entry& entry) {
+            if (entry.event_id != event_id) {
+                return;
+            }
+            if (!next_senders) {
+                next_senders = std::make_shared<SenderIndex>(*senders);
+            }
+            next_senders->Set(entry.sender_key, entry.event_id,
+                restamp(entry.value));
+            });
+        if (next_senders) {
+            sender_subscribers_.Store(std::move(next_senders));
+        }
     }
 
-}  // namespace z3y
\ No newline at end of file
+}  // namespace z3y
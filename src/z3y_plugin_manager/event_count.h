@@ -0,0 +1,126 @@
+/**
+ * @file event_count.h
+ * @brief [内部] 定义 z3y::EventCount，“事件计数器”式的线程唤醒原语。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 与“每次 push 都 notify 条件变量”不同，EventCount
+ * 只在确实有线程处于等待状态时才进入内核：
+ * 生产者在无等待者时只付出一次原子读。
+ *
+ * 等待方的标准用法：
+ * \code{.cpp}
+ * auto key = ec.PrepareWait();
+ * if (TryGetWork()) { ec.CancelWait(); }
+ * else { ec.Wait(key); }
+ * \endcode
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_EVENT_COUNT_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_EVENT_COUNT_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace z3y {
+
+    /**
+     * @class EventCount
+     * @brief 只在有等待者时才唤醒的通知原语。
+     */
+    class EventCount {
+    public:
+        using Key = uint64_t;
+
+        EventCount() : epoch_(0), waiters_(0) {}
+
+        EventCount(const EventCount&) = delete;
+        EventCount& operator=(const EventCount&) = delete;
+
+        /**
+         * @brief 登记为等待者并返回当前纪元。
+         * 之后调用方必须重新检查条件，再调用 Wait 或 CancelWait。
+         */
+        Key PrepareWait() {
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            return epoch_.load(std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief 条件已满足，放弃等待。
+         */
+        void CancelWait() {
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief 阻塞直到纪元自 PrepareWait 以来发生变化。
+         */
+        void Wait(Key key) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this, key] {
+                return epoch_.load(std::memory_order_acquire) != key;
+                });
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief 带超时的 Wait。
+         * @return true 表示被通知，false 表示超时。
+         */
+        template <typename Rep, typename Period>
+        bool WaitFor(Key key, const std::chrono::duration<Rep, Period>& timeout) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            const bool notified = cv_.wait_for(lock, timeout, [this, key] {
+                return epoch_.load(std::memory_order_acquire) != key;
+                });
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+            return notified;
+        }
+
+        /**
+         * @brief 唤醒一个等待者 (无等待者时只有一次原子读)。
+         */
+        void NotifyOne() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                epoch_.fetch_add(1, std::memory_order_release);
+            }
+            cv_.notify_one();
+        }
+
+        /**
+         * @brief 唤醒所有等待者。
+         */
+        void NotifyAll() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                epoch_.fetch_add(1, std::memory_order_release);
+            }
+            cv_.notify_all();
+        }
+
+    private:
+        std::atomic<Key> epoch_;
+        std::atomic<uint32_t> waiters_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_EVENT_COUNT_H_
@@ -0,0 +1,146 @@
+/**
+ * @file event_ring_buffer.h
+ * @brief [内部] 定义 z3y::EventRingBuffer，有界、预分配的多生产者环形队列。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 基于 Dmitry Vyukov 的有界 MPMC 队列：
+ * 每个槽位带有一个序号 (sequence)，生产者/消费者通过 CAS
+ * 竞争 enqueue_pos_ / dequeue_pos_，无需互斥锁。
+ * 工作线程池中存在多个消费者，因此这里实现的是 MPMC
+ * (MPSC 是它的一个特例)。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_EVENT_RING_BUFFER_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_EVENT_RING_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace z3y {
+
+    /**
+     * @class EventRingBuffer
+     * @brief 有界无锁 MPMC 环形队列。容量向上取整为 2 的幂。
+     * @tparam T 元素类型 (必须可默认构造、可移动)。
+     */
+    template <typename T>
+    class EventRingBuffer {
+    public:
+        explicit EventRingBuffer(size_t capacity)
+            : mask_(RoundUpPowerOfTwo(capacity) - 1),
+            cells_(new Cell[mask_ + 1]),
+            enqueue_pos_(0),
+            dequeue_pos_(0) {
+            for (size_t i = 0; i <= mask_; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        EventRingBuffer(const EventRingBuffer&) = delete;
+        EventRingBuffer& operator=(const EventRingBuffer&) = delete;
+
+        /**
+         * @brief 尝试入队。
+         * @return false 表示队列已满 (此时 value 不会被移走)。
+         */
+        bool TryPush(T&& value) {
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[pos & mask_];
+                const size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t diff =
+                    static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.data = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;  // 已满
+                }
+                else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief 尝试出队。
+         * @return false 表示队列为空。
+         */
+        bool TryPop(T& out_value) {
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[pos & mask_];
+                const size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t diff =
+                    static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                        out_value = std::move(cell.data);
+                        cell.data = T();  // 立即释放捕获的资源
+                        cell.sequence.store(pos + mask_ + 1,
+                            std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;  // 为空
+                }
+                else {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief 队列容量 (2 的幂)。
+         */
+        size_t Capacity() const { return mask_ + 1; }
+
+        /**
+         * @brief 当前深度的近似值 (并发下仅供统计)。
+         */
+        size_t SizeApprox() const {
+            const size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+            const size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        static size_t RoundUpPowerOfTwo(size_t value) {
+            size_t result = 2;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        // 生产者与消费者的游标分处不同缓存行，避免伪共享
+        static constexpr size_t kCacheLine = 64;
+
+        const size_t mask_;
+        const std::unique_ptr<Cell[]> cells_;
+        alignas(kCacheLine) std::atomic<size_t> enqueue_pos_;
+        alignas(kCacheLine) std::atomic<size_t> dequeue_pos_;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_EVENT_RING_BUFFER_H_
@@ -0,0 +1,182 @@
+/**
+ * @file event_stats.cpp
+ * @brief [!! 新增 !!] z3y::AtomicHistogram 与 z3y::EventStatsTable 的实现。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ */
+
+#include "event_stats.h"
+#include <chrono>
+#include <limits>
+#include <thread>
+
+namespace z3y {
+
+    void AtomicHistogram::Reset() {
+        for (auto& bucket : counts_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    EventHistogram AtomicHistogram::Snapshot() const {
+        EventHistogram snapshot;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            const uint64_t count = counts_[i].load(std::memory_order_relaxed);
+            if (count != 0) {
+                snapshot.buckets.emplace_back(BucketUpperBound(i), count);
+                snapshot.count += count;
+            }
+        }
+        snapshot.sum = sum_.load(std::memory_order_relaxed);
+        if (snapshot.count != 0) {
+            snapshot.min = min_.load(std::memory_order_relaxed);
+            snapshot.max = max_.load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    EventStatsTable::EventStatsTable() : slots_(new Slot[kCapacity]) {}
+
+    EventStatsTable::~EventStatsTable() {
+        for (size_t i = 0; i < kCapacity; ++i) {
+            delete slots_[i].entry.load(std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t EventStatsTable::NowNanoseconds() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void EventStatsTable::Enable(bool enabled) {
+        if (enabled) {
+            Reset();
+        }
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 线性探测；空槽用 CAS 认领，认领者随后发布条目，
+     * 同时查找同一键的线程短暂等待条目出现。
+     */
+    EventStatsEntry* EventStatsTable::Acquire(EventId event_id) {
+        if (event_id == 0) {
+            return &overflow_;
+        }
+        const size_t mask = kCapacity - 1;
+        size_t index = static_cast<size_t>(
+            (event_id * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+        for (size_t probe = 0; probe < kCapacity; ++probe) {
+            Slot& slot = slots_[index];
+            EventId key = slot.key.load(std::memory_order_acquire);
+            if (key == 0) {
+                if (slot.key.compare_exchange_strong(key, event_id,
+                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    auto* entry = new EventStatsEntry(event_id);
+                    slot.entry.store(entry, std::memory_order_release);
+                    return entry;
+                }
+                // 失败时 key 为其他线程写入的键
+            }
+            if (key == event_id) {
+                EventStatsEntry* entry;
+                while ((entry = slot.entry.load(std::memory_order_acquire)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                return entry;
+            }
+            index = (index + 1) & mask;
+        }
+        return &overflow_;
+    }
+
+    void EventStatsTable::Reset() {
+        for (size_t i = 0; i < kCapacity; ++i) {
+            EventStatsEntry* entry = slots_[i].entry.load(std::memory_order_acquire);
+            if (entry) {
+                entry->fired.store(0, std::memory_order_relaxed);
+                entry->queue_latency_ns.Reset();
+                entry->callback_ns.Reset();
+                entry->fan_out.Reset();
+            }
+        }
+        overflow_.fired.store(0, std::memory_order_relaxed);
+        overflow_.queue_latency_ns.Reset();
+        overflow_.callback_ns.Reset();
+        overflow_.fan_out.Reset();
+        for (auto& high_water : lane_high_water_) {
+            high_water.store(0, std::memory_order_relaxed);
+        }
+        total_high_water_.store(0, std::memory_order_relaxed);
+        window_start_ns_.store(NowNanoseconds(), std::memory_order_relaxed);
+    }
+
+    void EventStatsTable::FillStats(const EventStatsEntry& entry,
+        EventStats& out_stats) const {
+        out_stats.event_id = entry.event_id;
+        out_stats.fired = entry.fired.load(std::memory_order_relaxed);
+        out_stats.window_ns = NowNanoseconds() -
+            window_start_ns_.load(std::memory_order_relaxed);
+        out_stats.queue_latency_ns = entry.queue_latency_ns.Snapshot();
+        out_stats.callback_ns = entry.callback_ns.Snapshot();
+        out_stats.fan_out = entry.fan_out.Snapshot();
+    }
+
+    std::vector<EventStats> EventStatsTable::Snapshot() const {
+        std::vector<EventStats> result;
+        auto append = [&](const EventStatsEntry& entry) {
+            if (entry.fired.load(std::memory_order_relaxed) != 0) {
+                result.emplace_back();
+                FillStats(entry, result.back());
+            }
+        };
+        for (size_t i = 0; i < kCapacity; ++i) {
+            const EventStatsEntry* entry =
+                slots_[i].entry.load(std::memory_order_acquire);
+            if (entry) {
+                append(*entry);
+            }
+        }
+        append(overflow_);
+        return result;
+    }
+
+    bool EventStatsTable::Snapshot(EventId event_id, EventStats& out_stats) const {
+        const size_t mask = kCapacity - 1;
+        size_t index = static_cast<size_t>(
+            (event_id * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+        for (size_t probe = 0; probe < kCapacity; ++probe) {
+            const Slot& slot = slots_[index];
+            const EventId key = slot.key.load(std::memory_order_acquire);
+            if (key == 0) {
+                return false;
+            }
+            if (key == event_id) {
+                const EventStatsEntry* entry =
+                    slot.entry.load(std::memory_order_acquire);
+                if (!entry || entry->fired.load(std::memory_order_relaxed) == 0) {
+                    return false;
+                }
+                FillStats(*entry, out_stats);
+                return true;
+            }
+            index = (index + 1) & mask;
+        }
+        return false;
+    }
+
+    EventQueueDepthStats EventStatsTable::QueueDepth() const {
+        EventQueueDepthStats stats;
+        for (size_t lane = 0; lane < kEventPriorityCount; ++lane) {
+            stats.lane_high_water[lane] =
+                lane_high_water_[lane].load(std::memory_order_relaxed);
+        }
+        stats.total_high_water = total_high_water_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+}  // namespace z3y
@@ -0,0 +1,201 @@
+/**
+ * @file event_stats.h
+ * @brief [内部] 定义 z3y::AtomicHistogram 与 z3y::EventStatsTable (IEventStats 的存储)。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * - AtomicHistogram：HDR 风格的对数-线性分桶，值 v 落入
+ * (v 的最高位, 其后 3 位) 决定的桶；记录是几次 relaxed fetch_add，
+ * min/max 只在被刷新时才 CAS；
+ * - EventStatsTable：EventId → EventStatsEntry 的定长开放寻址表，
+ * 查找与插入都是无锁的 (键一经写入不再改变)，条目在表析构前不会释放，
+ * 因此可以把条目指针保存在异步任务中。表满后新的 EventId 计入溢出条目
+ * (event_id 为 0)。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_EVENT_STATS_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_EVENT_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "framework/i_event_stats.h"
+
+namespace z3y {
+
+    /**
+     * @class AtomicHistogram
+     * @brief 无锁的对数-线性直方图。
+     */
+    class AtomicHistogram {
+    public:
+        static constexpr uint32_t kSubBucketBits = 3;
+        static constexpr size_t kSubBuckets = size_t{ 1 } << kSubBucketBits;
+        static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+        AtomicHistogram() { Reset(); }
+        AtomicHistogram(const AtomicHistogram&) = delete;
+        AtomicHistogram& operator=(const AtomicHistogram&) = delete;
+
+        void Record(uint64_t value) {
+            counts_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+            sum_.fetch_add(value, std::memory_order_relaxed);
+            uint64_t current = min_.load(std::memory_order_relaxed);
+            while (value < current && !min_.compare_exchange_weak(current, value,
+                std::memory_order_relaxed)) {
+            }
+            current = max_.load(std::memory_order_relaxed);
+            while (value > current && !max_.compare_exchange_weak(current, value,
+                std::memory_order_relaxed)) {
+            }
+        }
+
+        /**
+         * @brief 清零 (与 Record 并发时可能漏掉或保留个别样本)。
+         */
+        void Reset();
+
+        EventHistogram Snapshot() const;
+
+        /**
+         * @brief 值所在的桶：小于 kSubBuckets 的值各占一个桶，
+         * 之后每个 2 的幂区间均分为 kSubBuckets 个桶。
+         */
+        static size_t BucketIndex(uint64_t value) {
+            if (value < kSubBuckets) {
+                return static_cast<size_t>(value);
+            }
+            const uint32_t shift = HighestBit(value) - kSubBucketBits;
+            return (shift + 1) * kSubBuckets +
+                static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+        }
+
+        /**
+         * @brief 桶内的最大值。
+         */
+        static uint64_t BucketUpperBound(size_t index) {
+            if (index < kSubBuckets) {
+                return index;
+            }
+            const uint32_t shift = static_cast<uint32_t>(index / kSubBuckets - 1);
+            const uint64_t lower =
+                (kSubBuckets + index % kSubBuckets) << shift;
+            return lower + ((uint64_t{ 1 } << shift) - 1);
+        }
+
+    private:
+        // 可移植的二分查找 (Win32 目标没有 64 位的位扫描内建函数)
+        static uint32_t HighestBit(uint64_t value) {
+            uint32_t bit = 0;
+            for (uint32_t step = 32; step != 0; step >>= 1) {
+                if (value >> step) {
+                    value >>= step;
+                    bit += step;
+                }
+            }
+            return bit;
+        }
+
+        std::array<std::atomic<uint64_t>, kBucketCount> counts_;
+        std::atomic<uint64_t> sum_;
+        std::atomic<uint64_t> min_;
+        std::atomic<uint64_t> max_;
+    };
+
+    /**
+     * @struct EventStatsEntry
+     * @brief 一个 EventId 的计数器。
+     */
+    struct EventStatsEntry {
+        explicit EventStatsEntry(EventId id) : event_id(id) {}
+
+        const EventId event_id;
+        std::atomic<uint64_t> fired{ 0 };
+        AtomicHistogram queue_latency_ns;
+        AtomicHistogram callback_ns;
+        AtomicHistogram fan_out;
+    };
+
+    /**
+     * @class EventStatsTable
+     * @brief EventId → EventStatsEntry 的无锁表，外加队列深度高水位。
+     */
+    class EventStatsTable {
+    public:
+        static constexpr size_t kCapacity = 1024;  //!< 可区分的 EventId 数 (2 的幂)
+
+        EventStatsTable();
+        ~EventStatsTable();
+        EventStatsTable(const EventStatsTable&) = delete;
+        EventStatsTable& operator=(const EventStatsTable&) = delete;
+
+        /**
+         * @brief [热路径] 统计是否开启。
+         */
+        bool Enabled() const {
+            return enabled_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 开启 (并重置) 或关闭统计。
+         */
+        void Enable(bool enabled);
+
+        /**
+         * @brief 查找或创建 event_id 的条目 (无锁)。
+         */
+        EventStatsEntry* Acquire(EventId event_id);
+
+        void Reset();
+
+        std::vector<EventStats> Snapshot() const;
+        bool Snapshot(EventId event_id, EventStats& out_stats) const;
+
+        /**
+         * @brief 刷新队列深度高水位。
+         */
+        void RecordQueueDepth(size_t lane, size_t lane_depth, size_t total_depth) {
+            RaiseTo(lane_high_water_[lane], lane_depth);
+            RaiseTo(total_high_water_, total_depth);
+        }
+
+        EventQueueDepthStats QueueDepth() const;
+
+        /**
+         * @brief steady_clock 时间戳 (纳秒)。
+         */
+        static uint64_t NowNanoseconds();
+
+    private:
+        struct Slot {
+            std::atomic<EventId> key{ 0 };
+            std::atomic<EventStatsEntry*> entry{ nullptr };
+        };
+
+        static void RaiseTo(std::atomic<size_t>& target, size_t value) {
+            size_t current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value,
+                std::memory_order_relaxed)) {
+            }
+        }
+
+        void FillStats(const EventStatsEntry& entry, EventStats& out_stats) const;
+
+        std::atomic<bool> enabled_{ false };
+        std::atomic<uint64_t> window_start_ns_{ 0 };
+        std::unique_ptr<Slot[]> slots_;
+        EventStatsEntry overflow_{ 0 };  // 表满后的 EventId
+        std::array<std::atomic<size_t>, kEventPriorityCount> lane_high_water_{};
+        std::atomic<size_t> total_high_water_{ 0 };
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_EVENT_STATS_H_
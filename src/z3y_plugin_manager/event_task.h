@@ -0,0 +1,250 @@
+/**
+ * @file event_task.h
+ * @brief [内部] 定义 z3y::EventTask (异步任务) 与 z3y::EventTaskDeque。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * EventTask 取代 std::function<void()>：
+ * - 只可移动，内联缓冲区 kInlineSize 字节，
+ * 足以容纳事件总线投递的所有 lambda (事件指针 + 订阅快照 + 订阅指针)，
+ * 因此投递任务不再触发堆分配；
+ * - 超出内联缓冲区的可调用对象退回 internal::PoolAllocator。
+ *
+ * EventTaskDeque 取代 std::deque<EventTask>：
+ * 只增不减的环形缓冲区，稳态下 push/pop 不分配内存
+ * (std::deque 会周期性地申请/释放内部分块)。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_EVENT_TASK_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_EVENT_TASK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "framework/class_id.h"
+#include "framework/event_pool.h"
+
+namespace z3y {
+
+    struct EventStatsEntry;
+
+    /**
+     * @class EventTask
+     * @brief 只可移动的 void() 可调用对象，带内联小缓冲区。
+     */
+    class EventTask {
+    public:
+        static constexpr size_t kInlineSize = 48;
+
+        EventTask() noexcept = default;
+        EventTask(std::nullptr_t) noexcept {}
+
+        template <typename F, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, EventTask> &&
+            !std::is_same_v<std::decay_t<F>, std::nullptr_t>>>
+        EventTask(F&& func) {
+            using Fn = std::decay_t<F>;
+            if constexpr (kFitsInline<Fn>) {
+                ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(func));
+                ops_ = &kInlineOps<Fn>;
+            }
+            else {
+                internal::PoolAllocator<Fn> alloc;
+                Fn* heap = alloc.allocate(1);
+                try {
+                    ::new (static_cast<void*>(heap)) Fn(std::forward<F>(func));
+                }
+                catch (...) {
+                    alloc.deallocate(heap, 1);
+                    throw;
+                }
+                ::new (static_cast<void*>(storage_)) Fn*(heap);
+                ops_ = &kHeapOps<Fn>;
+            }
+        }
+
+        EventTask(EventTask&& other) noexcept { MoveFrom(other); }
+
+        EventTask& operator=(EventTask&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        EventTask& operator=(std::nullptr_t) noexcept {
+            Reset();
+            return *this;
+        }
+
+        EventTask(const EventTask&) = delete;
+        EventTask& operator=(const EventTask&) = delete;
+
+        ~EventTask() { Reset(); }
+
+        explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+        void operator()() { ops_->invoke(storage_); }
+
+        /**
+         * @brief [!! 新增 !!] 记录任务所属事件的统计条目与入队时间 (统计开启时)。
+         */
+        void Stamp(EventStatsEntry* stats, uint64_t enqueued_ns) noexcept {
+            stats_ = stats;
+            enqueued_ns_ = enqueued_ns;
+        }
+
+        EventStatsEntry* StatsEntry() const noexcept { return stats_; }
+        uint64_t EnqueuedNanoseconds() const noexcept { return enqueued_ns_; }
+
+        /**
+         * @brief [!! 新增 !!] 标记任务属于一次被采样追踪的发布
+         * (执行时以同一事件 ID 与事件指针记录开始/结束，不再单独采样)。
+         */
+        void StampTrace(EventId event_id, const void* event) noexcept {
+            trace_event_id_ = event_id;
+            trace_event_ = event;
+            traced_ = true;
+        }
+
+        bool Traced() const noexcept { return traced_; }
+        EventId TraceEventId() const noexcept { return trace_event_id_; }
+        const void* TraceEvent() const noexcept { return trace_event_; }
+
+    private:
+        struct Ops {
+            void (*invoke)(void* storage);
+            void (*move)(void* dst, void* src) noexcept;  // 移动后销毁 src
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template <typename Fn>
+        static constexpr bool kFitsInline =
+            sizeof(Fn) <= kInlineSize &&
+            alignof(Fn) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible_v<Fn>;
+
+        template <typename Fn>
+        static constexpr Ops kInlineOps = {
+            [](void* storage) { (*static_cast<Fn*>(storage))(); },
+            [](void* dst, void* src) noexcept {
+                Fn* from = static_cast<Fn*>(src);
+                ::new (dst) Fn(std::move(*from));
+                from->~Fn();
+            },
+            [](void* storage) noexcept { static_cast<Fn*>(storage)->~Fn(); },
+        };
+
+        template <typename Fn>
+        static constexpr Ops kHeapOps = {
+            [](void* storage) { (**static_cast<Fn**>(storage))(); },
+            [](void* dst, void* src) noexcept {
+                ::new (dst) Fn*(*static_cast<Fn**>(src));
+            },
+            [](void* storage) noexcept {
+                Fn* heap = *static_cast<Fn**>(storage);
+                heap->~Fn();
+                internal::PoolAllocator<Fn>().deallocate(heap, 1);
+            },
+        };
+
+        void MoveFrom(EventTask& other) noexcept {
+            if (other.ops_) {
+                other.ops_->move(storage_, other.storage_);
+                ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+            stats_ = other.stats_;
+            enqueued_ns_ = other.enqueued_ns_;
+            other.stats_ = nullptr;
+            trace_event_id_ = other.trace_event_id_;
+            trace_event_ = other.trace_event_;
+            traced_ = std::exchange(other.traced_, false);
+        }
+
+        void Reset() noexcept {
+            if (ops_) {
+                ops_->destroy(storage_);
+                ops_ = nullptr;
+            }
+            stats_ = nullptr;
+            traced_ = false;
+        }
+
+        alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+        const Ops* ops_ = nullptr;
+        EventStatsEntry* stats_ = nullptr;  // [!! 新增 !!] 未开启统计时为空
+        uint64_t enqueued_ns_ = 0;
+        // [!! 新增 !!] 追踪：所属发布的事件 (traced_ 为 false 时无意义)
+        EventId trace_event_id_ = 0;
+        const void* trace_event_ = nullptr;
+        bool traced_ = false;
+    };
+
+    /**
+     * @class EventTaskDeque
+     * @brief 只增不减的 EventTask 环形双端队列 (接口与 std::deque 的子集一致)。
+     * @note 非线程安全，由调用方加锁 (WorkerQueue::mutex / EventStrand::mutex)。
+     */
+    class EventTaskDeque {
+    public:
+        bool empty() const { return size_ == 0; }
+        size_t size() const { return size_; }
+
+        void push_back(EventTask&& task) {
+            if (size_ == capacity_) {
+                Grow();
+            }
+            slots_[(head_ + size_) & (capacity_ - 1)] = std::move(task);
+            ++size_;
+        }
+
+        EventTask& front() { return slots_[head_]; }
+        EventTask& back() { return slots_[(head_ + size_ - 1) & (capacity_ - 1)]; }
+
+        void pop_front() {
+            slots_[head_] = nullptr;  // 立即释放捕获的资源
+            head_ = (head_ + 1) & (capacity_ - 1);
+            --size_;
+        }
+
+        void pop_back() {
+            back() = nullptr;
+            --size_;
+        }
+
+        void clear() {
+            while (!empty()) {
+                pop_front();
+            }
+            head_ = 0;
+        }
+
+    private:
+        void Grow() {
+            const size_t new_capacity = capacity_ ? capacity_ * 2 : 16;
+            std::unique_ptr<EventTask[]> grown(new EventTask[new_capacity]);
+            for (size_t i = 0; i < size_; ++i) {
+                grown[i] = std::move(slots_[(head_ + i) & (capacity_ - 1)]);
+            }
+            slots_ = std::move(grown);
+            capacity_ = new_capacity;
+            head_ = 0;
+        }
+
+        std::unique_ptr<EventTask[]> slots_;
+        size_t capacity_ = 0;  // 总是 0 或 2 的幂
+        size_t head_ = 0;
+        size_t size_ = 0;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_EVENT_TASK_H_
@@ -0,0 +1,250 @@
+/**
+ * @file event_trace.cpp
+ * @brief [!! 新增 !!] z3y::EventTraceBuffer 的实现。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ */
+
+#include "event_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace z3y {
+
+    namespace {
+        // 进程内唯一的追踪代数，线程缓存据此判断是否需要重新登记
+        std::atomic<uint64_t> s_next_generation{ 1 };
+
+        thread_local uint32_t t_sample_counter = 0;
+
+        size_t RoundUpPowerOfTwo(size_t value) {
+            size_t result = 2;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        uint64_t NowNanoseconds() {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /**
+         * @brief 追踪点在 Chrome trace 中的名字与阶段 (B/E 成对，i 为瞬时事件)。
+         */
+        void DescribePoint(EventTracePoint point, const char*& name,
+            const char*& phase) {
+            switch (point) {
+            case EventTracePoint::kEventFired:
+                name = "Fire"; phase = "i"; break;
+            case EventTracePoint::kQueuedEntry:
+                name = "Enqueue"; phase = "i"; break;
+            case EventTracePoint::kDirectCallStart:
+                name = "DirectCall"; phase = "B"; break;
+            case EventTracePoint::kDirectCallEnd:
+                name = "DirectCall"; phase = "E"; break;
+            case EventTracePoint::kQueuedExecuteStart:
+                name = "EventTask"; phase = "B"; break;
+            case EventTracePoint::kQueuedExecuteEnd:
+                name = "EventTask"; phase = "E"; break;
+            default:
+                name = "Unknown"; phase = "i"; break;
+            }
+        }
+    }  // namespace
+
+    /**
+     * @struct EventTraceBuffer::ThreadCache
+     * @brief 线程局部的环指针 (线程退出时归还环)。
+     */
+    struct EventTraceBuffer::ThreadCache {
+        const EventTraceBuffer* owner = nullptr;
+        uint64_t generation = 0;
+        std::shared_ptr<ThreadRing> ring;
+        uint32_t thread = 0;
+
+        ~ThreadCache() { Release(); }
+
+        void Release() {
+            if (ring) {
+                ring->in_use.store(false, std::memory_order_release);
+                ring.reset();
+            }
+        }
+    };
+
+    void EventTraceBuffer::Start(const EventTraceOptions& options) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.clear();
+        capacity_ = RoundUpPowerOfTwo(options.records_per_thread);
+        next_thread_ = 1;
+        sample_every_.store(std::max<uint32_t>(options.sample_every, 1),
+            std::memory_order_relaxed);
+        generation_.store(s_next_generation.fetch_add(1, std::memory_order_relaxed),
+            std::memory_order_release);
+        enabled_.store(true, std::memory_order_release);
+    }
+
+    void EventTraceBuffer::Stop() {
+        enabled_.store(false, std::memory_order_release);
+    }
+
+    bool EventTraceBuffer::SampleSlow() const {
+        const uint32_t every = sample_every_.load(std::memory_order_relaxed);
+        return every <= 1 || ++t_sample_counter % every == 0;
+    }
+
+    EventTraceBuffer::ThreadCache& EventTraceBuffer::LocalCache() {
+        thread_local ThreadCache t_cache;
+        if (t_cache.owner == this && t_cache.ring &&
+            t_cache.generation == generation_.load(std::memory_order_acquire)) {
+            return t_cache;
+        }
+
+        // [慢路径] 首次记录，或追踪已重新开始：登记 (或复用) 一个环
+        t_cache.Release();
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<ThreadRing> ring;
+        for (const auto& candidate : rings_) {
+            bool idle = false;
+            if (candidate->in_use.compare_exchange_strong(idle, true,
+                std::memory_order_acquire, std::memory_order_relaxed)) {
+                ring = candidate;
+                break;
+            }
+        }
+        if (!ring) {
+            ring = std::make_shared<ThreadRing>(std::max<size_t>(capacity_, 2));
+            rings_.push_back(ring);
+        }
+        t_cache.owner = this;
+        t_cache.generation = generation_.load(std::memory_order_relaxed);
+        t_cache.ring = std::move(ring);
+        t_cache.thread = next_thread_++;
+        return t_cache;
+    }
+
+    /**
+     * @brief 写入一条记录 (单写者 seqlock：claimed → 槽位 → head)。
+     */
+    void EventTraceBuffer::Record(EventTracePoint point, EventId event_id,
+        const void* event) {
+        ThreadCache& cache = LocalCache();
+        ThreadRing& ring = *cache.ring;
+        const uint64_t index = ring.head.load(std::memory_order_relaxed);
+        ring.claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Slot& slot = ring.slots[index & ring.mask];
+        slot.words[0].store(NowNanoseconds(), std::memory_order_relaxed);
+        slot.words[1].store(event_id, std::memory_order_relaxed);
+        slot.words[2].store(reinterpret_cast<uintptr_t>(event),
+            std::memory_order_relaxed);
+        slot.words[3].store((static_cast<uint64_t>(cache.thread) << 8) |
+            static_cast<uint8_t>(point), std::memory_order_relaxed);
+        ring.head.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<EventTraceRecord> EventTraceBuffer::Snapshot(
+        uint64_t* overwritten) const {
+        std::vector<std::shared_ptr<ThreadRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings = rings_;
+        }
+
+        std::vector<EventTraceRecord> records;
+        uint64_t lost = 0;
+        for (const auto& ring : rings) {
+            const uint64_t capacity = ring->mask + 1;
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            const uint64_t begin = head > capacity ? head - capacity : 0;
+            const size_t first = records.size();
+            for (uint64_t index = begin; index < head; ++index) {
+                const Slot& slot = ring->slots[index & ring->mask];
+                const uint64_t meta = slot.words[3].load(std::memory_order_relaxed);
+                EventTraceRecord record;
+                record.timestamp_ns = slot.words[0].load(std::memory_order_relaxed);
+                record.event_id = slot.words[1].load(std::memory_order_relaxed);
+                record.event = reinterpret_cast<const void*>(static_cast<uintptr_t>(
+                    slot.words[2].load(std::memory_order_relaxed)));
+                record.thread = static_cast<uint32_t>(meta >> 8);
+                record.point = static_cast<EventTracePoint>(meta & 0xFF);
+                records.push_back(record);
+            }
+
+            // 复制期间写者可能已经开始改写最旧的槽位：丢弃这部分
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t claimed = ring->claimed.load(std::memory_order_relaxed);
+            const uint64_t valid_begin =
+                std::max(begin, claimed > capacity ? claimed - capacity : 0);
+            const size_t torn = static_cast<size_t>(
+                std::min(valid_begin, head) - begin);
+            records.erase(records.begin() + first,
+                records.begin() + first + torn);
+            lost += std::min(valid_begin, head);
+        }
+
+        // 同一线程内已按时间排列，稳定排序保持 B/E 的先后
+        std::stable_sort(records.begin(), records.end(),
+            [](const EventTraceRecord& a, const EventTraceRecord& b) {
+                return a.timestamp_ns < b.timestamp_ns;
+            });
+        if (overwritten) {
+            *overwritten = lost;
+        }
+        return records;
+    }
+
+    /**
+     * @brief 输出 JSON Object Format 的 Chrome trace
+     * (chrome://tracing 与 ui.perfetto.dev 均可打开)。
+     * @details 时间戳相对于第一条记录，单位微秒；
+     * 同步回调与工作线程任务输出为 B/E 区间，其余为瞬时事件。
+     */
+    void EventTraceBuffer::ExportChromeTrace(std::ostream& out) const {
+        uint64_t overwritten = 0;
+        const std::vector<EventTraceRecord> records = Snapshot(&overwritten);
+        const uint64_t origin = records.empty() ? 0 : records.front().timestamp_ns;
+
+        std::vector<uint32_t> threads;
+        out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"overwritten\":"
+            << overwritten << "},\"traceEvents\":[";
+        bool first = true;
+        char line[256];
+        for (const EventTraceRecord& record : records) {
+            const char* name = nullptr;
+            const char* phase = nullptr;
+            DescribePoint(record.point, name, phase);
+            const uint64_t delta = record.timestamp_ns - origin;
+            std::snprintf(line, sizeof(line),
+                "%s\n{\"name\":\"%s\",\"cat\":\"z3y\",\"ph\":\"%s\",%s"
+                "\"ts\":%llu.%03u,\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"event_id\":\"0x%016llx\",\"event\":\"%p\"}}",
+                first ? "" : ",", name, phase,
+                phase[0] == 'i' ? "\"s\":\"t\"," : "",
+                static_cast<unsigned long long>(delta / 1000),
+                static_cast<unsigned>(delta % 1000), record.thread,
+                static_cast<unsigned long long>(record.event_id), record.event);
+            out << line;
+            first = false;
+            if (std::find(threads.begin(), threads.end(), record.thread) ==
+                threads.end()) {
+                threads.push_back(record.thread);
+            }
+        }
+        for (uint32_t thread : threads) {
+            std::snprintf(line, sizeof(line),
+                "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":\"z3y thread %u\"}}",
+                first ? "" : ",", thread, thread);
+            out << line;
+            first = false;
+        }
+        out << "\n]}\n";
+    }
+
+}  // namespace z3y
@@ -0,0 +1,166 @@
+/**
+ * @file event_trace.h
+ * @brief [内部] 定义 z3y::EventTraceBuffer，每线程无锁的二进制事件追踪缓冲区。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 取代 std::function 形式的 EventTraceHook：
+ * - 关闭时，热路径上只有一次 relaxed 原子读取；
+ * - 开启时，每个追踪点写入一条 32 字节的定长记录到本线程的环
+ * (单写者，不加锁、不分配、不格式化字符串)，环满后覆盖最旧的记录；
+ * - 按发布采样 (每 N 次记录 1 次)，同一次发布的各追踪点一起保留或一起丢弃；
+ * - 导出时 (可在追踪进行中) 合并所有线程的记录，
+ * 输出 Chrome trace / Perfetto 可直接打开的 JSON。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_EVENT_TRACE_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_EVENT_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "framework/class_id.h"
+
+namespace z3y {
+
+    /**
+     * @enum EventTracePoint
+     * @brief 追踪点。
+     */
+    enum class EventTracePoint : uint8_t {
+        kEventFired,           //!< 事件被发布
+        kDirectCallStart,      //!< 同步回调执行开始
+        kQueuedEntry,          //!< 事件被推入异步队列
+        kQueuedExecuteStart,   //!< 事件在工作线程中开始执行
+        kQueuedExecuteEnd,     //!< 事件在工作线程中执行结束 (EventTask完成)
+        kDirectCallEnd,        //!< [!! 新增 !!] 同步回调执行结束
+    };
+
+    /**
+     * @struct EventTraceOptions
+     * @brief [!! 新增 !!] 事件追踪的参数。
+     */
+    struct EventTraceOptions {
+        /**
+         * @brief 采样率：每 N 次发布 (每个线程独立计数) 记录 1 次。1 表示全部记录。
+         */
+        uint32_t sample_every = 1;
+        /**
+         * @brief 每个线程的环形缓冲区容量 (记录数，向上取整为 2 的幂)。
+         * 每条记录 32 字节。
+         */
+        size_t records_per_thread = 16384;
+    };
+
+    /**
+     * @struct EventTraceRecord
+     * @brief [!! 新增 !!] 一条追踪记录 (导出时的解包形式)。
+     */
+    struct EventTraceRecord {
+        uint64_t timestamp_ns;   //!< steady_clock 时间戳 (纳秒)
+        EventId event_id;        //!< 事件 ID (工作线程任务为其所属发布的事件)
+        const void* event;       //!< 事件实例地址 (批量发布时为批次地址)
+        uint32_t thread;         //!< 线程序号 (按首次记录的顺序从 1 开始分配)
+        EventTracePoint point;   //!< 追踪点
+    };
+
+    /**
+     * @class EventTraceBuffer
+     * @brief 每线程环形缓冲区的集合。
+     */
+    class EventTraceBuffer {
+    public:
+        EventTraceBuffer() = default;
+        EventTraceBuffer(const EventTraceBuffer&) = delete;
+        EventTraceBuffer& operator=(const EventTraceBuffer&) = delete;
+
+        /**
+         * @brief 开始追踪 (丢弃之前的全部记录)。
+         */
+        void Start(const EventTraceOptions& options);
+
+        /**
+         * @brief 停止追踪 (保留已有记录供导出)。
+         */
+        void Stop();
+
+        /**
+         * @brief [热路径] 本次发布是否记录。每次发布只调用一次，
+         * 其余追踪点沿用这次的结果。
+         */
+        bool Sample() const {
+            return enabled_.load(std::memory_order_relaxed) && SampleSlow();
+        }
+
+        /**
+         * @brief 写入一条记录到当前线程的环。只在 Sample() 返回 true 后调用。
+         */
+        void Record(EventTracePoint point, EventId event_id,
+            const void* event);
+
+        /**
+         * @brief 合并所有线程的记录，按时间排序。可与写入并发。
+         * @param[out] overwritten 可选：因环满被覆盖的记录数。
+         */
+        std::vector<EventTraceRecord> Snapshot(
+            uint64_t* overwritten = nullptr) const;
+
+        /**
+         * @brief 以 Chrome trace event 格式 (JSON) 输出全部记录。
+         */
+        void ExportChromeTrace(std::ostream& out) const;
+
+    private:
+        /**
+         * @struct Slot
+         * @brief 一条记录的存储：按字读写的原子量，读者可与写者并发读取。
+         */
+        struct Slot {
+            std::atomic<uint64_t> words[4];
+        };
+
+        /**
+         * @struct ThreadRing
+         * @brief 一个线程的环 (单写者)。
+         * @details 写者先发布 claimed 再写槽位、最后推进 head；
+         * 读者复制后再读 claimed，丢弃可能正被改写的最旧部分 (seqlock)。
+         * 线程退出后环被标记为空闲，由之后的新线程复用；
+         * 记录自带线程序号，复用不会混淆。
+         */
+        struct ThreadRing {
+            explicit ThreadRing(size_t capacity)
+                : slots(new Slot[capacity]()), mask(capacity - 1) {}
+
+            std::unique_ptr<Slot[]> slots;
+            const size_t mask;
+            std::atomic<uint64_t> head{ 0 };
+            std::atomic<uint64_t> claimed{ 0 };
+            std::atomic<bool> in_use{ true };
+        };
+
+        struct ThreadCache;
+
+        bool SampleSlow() const;
+        ThreadCache& LocalCache();
+
+        std::atomic<bool> enabled_{ false };
+        std::atomic<uint32_t> sample_every_{ 1 };
+        std::atomic<uint64_t> generation_{ 0 };  // 每次 Start 递增 (进程内唯一)
+
+        mutable std::mutex mutex_;  // 保护下列成员
+        std::vector<std::shared_ptr<ThreadRing>> rings_;
+        size_t capacity_ = 0;
+        uint32_t next_thread_ = 1;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_EVENT_TRACE_H_
@@ -0,0 +1,293 @@
+/**
+ * @file flat_sender_index.h
+ * @brief [内部] 定义 z3y::FlatSenderIndex，以 (发送者, 事件) 为键的扁平开放寻址表。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 取代原来的 unordered_map<void*, unordered_map<EventId, ...>>：
+ * - 原布局每次 FireToSender 做两次基于节点的哈希查找 (外层桶 -> 节点 ->
+ * 内层 map -> 桶 -> 节点)，每个发送者还各有一个内层 map 的分配；
+ * - 现在 (发送者, 事件) 直接哈希到一个线性探测的连续槽位数组，
+ * 命中时只访问根表中的分片描述和一段连续的槽位。
+ *
+ * 订阅表是写时复制 (COW) 的快照。一张单一的扁平表在每次订阅时都要整体复制，
+ * 大量发送者时会退化为 O(n^2)；因此槽位被分成 kShardCount 个分片
+ * (按哈希高位选择)，复制根表只复制分片指针，写者只克隆被修改的分片。
+ * 已发布的分片永远不会被修改。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_FLAT_SENDER_INDEX_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_FLAT_SENDER_INDEX_H_
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "framework/class_id.h"
+#include "subscription_filter.h"
+
+namespace z3y {
+
+    /**
+     * @class FlatSenderIndex
+     * @brief 分片的扁平开放寻址表 (线性探测，删除时反向移位，无墓碑)。
+     * @tparam TValue 值类型；值为空 (operator bool 为 false) 的槽位表示空槽。
+     *
+     * @details
+     * 用法 (写者持有 event_mutex_)：
+     * @code
+     * auto next = std::make_shared<FlatSenderIndex<V>>(*current); // 草稿
+     * next->Set(sender, event_id, value);  // 空 value 表示删除
+     * snapshot.Store(std::move(next));
+     * @endcode
+     * 复制得到的草稿与原表共享全部分片；草稿第一次修改某个分片时克隆它，
+     * 之后对同一分片的修改就地进行 (批量修改只克隆一次)。
+     */
+    template <typename TValue>
+    class FlatSenderIndex {
+    public:
+        static constexpr size_t kShardBits = 8;
+        static constexpr size_t kShardCount = size_t(1) << kShardBits;
+
+        /**
+         * @struct Entry
+         * @brief 槽位。
+         */
+        struct Entry {
+            void* sender_key = nullptr;
+            EventId event_id = 0;
+            TValue value;
+        };
+
+        FlatSenderIndex() = default;
+
+        /**
+         * @brief 复制为草稿：共享所有分片，但不拥有其中任何一个。
+         */
+        FlatSenderIndex(const FlatSenderIndex& other)
+            : shards_(other.shards_), size_(other.size_) {}
+
+        FlatSenderIndex& operator=(const FlatSenderIndex&) = delete;
+
+        /**
+         * @brief 查找键对应的值 (不存在时返回 nullptr)。
+         */
+        const TValue* Find(void* sender_key, EventId event_id) const {
+            const uint64_t hash = Hash(sender_key, event_id);
+            const ShardRef& ref = shards_[ShardOf(hash)];
+            if (!ref.slots) {
+                return nullptr;
+            }
+            for (size_t i = SlotOf(hash) & ref.mask;; i = (i + 1) & ref.mask) {
+                const Entry& entry = ref.slots[i];
+                if (!entry.value) {
+                    return nullptr;
+                }
+                if (entry.sender_key == sender_key &&
+                    entry.event_id == event_id) {
+                    return &entry.value;
+                }
+            }
+        }
+
+        /**
+         * @brief 插入、替换或 (value 为空时) 删除一个键。
+         * @note 只能在尚未发布的草稿上调用。
+         */
+        void Set(void* sender_key, EventId event_id, TValue value) {
+            const uint64_t hash = Hash(sender_key, event_id);
+            const size_t shard_index = ShardOf(hash);
+            const Shard* existing = shards_[shard_index].shard.get();
+
+            if (!value) {
+                if (!existing || !Find(sender_key, event_id)) {
+                    return;
+                }
+                Shard& shard = Own(shard_index, 0);
+                Erase(shard, hash, sender_key, event_id);
+                --size_;
+                if (shard.size == 0) {
+                    shards_[shard_index] = ShardRef();
+                    owned_.reset(shard_index);
+                }
+                else if (shard.size * 8 < shard.slots.size() &&
+                    shard.slots.size() > kMinCapacity) {
+                    Rehash(shard_index, shard.slots.size() / 2);
+                }
+                return;
+            }
+
+            const size_t needed = (existing ? existing->size : 0) + 1;
+            Shard& shard = Own(shard_index, needed);
+            if (Insert(shard, hash, sender_key, event_id, std::move(value))) {
+                ++size_;
+            }
+        }
+
+        /**
+         * @brief 遍历所有条目：fn(const Entry&)。
+         */
+        template <typename Fn>
+        void ForEach(Fn&& fn) const {
+            for (const ShardRef& ref : shards_) {
+                if (!ref.shard) {
+                    continue;
+                }
+                for (const Entry& entry : ref.shard->slots) {
+                    if (entry.value) {
+                        fn(entry);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief 条目总数。
+         */
+        size_t Size() const { return size_; }
+
+    private:
+        static constexpr size_t kMinCapacity = 8;
+
+        struct Shard {
+            std::vector<Entry> slots;  // 容量为 2 的幂
+            size_t size = 0;
+        };
+
+        /**
+         * @brief 根表中的分片描述：槽位指针与掩码内联在根表中，
+         * 查找时不必先访问 Shard 对象。
+         */
+        struct ShardRef {
+            std::shared_ptr<Shard> shard;
+            Entry* slots = nullptr;
+            size_t mask = 0;
+        };
+
+        static uint64_t Hash(void* sender_key, EventId event_id) {
+            // 与过滤器使用同一组合键，再做一次 Fibonacci 混合
+            return SenderFilterKey(sender_key, event_id) * 0x9E3779B97F4A7C15ULL;
+        }
+
+        static size_t ShardOf(uint64_t hash) {
+            return static_cast<size_t>(hash >> (64 - kShardBits));
+        }
+
+        /**
+         * @brief 分片内的起始槽位 (与掩码相与后使用)。
+         * 乘法哈希的低位混合很差 (指针低位是对齐零)，取中间的位。
+         */
+        static size_t SlotOf(uint64_t hash) {
+            return static_cast<size_t>(hash >> 24);
+        }
+
+        /**
+         * @brief 取得可修改的分片：未拥有时克隆，装载率将超过 3/4 时扩容。
+         */
+        Shard& Own(size_t shard_index, size_t needed) {
+            ShardRef& ref = shards_[shard_index];
+            size_t capacity = ref.shard ? ref.shard->slots.size() : 0;
+            if (needed * 4 > capacity * 3) {
+                capacity = capacity ? capacity * 2 : kMinCapacity;
+                Rehash(shard_index, capacity);
+            }
+            else if (!owned_.test(shard_index)) {
+                ref.shard = std::make_shared<Shard>(*ref.shard);
+                ref.slots = ref.shard->slots.data();
+                owned_.set(shard_index);
+            }
+            return *ref.shard;
+        }
+
+        /**
+         * @brief 以新容量重建分片 (结果总是由本草稿拥有)。
+         */
+        void Rehash(size_t shard_index, size_t capacity) {
+            ShardRef& ref = shards_[shard_index];
+            auto rebuilt = std::make_shared<Shard>();
+            rebuilt->slots.resize(capacity);
+            if (ref.shard) {
+                const bool owned = owned_.test(shard_index);
+                for (Entry& entry : ref.shard->slots) {
+                    if (!entry.value) {
+                        continue;
+                    }
+                    Insert(*rebuilt, Hash(entry.sender_key, entry.event_id),
+                        entry.sender_key, entry.event_id,
+                        owned ? std::move(entry.value) : TValue(entry.value));
+                }
+            }
+            ref.shard = std::move(rebuilt);
+            ref.slots = ref.shard->slots.data();
+            ref.mask = capacity - 1;
+            owned_.set(shard_index);
+        }
+
+        /**
+         * @return true 表示新增，false 表示替换了已有的值。
+         */
+        static bool Insert(Shard& shard, uint64_t hash, void* sender_key,
+            EventId event_id, TValue value) {
+            const size_t mask = shard.slots.size() - 1;
+            for (size_t i = SlotOf(hash) & mask;; i = (i + 1) & mask) {
+                Entry& entry = shard.slots[i];
+                if (!entry.value) {
+                    entry.sender_key = sender_key;
+                    entry.event_id = event_id;
+                    entry.value = std::move(value);
+                    ++shard.size;
+                    return true;
+                }
+                if (entry.sender_key == sender_key &&
+                    entry.event_id == event_id) {
+                    entry.value = std::move(value);
+                    return false;
+                }
+            }
+        }
+
+        /**
+         * @brief 删除已存在的键，并把其后的探测链向前移位 (保持查找不断链)。
+         */
+        static void Erase(Shard& shard, uint64_t hash, void* sender_key,
+            EventId event_id) {
+            const size_t mask = shard.slots.size() - 1;
+            size_t hole = SlotOf(hash) & mask;
+            while (shard.slots[hole].sender_key != sender_key ||
+                shard.slots[hole].event_id != event_id) {
+                hole = (hole + 1) & mask;
+            }
+
+            for (size_t i = (hole + 1) & mask; shard.slots[i].value;
+                i = (i + 1) & mask) {
+                const Entry& entry = shard.slots[i];
+                const size_t home =
+                    SlotOf(Hash(entry.sender_key, entry.event_id)) & mask;
+                // home 不在 (hole, i] 区间内 (循环意义上) 时，条目可以移入空洞
+                const bool reachable = (hole <= i)
+                    ? (home > hole && home <= i)
+                    : (home > hole || home <= i);
+                if (!reachable) {
+                    shard.slots[hole] = std::move(shard.slots[i]);
+                    hole = i;
+                }
+            }
+            shard.slots[hole] = Entry();
+            --shard.size;
+        }
+
+        std::array<ShardRef, kShardCount> shards_;
+        std::bitset<kShardCount> owned_;  // 本草稿克隆过 (可以就地修改) 的分片
+        size_t size_ = 0;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_FLAT_SENDER_INDEX_H_
@@ -0,0 +1,236 @@
+/**
+ * @file host_dispatcher.cpp
+ * @brief [!! 新增 !!] z3y::HostDispatcher 的实现。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ */
+
+#include "host_dispatcher.h"
+#include "plugin_manager.h"
+#include <new>
+#include <utility>
+
+namespace z3y {
+
+    HostDispatcher::HostDispatcher(PluginManager* owner, std::string name,
+        unsigned slot)
+        : EventDispatcher(slot),
+        owner_(owner),
+        name_(std::move(name)),
+        back_(&stub_),
+        front_(&stub_) {}
+
+    HostDispatcher::~HostDispatcher() {
+        DrainAll();  // 最后一个引用已释放，不会再有生产者或消费者
+    }
+
+    HostDispatcher::Node* HostDispatcher::AllocateNode(EventTask task) {
+        internal::PoolAllocator<Node> alloc;
+        Node* node = alloc.allocate(1);
+        ::new (static_cast<void*>(node)) Node();
+        node->task = std::move(task);
+        return node;
+    }
+
+    void HostDispatcher::FreeNode(Node* node) noexcept {
+        node->~Node();
+        internal::PoolAllocator<Node>().deallocate(node, 1);
+    }
+
+    void HostDispatcher::Push(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = back_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @details 生产者在 exchange 之后、链接 next 之前被挂起时，
+     * 链表暂时“断开”：此时返回 nullptr，任务留到下一次 Pump。
+     * stub_ 保证链表永不为空，取出最后一个结点时把它重新接到链尾。
+     */
+    HostDispatcher::Node* HostDispatcher::PopNode() {
+        Node* front = front_;
+        Node* next = front->next.load(std::memory_order_acquire);
+        if (front == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            front_ = next;
+            front = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            front_ = next;
+            return front;
+        }
+        if (front != back_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        Push(&stub_);
+        next = front->next.load(std::memory_order_acquire);
+        if (next) {
+            front_ = next;
+            return front;
+        }
+        return nullptr;
+    }
+
+    bool HostDispatcher::AcquireConsumer(bool& nested) {
+        const std::thread::id self = std::this_thread::get_id();
+        std::thread::id expected{};
+        if (consumer_.compare_exchange_strong(expected, self,
+            std::memory_order_acquire, std::memory_order_relaxed)) {
+            nested = false;
+            return true;
+        }
+        nested = expected == self;
+        return nested;
+    }
+
+    void HostDispatcher::ReleaseConsumer(bool nested) {
+        if (!nested) {
+            consumer_.store(std::thread::id(), std::memory_order_release);
+        }
+    }
+
+    void HostDispatcher::DrainAll() {
+        while (Node* node = PopNode()) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            FreeNode(node);  // 任务持有的完成句柄以 kErrorEventQueueFull 结束
+        }
+    }
+
+    /**
+     * @details pending_ 在链接之前增加 (消费者最多短暂看到一个
+     * 尚未链接的任务)；与 WaitForImpl 中的 waiters_ 构成 Dekker 式配对，
+     * 两者都使用 seq_cst。
+     */
+    bool HostDispatcher::Post(EventTask task) {
+        if (IsClosed()) {
+            return false;
+        }
+        const size_t previous = pending_.fetch_add(1);
+        Push(AllocateNode(std::move(task)));
+        if (previous == 0) {
+            NotifyHost();
+        }
+
+        // 与 Close 竞争：任务可能在关闭之后才接入链表，而关闭方的
+        // DiscardPending 没有看到它。此时由投递者自己丢弃 (消费者正在
+        // Pump 时等它退出：关闭后 Pump 只丢弃任务，很快就会返回)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (closed_.load(std::memory_order_relaxed)) {
+            bool nested = false;
+            while (!AcquireConsumer(nested)) {
+                std::this_thread::yield();
+            }
+            DrainAll();
+            ReleaseConsumer(nested);
+        }
+        return true;
+    }
+
+    void HostDispatcher::NotifyHost() {
+        if (waiters_.load() != 0) {
+            { std::lock_guard<std::mutex> lock(wait_mutex_); }
+            wait_cv_.notify_all();
+        }
+        if (!has_wake_handler_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::shared_ptr<const std::function<void()>> handler;
+        {
+            std::lock_guard<std::mutex> lock(handler_mutex_);
+            handler = wake_handler_;
+        }
+        if (handler) {
+            try {
+                (*handler)();
+            }
+            catch (...) {
+                // 唤醒回调的失败不能影响发布者；宿主仍可按 WaitFor / 定时 Pump
+            }
+        }
+    }
+
+    size_t HostDispatcher::Pump(size_t max_tasks) {
+        bool nested = false;
+        if (!AcquireConsumer(nested)) {
+            return 0;
+        }
+        struct ConsumerScope {
+            HostDispatcher* self;
+            bool nested;
+            ~ConsumerScope() { self->ReleaseConsumer(nested); }
+        } scope{ this, nested };
+
+        size_t executed = 0;
+        while (executed < max_tasks) {
+            Node* node = PopNode();
+            if (!node) {
+                break;
+            }
+            EventTask task = std::move(node->task);
+            FreeNode(node);
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            if (IsClosed()) {
+                continue;  // 已关闭：owner_ 可能已析构，只丢弃
+            }
+            owner_->RunEventTask(task);
+            ++executed;
+        }
+        return executed;
+    }
+
+    bool HostDispatcher::WaitForImpl(std::chrono::nanoseconds timeout) {
+        if (pending_.load() != 0) {
+            return true;
+        }
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        waiters_.fetch_add(1);
+        wait_cv_.wait_for(lock, timeout, [this]() {
+            return woken_ || pending_.load() != 0 || IsClosed();
+            });
+        waiters_.fetch_sub(1);
+        woken_ = false;
+        return pending_.load() != 0;
+    }
+
+    void HostDispatcher::Wake() {
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            woken_ = true;
+        }
+        wait_cv_.notify_all();
+    }
+
+    void HostDispatcher::SetWakeHandler(std::function<void()> handler) {
+        std::shared_ptr<const std::function<void()>> replaced;
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        replaced = std::move(wake_handler_);
+        if (handler) {
+            wake_handler_ =
+                std::make_shared<const std::function<void()>>(std::move(handler));
+        }
+        has_wake_handler_.store(static_cast<bool>(wake_handler_),
+            std::memory_order_release);
+    }
+
+    void HostDispatcher::DiscardPending() {
+        bool nested = false;
+        if (!AcquireConsumer(nested)) {
+            return;  // 宿主正在 Pump：关闭后由它丢弃
+        }
+        DrainAll();
+        ReleaseConsumer(nested);
+    }
+
+    void HostDispatcher::Close() {
+        closed_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // 与 Post 配对
+        DiscardPending();
+        SetWakeHandler(nullptr);
+        Wake();
+    }
+
+}  // namespace z3y
@@ -0,0 +1,141 @@
+/**
+ * @file host_dispatcher.h
+ * @brief [内部] 定义 z3y::HostDispatcher，EventDispatcher 的实现。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 收件箱是 Vyukov 式的侵入式 MPSC 链表：
+ * - Post (任意线程)：一次原子交换接到链尾，无锁、无等待；
+ * - Pump (宿主线程)：从链头逐个取出并经由 PluginManager::RunEventTask 执行；
+ * 单消费者由 consumer_ 保证 (同一线程可以嵌套 Pump)。
+ *
+ * 结点来自 internal::PoolAllocator，稳态下投递不调用 malloc。
+ * pending_ 记录未执行的任务数，它由 0 变 1 时才唤醒宿主
+ * (条件变量只在宿主确实在 WaitFor 时才加锁通知)。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_HOST_DISPATCHER_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_HOST_DISPATCHER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "framework/event_dispatcher.h"
+#include "event_task.h"
+
+namespace z3y {
+
+    class PluginManager;
+
+    /**
+     * @class HostDispatcher
+     * @brief [!! 新增 !!] 具名宿主调度器。
+     */
+    class HostDispatcher final : public EventDispatcher {
+    public:
+        HostDispatcher(PluginManager* owner, std::string name, unsigned slot);
+        ~HostDispatcher() override;
+
+        const std::string& Name() const override { return name_; }
+        size_t Pump(size_t max_tasks) override;
+        size_t Pending() const override {
+            return pending_.load(std::memory_order_relaxed);
+        }
+        void Wake() override;
+        void SetWakeHandler(std::function<void()> handler) override;
+        bool IsClosed() const override {
+            return closed_.load(std::memory_order_acquire);
+        }
+
+        // --- [内部] 由 PluginManager 调用 ---
+
+        /**
+         * @brief [任意线程] 把任务放入收件箱。
+         * @return false 表示调度器已关闭 (任务被销毁，未执行)。
+         */
+        bool Post(EventTask task);
+
+        /**
+         * @brief 丢弃尚未执行的任务 (UnloadAllPlugins 之前)。
+         * @note 其他线程正在 Pump 时什么也不做。
+         */
+        void DiscardPending();
+
+        /**
+         * @brief 关闭：不再接收任务，丢弃残留任务，唤醒等待者。
+         */
+        void Close();
+
+    protected:
+        bool WaitForImpl(std::chrono::nanoseconds timeout) override;
+
+    private:
+        struct Node {
+            std::atomic<Node*> next{ nullptr };
+            EventTask task;
+        };
+
+        void Push(Node* node);
+
+        /**
+         * @brief [消费者] 取出链头的结点；链表为空或生产者尚未链接完成时返回 nullptr。
+         */
+        Node* PopNode();
+
+        /**
+         * @brief 成为消费者 (调用线程已是消费者时 nested 为 true)。
+         */
+        bool AcquireConsumer(bool& nested);
+        void ReleaseConsumer(bool nested);
+
+        /**
+         * @brief [消费者] 销毁收件箱中的所有任务。
+         */
+        void DrainAll();
+
+        /**
+         * @brief 收件箱由空变为非空：唤醒 WaitFor 并调用唤醒回调。
+         */
+        void NotifyHost();
+
+        static Node* AllocateNode(EventTask task);
+        static void FreeNode(Node* node) noexcept;
+
+        static constexpr size_t kCacheLine = 64;
+
+        PluginManager* const owner_;
+        const std::string name_;
+
+        // 生产者端 (链尾) 与消费者端 (链头) 分处不同缓存行
+        alignas(kCacheLine) std::atomic<Node*> back_;
+        alignas(kCacheLine) Node* front_;
+        Node stub_;
+        std::atomic<std::thread::id> consumer_{};
+
+        alignas(kCacheLine) std::atomic<size_t> pending_{ 0 };
+        std::atomic<bool> closed_{ false };
+
+        // 唤醒：只在宿主 WaitFor 时 (waiters_ 非零) 才加锁通知
+        std::atomic<int> waiters_{ 0 };
+        std::mutex wait_mutex_;
+        std::condition_variable wait_cv_;
+        bool woken_ = false;  // 由 wait_mutex_ 保护
+
+        std::mutex handler_mutex_;
+        std::shared_ptr<const std::function<void()>> wake_handler_;
+        std::atomic<bool> has_wake_handler_{ false };
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_HOST_DISPATCHER_H_
@@ -31,11 +31,20 @@
 #if !defined(_WIN32)
 
 #include "plugin_manager.h"
+#include "shared_memory.h" // [!! 新增 !!]
 #include "framework/framework_events.h"
 #include "framework/i_plugin_registry.h"
 #include <dlfcn.h>  // POSIX 动态库头文件
+#include <fcntl.h>     // [!! 新增 !!] shm_open
+#include <sys/mman.h>  // [!! 新增 !!] mmap
+#include <sys/stat.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <stdexcept>
+#include <thread>
 #include <string> // [!! 
                   // 新增 !!]
 
@@ -236,6 +245,77 @@ namespace z3y {
     }
 
 
+    // --- [!! 新增 !!] 共享内存 (事件桥) ---
+
+    namespace {
+        /**
+         * @brief [POSIX] 共享内存对象名 (以 '/' 开头，不含其他 '/')。
+         */
+        std::string SharedMemoryPath(const std::string& name) {
+            std::string path = "/z3y." + name;
+            std::replace(path.begin() + 1, path.end(), '/', '_');
+            return path;
+        }
+    }  // 匿名命名空间
+
+    std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::OpenOrCreate(
+        const std::string& name, size_t size, bool& created,
+        std::string& error) {
+        const std::string path = SharedMemoryPath(name);
+
+        created = true;
+        int fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0 && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            error = "ftruncate failed: " + std::string(std::strerror(errno));
+            ::close(fd);
+            ::shm_unlink(path.c_str());
+            return nullptr;
+        }
+        if (fd < 0 && errno == EEXIST) {
+            created = false;
+            fd = ::shm_open(path.c_str(), O_RDWR, 0600);
+        }
+        if (fd < 0) {
+            error = "shm_open failed: " + std::string(std::strerror(errno));
+            return nullptr;
+        }
+
+        if (!created) {
+            // 创建者在 shm_open 与 ftruncate 之间时大小仍为 0，稍等片刻
+            struct stat info {};
+            for (int attempt = 0; attempt < 1000; ++attempt) {
+                if (::fstat(fd, &info) != 0 || info.st_size > 0) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (info.st_size <= 0) {
+                error = "shared memory '" + name + "' has no size";
+                ::close(fd);
+                return nullptr;
+            }
+            size = static_cast<size_t>(info.st_size);
+        }
+
+        void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            fd, 0);
+        ::close(fd);  // 映射保持有效
+        if (data == MAP_FAILED) {
+            error = "mmap failed: " + std::string(std::strerror(errno));
+            return nullptr;
+        }
+        return std::unique_ptr<SharedMemoryRegion>(
+            new SharedMemoryRegion(data, size, nullptr));
+    }
+
+    void SharedMemoryRegion::Remove(const std::string& name) {
+        ::shm_unlink(SharedMemoryPath(name).c_str());
+    }
+
+    SharedMemoryRegion::~SharedMemoryRegion() {
+        ::munmap(data_, size_);
+    }
+
 }  // namespace z3y
 
 #endif  // !defined(_WIN32)
\ No newline at end of file
@@ -30,6 +30,7 @@
 #ifdef _WIN32
 
 #include "plugin_manager.h"
+#include "shared_memory.h" // [!! 新增 !!]
 #include "framework/framework_events.h"
 #include "framework/i_plugin_registry.h"
 #include <Windows.h>
@@ -283,6 +284,62 @@ namespace z3y {
     }
 
 
+    // --- [!! 新增 !!] 共享内存 (事件桥) ---
+
+    namespace {
+        /**
+         * @brief [Win32] 映射对象名 (会话内可见)。
+         */
+        std::wstring SharedMemoryPath(const std::string& name) {
+            std::wstring path = L"Local\\z3y.";
+            int size = MultiByteToWideChar(CP_UTF8, 0, name.c_str(),
+                (int)name.length(), NULL, 0);
+            std::wstring w_name(size, 0);
+            MultiByteToWideChar(CP_UTF8, 0, name.c_str(), (int)name.length(),
+                &w_name[0], size);
+            std::replace(w_name.begin(), w_name.end(), L'\\', L'_');
+            return path + w_name;
+        }
+    }  // 匿名命名空间
+
+    std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::OpenOrCreate(
+        const std::string& name, size_t size, bool& created,
+        std::string& error) {
+        const std::wstring path = SharedMemoryPath(name);
+        const unsigned long long size64 = size;
+
+        // 页面文件支持的映射；已存在时忽略 size 并打开已有对象
+        HANDLE mapping = ::CreateFileMappingW(INVALID_HANDLE_VALUE, NULL,
+            PAGE_READWRITE, static_cast<DWORD>(size64 >> 32),
+            static_cast<DWORD>(size64 & 0xFFFFFFFFULL), path.c_str());
+        if (mapping == NULL) {
+            error = "CreateFileMappingW failed: " + std::to_string(::GetLastError());
+            return nullptr;
+        }
+        created = (::GetLastError() != ERROR_ALREADY_EXISTS);
+
+        void* data = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (data == NULL) {
+            error = "MapViewOfFile failed: " + std::to_string(::GetLastError());
+            ::CloseHandle(mapping);
+            return nullptr;
+        }
+
+        MEMORY_BASIC_INFORMATION info = {};
+        ::VirtualQuery(data, &info, sizeof(info));
+        return std::unique_ptr<SharedMemoryRegion>(
+            new SharedMemoryRegion(data, info.RegionSize, mapping));
+    }
+
+    void SharedMemoryRegion::Remove(const std::string&) {
+        // Win32 映射对象在最后一个句柄关闭时自动销毁
+    }
+
+    SharedMemoryRegion::~SharedMemoryRegion() {
+        ::UnmapViewOfFile(data_);
+        ::CloseHandle(static_cast<HANDLE>(handle_));
+    }
+
 }  // namespace z3y
 
 #endif  // _WIN32
\ No newline at end of file
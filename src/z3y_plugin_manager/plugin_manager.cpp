@@ -21,6 +21,7 @@
 
 #include "plugin_manager.h"
 #include "framework/i_plugin_query.h"
+#include "event_bridge.h" // [!! 新增 !!] clsid::kEventBridge 的实现
 #include "framework/framework_events.h" // [!! 
  // 新增 !!]
 #include <algorithm> // [新] 用于 std::find_if
@@ -72,7 +73,8 @@ namespace z3y {
     /**
      * @brief [工厂函数] 创建 PluginManager 的一个新实例。
      */
-    PluginPtr<PluginManager> PluginManager::Create() {
+    PluginPtr<PluginManager> PluginManager::Create(
+        const PluginManagerOptions& options) {
         struct MakeSharedEnabler : public PluginManager {
             MakeSharedEnabler() : PluginManager() {}
         };
@@ -137,6 +139,22 @@ namespace z3y {
                   // 
         );
 
+        // [!! 新增 !!] 注册 IEventStats 服务 (同样由 PluginManager 自身实现)
+        manager->RegisterComponent(
+            clsid::kEventStats,
+            factory,
+            true, "z3y.core.eventstats", iids,
+            false
+        );
+
+        // [!! 新增 !!] 注册 IEventBridge 服务 (Open 之前不占用任何资源)
+        manager->RegisterComponent(
+            clsid::kEventBridge,
+            []() -> PluginPtr<IComponent> { return std::make_shared<EventBridge>(); },
+            true, "z3y.core.eventbridge", EventBridge::GetInterfaceDetails(),
+            true
+        );
+
         // 4. [可选] 注册 PluginManager "实现" 本身
         manager->RegisterComponent(
             PluginManager::kClsid,  // [修改] 
@@ -150,9 +168,32 @@ namespace z3y {
 
 
         // 5. [修正]：
-        // 启动事件循环工作线程
-        manager->event_loop_thread_ =
-            std::thread(&PluginManager::EventLoop, manager.get());
+        // [!! 修改 !!] 启动事件循环工作线程池
+        manager->options_ = options;
+        size_t worker_count = options.event_worker_count;
+        if (worker_count == 0) {
+            worker_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        manager->options_.event_worker_count = worker_count;
+        for (auto& lane_queue : manager->event_queues_) {
+            lane_queue = std::make_unique<EventRingBuffer<EventTask>>(
+                std::max<size_t>(1, options.event_queue_capacity));
+        }
+        for (uint32_t& weight : manager->options_.event_lane_weights) {
+            weight = std::max<uint32_t>(1, weight);
+        }
+        for (size_t i = 0; i < worker_count; ++i) {
+            auto worker_queue = std::make_unique<WorkerQueue>();
+            for (size_t lane = 0; lane < kEventPriorityCount; ++lane) {
+                worker_queue->credits[lane] =
+                    manager->options_.event_lane_weights[lane];
+            }
+            manager->worker_queues_.push_back(std::move(worker_queue));
+        }
+        for (size_t i = 0; i < worker_count; ++i) {
+            manager->event_workers_.emplace_back(&PluginManager::EventLoop,
+                manager.get(), i);
+        }
 
         // 6. 获取 IEventBus 接口 (现在使用自己的ID)
         try {
@@ -180,7 +221,28 @@ namespace z3y {
      * @brief 默认构造函数（受保护）。
      */
     PluginManager::PluginManager()
-        : running_(true), current_added_components_(nullptr), event_trace_hook_(nullptr) { // [修改] 初始化 event_trace_hook_
+        : current_added_components_(nullptr),
+        global_subscribers_(std::make_shared<const EventMap>()),
+        sender_subscribers_(std::make_shared<const SenderIndex>()),
+        gc_sweep_pending_(false),
+        gc_requested_(false),
+        gc_slices_(0),
+        gc_subscriptions_reclaimed_(0),
+        gc_lookup_entries_reclaimed_(0),
+        local_task_counts_{},
+        running_(true),
+        timer_sequence_(0),
+        next_timer_deadline_(kNoTimer),
+        timer_keeper_claimed_(false),
+        queue_dropped_oldest_(0),
+        queue_dropped_newest_(0),
+        queue_rejected_(0),
+        queue_blocked_(0),
+        queue_coalesced_(0) {
+        for (auto& lane_queue : event_queues_) {
+            lane_queue = std::make_unique<EventRingBuffer<EventTask>>(
+                PluginManagerOptions().event_queue_capacity);
+        }
     }
 
     /**
@@ -192,13 +254,33 @@ namespace z3y {
      */
     PluginManager::~PluginManager() {
         // 1. 停止工作线程
+        running_.store(false, std::memory_order_release);
+        work_available_.NotifyAll();
+        space_available_.NotifyAll();
+        for (std::thread& worker : event_workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        // [!! 新增 !!] 停止隔离线程 (看门狗降级的订阅者)
         {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            running_ = false;
+            std::lock_guard<std::mutex> lock(isolated_mutex_);
+            isolated_stopping_ = true;
         }
-        queue_cv_.notify_one();
-        if (event_loop_thread_.joinable()) {
-            event_loop_thread_.join();
+        isolated_cv_.notify_all();
+        if (isolated_thread_.joinable()) {
+            isolated_thread_.join();
+        }
+        // [!! 新增 !!] 关闭宿主调度器：宿主仍持有的句柄不再回调本对象
+        {
+            std::unordered_map<std::string, std::shared_ptr<HostDispatcher>> closing;
+            {
+                std::lock_guard<std::mutex> lock(dispatcher_mutex_);
+                closing.swap(dispatchers_);
+            }
+            for (auto& pair : closing) {
+                pair.second->Close();
+            }
         }
 
         // 2. [!! 核心操作 !!] 清除静态实例指针
@@ -217,14 +299,35 @@ namespace z3y {
     }
 
     /**
-     * @brief [!! 新增 !!] 设置事件追踪钩子。
+     * @brief [!! 新增 !!] 开始事件追踪。
+     */
+    void PluginManager::StartEventTrace(const EventTraceOptions& options)
+    {
+        event_trace_.Start(options);
+    }
+
+    /**
+     * @brief [!! 新增 !!] 停止事件追踪。
      */
-     // [!! 修复 !!] 签名必须与 .h 文件中的声明匹配
-     // 移除多余的 std::function<> 包装
-    void PluginManager::SetEventTraceHook(EventTraceHook hook)
+    void PluginManager::StopEventTrace()
     {
-        std::lock_guard<std::recursive_mutex> lock(event_mutex_);
-        event_trace_hook_ = std::move(hook);
+        event_trace_.Stop();
+    }
+
+    /**
+     * @brief [!! 新增 !!] 获取追踪记录。
+     */
+    std::vector<EventTraceRecord> PluginManager::GetEventTrace() const
+    {
+        return event_trace_.Snapshot();
+    }
+
+    /**
+     * @brief [!! 新增 !!] 导出 Chrome trace / Perfetto JSON。
+     */
+    void PluginManager::ExportEventTrace(std::ostream& out) const
+    {
+        event_trace_.ExportChromeTrace(out);
     }
 
     /**
@@ -242,15 +345,86 @@ namespace z3y {
         // 
         // 
         // 
-        std::scoped_lock lock(registry_mutex_, event_mutex_, queue_mutex_);
+        // [!! 新增 !!] 0. 先在本线程上触发所有定时器 (不持有任何锁)：
+        // NextFor 等到 nullopt，Next 以 kErrorEventWaitCancelled 结束，
+        // 挂起的协程不会因为下面清空订阅与定时器而永远无法恢复
+        FireAllTimersForClear();
+
+        std::scoped_lock lock(registry_mutex_, event_mutex_);
 
         // [修正] 1. 
-        event_queue_ = {};
+        EventTask discarded;
+        for (auto& lane_queue : event_queues_) {
+            while (lane_queue->TryPop(discarded)) {
+                discarded = nullptr;
+            }
+        }
+        space_available_.NotifyAll();
+        {
+            std::lock_guard<std::mutex> isolated_lock(isolated_mutex_);
+            isolated_tasks_.clear();
+        }
+        // [!! 新增 !!] 宿主调度器本身保留 (句柄属于宿主)，只丢弃插件的任务
+        DiscardDispatcherTasks();
+        for (auto& worker_queue : worker_queues_) {
+            std::lock_guard<std::mutex> worker_lock(worker_queue->mutex);
+            for (size_t lane = 0; lane < kEventPriorityCount; ++lane) {
+                local_task_counts_[lane].fetch_sub(
+                    worker_queue->tasks[lane].size());
+                worker_queue->tasks[lane].clear();
+            }
+        }
         gc_queue_ = {};
-        sender_subscribers_.clear();
-        global_subscribers_.clear();
+        {
+            std::lock_guard<std::mutex> timer_lock(timer_mutex_);
+            timers_ = {};  // 只剩 FireAllTimersForClear 之后新登记的
+            clear_only_timers_.clear();
+            clear_only_timers_purge_at_ = 64;
+            next_timer_deadline_.store(kNoTimer, std::memory_order_relaxed);
+        }
+        // [!! 新增 !!] 所有订阅被移除，连接句柄随之断开
+        auto disconnect = [](const EventCallbackList& list) {
+            for (const Subscription& sub : list) {
+                if (sub.connection) {
+                    sub.connection->MarkDisconnected();
+                }
+            }
+            };
+        for (const auto& pair : *global_subscribers_.Load()) {
+            disconnect(*pair.second);
+        }
+        sender_subscribers_.Load()->ForEach([&](const SenderIndex::Entry& entry) {
+            disconnect(*entry.value);
+            });
+        sender_subscribers_.Store(std::make_shared<const SenderIndex>());
+        category_sender_keys_.clear();  // [!! 新增 !!]
+        global_subscribers_.Store(std::make_shared<const EventMap>());
+        global_filter_.Clear();
+        sender_filter_.Clear();
+        gc_sweep_pending_.store(false, std::memory_order_relaxed);
+        gc_global_cursor_.clear();
+        gc_sender_cursor_.clear();
+        {
+            std::lock_guard<std::mutex> pending_lock(gc_disconnect_mutex_);
+            gc_disconnected_.clear();
+        }
         global_sub_lookup_.clear();
         sender_sub_lookup_.clear();
+        subscriber_strands_.clear();
+        {
+            // [!! 新增 !!] 看门狗记录持有插件对象的 weak_ptr (控制块属于插件)
+            std::lock_guard<std::mutex> watchdog_lock(watchdog_mutex_);
+            slow_subscribers_.clear();
+        }
+        instance_origins_.clear();
+        instance_origins_purge_at_ = 64;
+        {
+            // [!! 新增 !!] 保留事件可能属于即将卸载的插件，必须在卸载前释放
+            std::lock_guard<std::mutex> retained_lock(retained_mutex_);
+            retained_global_.clear();
+            retained_sender_.clear();
+            retained_sender_purge_at_ = kRetainedSenderPurgeMin;
+        }
 
         // [修正] 2. 
         // Note: singletons_, components_, alias_map_, default_map_ are now unordered_map.
@@ -262,8 +436,7 @@ namespace z3y {
         current_loading_plugin_path_.clear();
         current_added_components_ = nullptr;
 
-        // [新增] 3. 清理 Hook
-        event_trace_hook_ = nullptr;
+        // [修改] 3. 追踪记录不引用插件代码，重置时保留 (追踪不中断)
 
         // [修正] 4. [!! 
         //    重构 !!] 
@@ -519,7 +692,7 @@ namespace z3y {
         auto iids = PluginManager::GetInterfaceDetails();
 
 
-        // 6. 在锁外重新引导核心服务 (IEventBus / IPluginQuery)
+        // 6. 在锁外重新引导核心服务 (IEventBus / IPluginQuery / IEventStats)
         // (
         // 
         // 
@@ -538,6 +711,19 @@ namespace z3y {
             false // [!! 
                   // 修复 !!]
         );
+        RegisterComponent(
+            clsid::kEventStats, factory,
+            true /* is_singleton */, "z3y.core.eventstats" /* alias */,
+            iids,
+            false
+        );
+        RegisterComponent(
+            clsid::kEventBridge,
+            []() -> PluginPtr<IComponent> { return std::make_shared<EventBridge>(); },
+            true /* is_singleton */, "z3y.core.eventbridge" /* alias */,
+            EventBridge::GetInterfaceDetails(),
+            true
+        );
         RegisterComponent(
             PluginManager::kClsid, std::move(factory),  // [修改] 
             // 使用 PluginManager::kClsid
@@ -731,6 +917,50 @@ pair.second.implemented_interfaces
         return details_list;
     }
 
+    /**
+     * @brief [!! 新增 !!] 登记 CreateInstance 创建的组件实例。
+     * @details 键为实例的控制块 (owner 比较)，因此订阅者只要与组件共享所有权
+     * (例如组件内 shared_from_this() 订阅) 就能找到。
+     * 表增长到上次清理后的两倍时剔除已析构的实例。
+     */
+    void PluginManager::NoteInstanceOrigin(const PluginPtr<IComponent>& instance,
+        ClassId clsid) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        if (instance_origins_.size() >= instance_origins_purge_at_) {
+            for (auto it = instance_origins_.begin(); it != instance_origins_.end();) {
+                it = it->first.expired() ? instance_origins_.erase(it) : std::next(it);
+            }
+            instance_origins_purge_at_ =
+                std::max<size_t>(64, instance_origins_.size() * 2);
+        }
+        instance_origins_[std::weak_ptr<void>(instance)] = clsid;
+    }
+
+    /**
+     * @brief [!! 新增 !!] 查找订阅者所属组件的插件路径。
+     * @details 先查 CreateInstance 创建的实例，再查已缓存的服务单例。
+     */
+    std::string PluginManager::FindSubscriberPlugin(
+        const std::weak_ptr<void>& subscriber) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        ClassId clsid = 0;
+        auto origin = instance_origins_.find(subscriber);
+        if (origin != instance_origins_.end()) {
+            clsid = origin->second;
+        }
+        else {
+            for (const auto& pair : singletons_) {
+                if (!pair.second.owner_before(subscriber) &&
+                    !subscriber.owner_before(pair.second)) {
+                    clsid = pair.first;
+                    break;
+                }
+            }
+        }
+        auto it = components_.find(clsid);
+        return it != components_.end() ? it->second.source_plugin_path : std::string();
+    }
+
     bool PluginManager::GetComponentDetails(ClassId clsid,
         ComponentDetails& out_details) {
         // Note: components_ is now unordered_map.
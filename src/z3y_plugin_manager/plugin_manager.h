@@ -16,6 +16,7 @@
 #include "framework/i_plugin_registry.h"
 #include "framework/i_event_bus.h"
 #include "framework/i_plugin_query.h"
+#include "framework/i_event_stats.h"  // [!! 新增 !!]
 #include "framework/plugin_impl.h"
 #include "framework/plugin_cast.h"
 #include "framework/framework_events.h"
@@ -38,27 +39,142 @@
 #include <typeindex>
 #include <vector>
 #include <sstream> // [!! 修正 !!] 
+#include <atomic>  // [!! 新增 !!] 用于 COW 快照
+#include <chrono>
+#include <array>
+#include <limits>
+
+#include "snapshot_ptr.h" // [!! 新增 !!] 订阅表快照
+#include "event_ring_buffer.h" // [!! 新增 !!] 有界异步队列
+#include "event_count.h"       // [!! 新增 !!] 工作线程唤醒
+#include "event_task.h"        // [!! 新增 !!] 无分配的异步任务
+#include "subscription_filter.h" // [!! 新增 !!] 无订阅事件的快速否定
+#include "flat_sender_index.h"   // [!! 新增 !!] 实例订阅表
+#include "event_trace.h"         // [!! 新增 !!] 二进制事件追踪
+#include "event_stats.h"         // [!! 新增 !!] 事件统计直方图
+#include "host_dispatcher.h"     // [!! 新增 !!] 具名宿主调度器
 
 // [新] 引入辅助宏
 #include "framework/component_helpers.h" 
 
 namespace z3y {
 
-    // [!! 新增 !!]
-    enum class EventTracePoint {
-        kEventFired,           //!< 事件被发布
-        kDirectCallStart,      //!< 同步回调执行开始
-        kQueuedEntry,          //!< 事件被推入异步队列
-        kQueuedExecuteStart,   //!< 事件在工作线程中开始执行
-        kQueuedExecuteEnd,     //!< 事件在工作线程中执行结束 (EventTask完成)
+    /**
+     * @enum QueueOverflowPolicy
+     * @brief [!! 新增 !!] 异步事件队列已满时的处理策略。
+     * @note 工作线程自身发布时任务进入它的本地队列；所有工作线程的本地队列
+     * 在每个通道合计同样以 event_queue_capacity 为上限，达到上限时应用同一策略，
+     * 唯一的例外是 kBlock：工作线程是消费者，阻塞它会造成死锁，
+     * 因此它在工作线程上按 kDropNewest 处理 (计入 dropped_newest)。
+     */
+    enum class QueueOverflowPolicy {
+        kBlock,       //!< 阻塞发布者，直到队列有空位 (默认)
+        kDropOldest,  //!< 丢弃队列中最旧的任务，再入队
+        kDropNewest,  //!< 丢弃本次要入队的任务
+        kReject,      //!< 抛出 PluginException (kErrorEventQueueFull)
+    };
+
+    /**
+     * @struct PluginManagerOptions
+     * @brief [!! 新增 !!] PluginManager::Create 的创建选项。
+     */
+    struct PluginManagerOptions {
+        /**
+         * @brief 处理 kQueued 事件的工作线程数量。
+         * 1 (默认) 即原有的单一事件循环线程行为；
+         * 0 表示使用 std::thread::hardware_concurrency()。
+         */
+        size_t event_worker_count = 1;
+
+        /**
+         * @brief [!! 新增 !!] 异步事件队列的容量 (预分配，向上取整为 2 的幂)。
+         * [!! 修改 !!] 每个优先级通道各有一个该容量的队列。
+         */
+        size_t event_queue_capacity = 65536;
+
+        /**
+         * @brief [!! 新增 !!] 异步事件队列已满时的处理策略。
+         */
+        QueueOverflowPolicy event_queue_overflow_policy =
+            QueueOverflowPolicy::kBlock;
+
+        /**
+         * @brief [!! 新增 !!] 每个 GC 时间片的预算。
+         * 失效订阅的清扫与反向查找表的回收被切成小批次，
+         * 超出预算后让出工作线程，剩余工作稍后继续。
+         */
+        std::chrono::microseconds event_gc_slice_budget =
+            std::chrono::microseconds(1000);
+
+        /**
+         * @brief [!! 新增 !!] 各优先级通道的加权轮转权重 (按 EventPriority 下标)。
+         * 每个工作线程在一个轮转周期内最多从通道 i 连续取 weights[i] 个任务；
+         * 因此只要低优先级通道非空，它在每 (权重之和) 个任务中至少被服务一次。
+         * 权重为 0 时按 1 处理。
+         */
+        std::array<uint32_t, kEventPriorityCount> event_lane_weights = {
+            1,   // kLow
+            4,   // kNormal
+            16,  // kHigh
+        };
+
+        /**
+         * @brief [!! 新增 !!] 慢回调看门狗：工作线程上单个回调的时间预算。
+         * 超时的回调在返回后通过 event::SlowCallbackEvent 与
+         * IEventStats::GetSlowSubscribers 报告。0 表示关闭看门狗。
+         */
+        std::chrono::microseconds slow_callback_budget =
+            std::chrono::milliseconds(100);
+
+        /**
+         * @brief [!! 新增 !!] 订阅者累计超时达到该次数后，
+         * 它的异步订阅被降级到隔离通道：由一个独立线程按顺序执行，
+         * 不再占用工作线程池。0 (默认) 表示从不降级。
+         */
+        uint32_t slow_callback_demote_after = 0;
+
+        /**
+         * @brief [!! 新增 !!] 并行扇出：一次发布中共享异步任务的 kQueued 订阅
+         * 多于该数量时，每该数量个拆成一个任务，由工作线程池并行执行
+         * (否则整个扇出在一个工作线程上串行执行)。
+         * 0 表示从不拆分；只有一个工作线程时也不拆分。
+         * 同一块内按订阅顺序执行，块与块之间不保证顺序；需要按发布顺序
+         * 接收的订阅者应使用 kQueuedOrdered (不受拆分影响)。
+         */
+        size_t event_fan_out_chunk_size = 64;
     };
 
-    // [!! 修复：在此处添加类型定义 !!]
     /**
-     * @brief 事件追踪钩子 (Hook) 的函数签名
+     * @struct EventQueueStats
+     * @brief [!! 新增 !!] 异步事件队列的运行时计数器。
      */
-    using EventTraceHook = std::function<void(
-        EventTracePoint, EventId, void*, const char*)>;
+    struct EventQueueStats {
+        size_t capacity;          //!< 队列容量
+        size_t depth;             //!< 当前深度 (近似值，所有通道之和)
+        uint64_t dropped_oldest;  //!< kDropOldest 丢弃的任务数
+        uint64_t dropped_newest;  //!< kDropNewest 丢弃的任务数
+        uint64_t rejected;        //!< kReject 拒绝的任务数
+        uint64_t blocked;         //!< kBlock 下发布者被阻塞的次数
+        //! [!! 新增 !!] 各优先级通道的当前深度 (近似值，按 EventPriority 下标)
+        std::array<size_t, kEventPriorityCount> lane_depth;
+        //! [!! 新增 !!] 各优先级通道已执行的任务数
+        std::array<uint64_t, kEventPriorityCount> lane_executed;
+        //! [!! 新增 !!] kQueuedCoalesced 合并掉 (未投递) 的事件数
+        uint64_t coalesced;
+    };
+
+    /**
+     * @struct EventGcStats
+     * @brief [!! 新增 !!] 失效订阅回收 (GC) 的计数器。
+     */
+    struct EventGcStats {
+        bool sweep_requested;              //!< Fire 路径发现失效订阅，尚未开始清扫
+        size_t pending_sweep_keys;         //!< 当前清扫尚未处理的订阅表键数
+        size_t pending_lookup_entries;     //!< gc_queue_ 中尚未回收的反向查找项
+        uint64_t slices;                   //!< 已执行的 GC 时间片数
+        uint64_t subscriptions_reclaimed;  //!< 已从快照中剔除的失效订阅数
+        uint64_t lookup_entries_reclaimed; //!< 已回收的反向查找项数
+    };
 
     namespace clsid {
         /**
@@ -72,6 +188,8 @@ namespace z3y {
          //     ConstexprHash("z3y-core-plugin-manager-IMPL-UUID");
     }  // namespace clsid
 
+    class EventBridge;
+
     /**
      * @class PluginManager
      * @brief [框架核心] 插件管理器。
@@ -86,7 +204,8 @@ namespace z3y {
         // 移除 kClsid 
         // 参数
         IEventBus,
-        IPluginQuery>
+        IPluginQuery,
+        IEventStats>  // [!! 新增 !!]
     {
     public:
         /**
@@ -101,6 +220,11 @@ namespace z3y {
         static PluginPtr<PluginManager> s_ActiveInstance;
         static std::mutex s_InstanceMutex;
 
+        // [!! 新增 !!] 事件桥以类型擦除的方式订阅 / 重新发布 (受保护的 *Impl)
+        friend class EventBridge;
+        // [!! 新增 !!] 宿主调度器在宿主线程上经由 RunEventTask 执行任务
+        friend class HostDispatcher;
+
     public:
         /**
          * @brief [!! 新增 !!] 插件或核心模块用于获取当前 PluginManager 实例的入口。
@@ -110,8 +234,10 @@ namespace z3y {
 
         /**
          * @brief [工厂函数] 创建 PluginManager 的一个新实例。
+         * @param[in] options [!! 新增 !!] 创建选项 (如异步工作线程数量)。
          */
-        static PluginPtr<PluginManager> Create();
+        static PluginPtr<PluginManager> Create(
+            const PluginManagerOptions& options = PluginManagerOptions());
 
         /**
          * @brief 析构函数。
@@ -153,15 +279,37 @@ namespace z3y {
          */
         void UnloadAllPlugins();
 
-        // [!! 修复：在此处添加函数声明 !!]
         /**
-         * @brief [!! 新增 !!] 设置一个事件追踪钩子，用于诊断。
-         * @param[in] hook
-         * 一个 std::function,
-         * 匹配 EventTraceHook
-         * 签名。
+         * @brief [!! 新增 !!] 开始事件追踪 (丢弃之前的记录)。
+         * @details 取代原来的 EventTraceHook：追踪点写入每线程的二进制环，
+         * 开销足够低，可以在负载下长期开启 (配合 sample_every 采样)。
+         */
+        void StartEventTrace(const EventTraceOptions& options = EventTraceOptions());
+
+        /**
+         * @brief [!! 新增 !!] 停止事件追踪 (已有记录保留，仍可导出)。
          */
-        void SetEventTraceHook(EventTraceHook hook);
+        void StopEventTrace();
+
+        /**
+         * @brief [!! 新增 !!] 获取当前的追踪记录 (按时间排序，可在追踪进行中调用)。
+         */
+        std::vector<EventTraceRecord> GetEventTrace() const;
+
+        /**
+         * @brief [!! 新增 !!] 以 Chrome trace / Perfetto JSON 格式导出追踪记录。
+         */
+        void ExportEventTrace(std::ostream& out) const;
+
+        /**
+         * @brief [!! 新增 !!] 获取异步事件队列的计数器 (深度、丢弃数等)。
+         */
+        EventQueueStats GetEventQueueStats() const;
+
+        /**
+         * @brief [!! 新增 !!] 获取失效订阅回收 (GC) 的计数器。
+         */
+        EventGcStats GetEventGcStats();
 
 
         // --- [!! 
@@ -299,6 +447,62 @@ namespace z3y {
         void FireToSenderImpl(void* sender_key, EventId event_id,
             PluginPtr<Event> e_ptr) override;
 
+        /** @internal [!! 新增 !!] */
+        void FireGlobalBatchImpl(EventId event_id,
+            PluginPtr<EventBatch> batch) override;
+        /** @internal [!! 新增 !!] */
+        void FireToSenderBatchImpl(void* sender_key, EventId event_id,
+            PluginPtr<EventBatch> batch) override;
+
+        /** @internal [!! 新增 !!] */
+        void DeclareEventPriorityImpl(EventId event_id,
+            EventPriority priority) override;
+        void SetEventPriority(EventId event_id,
+            EventPriority priority) override;
+        /** @internal [!! 新增 !!] */
+        void ScheduleTimerImpl(std::chrono::nanoseconds delay,
+            std::weak_ptr<void> owner,
+            EventDelegate cb) override;
+        /** @internal [!! 新增 !!] */
+        void FireGlobalAsyncImpl(EventId event_id, PluginPtr<Event> e_ptr,
+            PluginPtr<EventCompletion> completion) override;
+        /** @internal [!! 新增 !!] */
+        void FireToSenderAsyncImpl(void* sender_key, EventId event_id,
+            PluginPtr<Event> e_ptr,
+            PluginPtr<EventCompletion> completion) override;
+        /** @internal [!! 新增 !!] */
+        void RetainGlobalImpl(EventId event_id,
+            PluginPtr<const Event> e_ptr) override;
+        /** @internal [!! 新增 !!] */
+        void RetainToSenderImpl(void* sender_key,
+            std::weak_ptr<void> sender_id, EventId event_id,
+            PluginPtr<const Event> e_ptr) override;
+        void ClearRetainedEvent(EventId event_id) override;
+        PluginPtr<EventDispatcher> GetDispatcher(
+            const std::string& name) override;
+        void RemoveDispatcher(const std::string& name) override;
+        /** @internal [!! 新增 !!] */
+        void DeclareEventCategoryImpl(EventId event_id,
+            const EventId* ancestors, size_t count) override;
+        /** @internal [!! 新增 !!] */
+        PluginPtr<EventConnectionState> SubscribeGlobalConnectedImpl(
+            EventId event_id,
+            std::weak_ptr<void> sub,
+            EventDelegate cb,
+            EventBatchDelegate batch_cb,
+            EventFilterDelegate filter,
+            ConnectionType connection_type) override;
+        /** @internal [!! 新增 !!] */
+        PluginPtr<EventConnectionState> SubscribeToSenderConnectedImpl(
+            void* sender_key,
+            EventId event_id,
+            std::weak_ptr<void> sub_id,
+            std::weak_ptr<void> sender_id,
+            EventDelegate cb,
+            EventBatchDelegate batch_cb,
+            EventFilterDelegate filter,
+            ConnectionType connection_type) override;
+
         // --- IPluginQuery 接口实现 ---
         std::vector<ComponentDetails> GetAllComponents() override;
         bool GetComponentDetails(ClassId clsid,
@@ -311,6 +515,15 @@ namespace z3y {
         std::vector<ComponentDetails> GetComponentsFromPlugin(
             const std::string& plugin_path) override;
 
+        // --- [!! 新增 !!] IEventStats 接口实现 ---
+        void EnableEventStats(bool enabled) override;
+        bool IsEventStatsEnabled() const override;
+        std::vector<EventStats> GetAllEventStats() const override;
+        bool GetEventStats(EventId event_id, EventStats& out_stats) const override;
+        EventQueueDepthStats GetQueueDepthStats() const override;
+        void ResetEventStats() override;
+        std::vector<SlowSubscriberStats> GetSlowSubscribers() const override;
+
     private:
         /**
          * @brief [!!
@@ -327,8 +540,10 @@ namespace z3y {
 
         /**
          * @brief [内部] 事件循环工作线程的主函数。
+         * @param[in] worker_index [!! 新增 !!] 工作线程序号 (本地队列下标)。
          */
-        void EventLoop();
+        void EventLoop(size_t worker_index);
+
 
         /**
          * @brief [!!
@@ -436,16 +651,111 @@ namespace z3y {
             bool is_default_registration;
         };
 
+        struct EventStrand;
+        struct EventCoalesceSlot;
+        class SubscriptionConnection;
+
         /**
          * @struct Subscription
          */
         struct Subscription {
             std::weak_ptr<void> subscriber_id;
             std::weak_ptr<void> sender_id;
-            std::function<void(const Event&)> callback;
+            /**
+             * @brief [!! 修改 !!] 定长委托 (取代 std::function)。
+             * 分发时以锁定后的 subscriber_id 作为调用目标。
+             */
+            EventDelegate callback;
+            /**
+             * @brief [!! 新增 !!] 批量回调 (SubscribeGlobalBatch 等)。
+             * callback 与 batch_callback 恰有一个非空。
+             */
+            EventBatchDelegate batch_callback;
             ConnectionType connection_type;
+            /**
+             * @brief [!! 新增 !!] 订阅者专属的串行执行器
+             * (仅 kQueuedOrdered 订阅非空)
+             */
+            std::shared_ptr<EventStrand> strand;
+            /**
+             * @brief [!! 新增 !!] 异步投递使用的优先级通道
+             * (订阅时取自 event_priorities_，SetEventPriority 时重新发布)
+             */
+            EventPriority priority = EventPriority::kNormal;
+            /**
+             * @brief [!! 新增 !!] 尚未投递的最新事件
+             * (仅 kQueuedCoalesced 订阅非空；COW 复制的快照共享同一个)
+             */
+            std::shared_ptr<EventCoalesceSlot> coalesce = nullptr;
+            /**
+             * @brief [!! 新增 !!] 发布者线程上的过滤器 (为空表示全部接收)
+             */
+            EventFilterDelegate filter = nullptr;
+            /**
+             * @brief [!! 新增 !!] 订阅的事件 (看门狗报告用)
+             */
+            EventId event_id = 0;
+            /**
+             * @brief [!! 新增 !!] 已被看门狗降级：异步投递走隔离通道
+             */
+            bool isolated = false;
+            /**
+             * @brief [!! 新增 !!] 目标宿主调度器
+             * (仅 IsDispatcherConnection(connection_type) 的订阅非空)
+             */
+            std::shared_ptr<HostDispatcher> dispatcher = nullptr;
+            /**
+             * @brief [!! 新增 !!] 连接状态 (经由 Subscribe* 模板订阅时非空；
+             * COW 复制与类别副本共享同一个)
+             */
+            std::shared_ptr<SubscriptionConnection> connection = nullptr;
+            /**
+             * @brief [!! 新增 !!] 订阅由 connection 持有 (不绑定订阅者)：
+             * subscriber_id 指向 connection 本身，发布时不检查它是否失效
+             */
+            bool connection_owned = false;
+
+            /**
+             * @brief [!! 新增 !!] 事件能否通过过滤器。
+             */
+            bool Accepts(const Event& e) const {
+                return !filter || filter(nullptr, e);
+            }
+        };
+
+        /**
+         * @class SubscriptionConnection
+         * @brief [!! 新增 !!] EventConnectionState 的实现：
+         * Disconnect 时把这条订阅所在的键交给 GC 定点回收。
+         */
+        class SubscriptionConnection final
+            : public EventConnectionState,
+              public std::enable_shared_from_this<SubscriptionConnection> {
+        public:
+            explicit SubscriptionConnection(std::weak_ptr<PluginManager> owner)
+                : owner_(std::move(owner)) {}
+
+            //! Unsubscribe / 回收时标记为断开 (订阅已被移除，无需清扫)
+            using EventConnectionState::MarkDisconnected;
+
+            //! 订阅 (及其类别副本) 所在的键 (由 event_mutex_ 保护)
+            std::vector<EventId> global_keys;
+            std::vector<std::pair<void*, EventId>> sender_keys;
+
+        protected:
+            void OnDisconnected() override;
+
+        private:
+            std::weak_ptr<PluginManager> owner_;
         };
 
+        /**
+         * @brief [辅助函数] 判断订阅是否已失效
+         * (已断开，或订阅者 / 发送者已析构)。
+         */
+        static bool IsSubscriptionExpired(const Subscription& s,
+            bool check_sender_also);
+
         /**
          * @brief [辅助函数] 清理已失效的(expired)订阅者 (weak_ptr)。
          */
@@ -454,11 +764,480 @@ namespace z3y {
             std::queue<std::weak_ptr<void>>& gc_queue);
 
         using EventCallbackList = std::vector<Subscription>;
+        // [!! COW !!] 不可变的订阅者列表快照
+        using CallbackListPtr = std::shared_ptr<const EventCallbackList>;
         // [!! 修改: 使用 unordered_map !!]
-        using EventMap = std::unordered_map<EventId, EventCallbackList>;
-        // [!! 修改: 使用 unordered_map !!]
-        using SenderMap = std::unordered_map<void*, EventMap>;
-        using EventTask = std::function<void()>;
+        using EventMap = std::unordered_map<EventId, CallbackListPtr>;
+        using EventMapPtr = std::shared_ptr<const EventMap>;
+        // [!! 修改 !!] (发送者, EventId) -> 订阅者列表 的扁平开放寻址表
+        // (取代 unordered_map<void*, EventMapPtr>)
+        using SenderIndex = FlatSenderIndex<CallbackListPtr>;
+
+        /**
+         * @struct WorkerQueue
+         * @brief [!! 新增 !!] 工作线程的本地任务双端队列。
+         * 所有者从队头取任务 (保持 FIFO)，窃取者从队尾取任务。
+         * [!! 修改 !!] 每个优先级通道一个双端队列。
+         */
+        struct WorkerQueue {
+            std::mutex mutex;
+            EventTaskDeque tasks[kEventPriorityCount];
+            /**
+             * @brief [!! 新增 !!] 本轮转周期内各通道剩余的额度
+             * (只由所属工作线程访问，无需加锁)
+             */
+            uint32_t credits[kEventPriorityCount] = {};
+            /**
+             * @brief [!! 新增 !!] 该工作线程在各通道执行的任务数
+             * (所属线程写，GetEventQueueStats 读)
+             */
+            std::atomic<uint64_t> executed[kEventPriorityCount] = {};
+        };
+
+        /**
+         * @struct EventStrand
+         * @brief [!! 新增 !!] 串行执行器 (strand)。
+         * 投递到同一 strand 的任务按 FIFO 逐个执行，
+         * 任意时刻至多有一个工作线程在执行它。
+         */
+        struct EventStrand {
+            std::mutex mutex;
+            EventTaskDeque pending;
+            bool scheduled = false;
+            /**
+             * @brief [!! 新增 !!] 排空任务使用的通道：
+             * 自上次调度以来投递的任务中的最高优先级
+             */
+            EventPriority lane = EventPriority::kLow;
+            /**
+             * @brief [!! 新增 !!] 排空任务投递到隔离通道而不是工作线程池
+             * (被看门狗降级的订阅者)
+             */
+            bool isolated = false;
+            /**
+             * @brief [!! 新增 !!] 订阅者被降级后取代它的隔离 strand：
+             * 之后投递到这里的任务转投 successor (仍持有旧快照的发布者)
+             */
+            std::shared_ptr<EventStrand> successor;
+        };
+
+        /**
+         * @struct EventCoalesceSlot
+         * @brief [!! 新增 !!] kQueuedCoalesced 订阅的待投递槽。
+         * 槽中至多有一个事件；scheduled 期间至多有一个投递任务，
+         * 因此同一订阅的回调不会并发执行。
+         */
+        struct EventCoalesceSlot {
+            std::mutex mutex;
+            PluginPtr<const Event> pending;
+            //! pending 所属的完成句柄 (来自 FireGlobalAsync 等，可为空)
+            PluginPtr<EventCompletion> completion;
+            bool scheduled = false;
+        };
+
+        /**
+         * @brief [!! 新增 !!] 把事件放入 kQueuedCoalesced 订阅的槽：
+         * 替换尚未投递的旧事件，必要时调度一次投递。
+         */
+        void PostCoalesced(const CallbackListPtr& subs, const Subscription& sub,
+            PluginPtr<const Event> e_ptr,
+            PluginPtr<EventCompletion> completion = nullptr);
+
+        /**
+         * @brief [!! 新增 !!] 为槽调度一个投递任务 (调用方已置 scheduled)。
+         */
+        void ScheduleCoalesced(const CallbackListPtr& subs,
+            const Subscription& sub);
+
+        /**
+         * @brief [!! 新增 !!] 在工作线程上投递槽中的最新事件。
+         */
+        void RunCoalesced(const CallbackListPtr& subs, const Subscription& sub);
+
+        using SubscriberStrandMap =
+            std::map<std::weak_ptr<void>, std::shared_ptr<EventStrand>,
+            std::owner_less<std::weak_ptr<void>>>;
+
+        /**
+         * @brief [!! 新增 !!] 获取 (或创建) 订阅者的 strand。
+         * (调用方必须持有 event_mutex_)
+         */
+        std::shared_ptr<EventStrand> GetSubscriberStrand(
+            const std::weak_ptr<void>& subscriber);
+
+        /**
+         * @brief [!! 新增 !!] 向 strand 投递任务；必要时调度一次排空。
+         */
+        void PostToStrand(const std::shared_ptr<EventStrand>& strand,
+            EventPriority priority, EventTask task);
+
+        /**
+         * @brief [!! 新增 !!] 在工作线程上排空 strand (每次最多处理一批)。
+         */
+        void DrainStrand(const std::shared_ptr<EventStrand>& strand);
+
+        /**
+         * @brief [!! 新增 !!] 调度 strand 的排空任务 (工作线程池或隔离通道)。
+         */
+        void ScheduleStrandDrain(const std::shared_ptr<EventStrand>& strand,
+            EventPriority lane);
+
+        // --- [!! 新增 !!] 慢回调看门狗 ---
+
+        /**
+         * @brief 为工作线程上的一次回调计时 (定义见 event_bus_impl.cpp)。
+         */
+        class SlowCallbackWatch;
+
+        /**
+         * @brief 记录一次超时，按策略降级并发布 SlowCallbackEvent。
+         */
+        void ReportSlowCallback(const Subscription& sub, uint64_t elapsed_ns);
+
+        /**
+         * @brief 把订阅者的异步订阅降级到隔离通道。
+         * @return false 表示已经降级过。
+         */
+        bool DemoteSubscriber(const std::weak_ptr<void>& subscriber);
+
+        /**
+         * @brief 降级订阅者的新订阅同样走隔离通道。
+         * (调用方必须持有 event_mutex_)
+         */
+        void ApplySubscriberIsolation(Subscription& sub);
+
+        /**
+         * @brief 查找订阅者所属组件的插件路径 (未知时为空)。
+         */
+        std::string FindSubscriberPlugin(const std::weak_ptr<void>& subscriber);
+
+        /**
+         * @brief 登记由 CreateInstance 创建的组件实例 (供 FindSubscriberPlugin 使用)。
+         */
+        void NoteInstanceOrigin(const PluginPtr<IComponent>& instance,
+            ClassId clsid);
+
+        /**
+         * @brief 投递任务到隔离通道 (首次使用时启动隔离线程)。
+         */
+        void PostIsolatedTask(EventTask task);
+
+        /**
+         * @brief 隔离线程的主函数。
+         */
+        void IsolatedLoop();
+
+        // --- [!! 新增 !!] 宿主调度器 ---
+
+        /**
+         * @brief 查找调度器连接方式指向的调度器 (订阅时调用)。
+         * @throws z3y::PluginException (kErrorDispatcherNotFound) 调度器已被移除。
+         */
+        std::shared_ptr<HostDispatcher> ResolveDispatcher(ConnectionType type);
+
+        /**
+         * @brief 把任务放入订阅的宿主调度器 (统计开启时记下入队时间)。
+         */
+        void PostToDispatcher(const Subscription& sub, EventTask task);
+
+        /**
+         * @brief 丢弃各调度器中尚未执行的任务 (卸载插件之前)。
+         */
+        void DiscardDispatcherTasks();
+
+        /**
+         * @brief [!! 新增 !!] 将异步任务投递给工作线程池。
+         * @details
+         * 由工作线程自身投递的任务进入该线程的本地双端队列
+         * (可被其他线程窃取)；其他线程投递的任务进入全局 event_queues_。
+         * 单工作线程时总是使用 event_queues_，保持原有的 FIFO 行为。
+         * [!! 修改 !!] 按 priority 进入对应通道 (每个通道各有一组上述队列)。
+         */
+        void EnqueueEventTask(EventTask task,
+            EventPriority priority = EventPriority::kNormal);
+
+        /**
+         * @brief [!! 新增 !!] 工作线程把任务放入自己的本地队列
+         * (达到容量时应用溢出策略，kBlock 按 kDropNewest 处理)。
+         */
+        void EnqueueLocalEventTask(EventTask task, size_t lane);
+
+        /**
+         * @brief [!! 新增 !!] 订阅是否由共享的异步任务投递
+         * (无过滤器的 kQueued 订阅)。
+         */
+        static bool IsSharedQueued(const Subscription& sub) {
+            return sub.connection_type == ConnectionType::kQueued && !sub.filter;
+        }
+
+        /**
+         * @brief [!! 新增 !!] 投递 kQueued 订阅共享的异步任务。
+         * @details make_task(begin, end) 生成处理 (*subs)[begin, end) 中
+         * 共享订阅的任务。queued_count 超过 event_fan_out_chunk_size 时
+         * 拆成多个任务 (见 PluginManagerOptions::event_fan_out_chunk_size)；
+         * 已失效的订阅不计入块的大小。
+         */
+        template <typename TMakeTask>
+        void EnqueueSharedFanOut(const CallbackListPtr& subs,
+            bool check_sender_also, size_t queued_count,
+            EventPriority priority, const TMakeTask& make_task);
+
+        /**
+         * @brief [!! 修改 !!] 按加权轮转选择通道并取任务。
+         */
+        bool TryDequeueEventTask(size_t worker_index, EventTask& out_task);
+
+        /**
+         * @brief [!! 新增 !!] 从一个通道按“本地队列 → 全局队列 → 窃取”的顺序取任务。
+         */
+        bool TryDequeueFromLane(size_t worker_index, size_t lane,
+            EventTask& out_task);
+
+        /**
+         * @struct EventTimer
+         * @brief [!! 新增 !!] ScheduleTimerImpl 登记的一次性定时器。
+         */
+        struct EventTimer {
+            std::chrono::steady_clock::time_point deadline;
+            uint64_t sequence;  //!< 同一时刻到期的定时器按登记顺序触发
+            std::weak_ptr<void> owner;
+            EventDelegate callback;
+
+            bool operator>(const EventTimer& other) const {
+                return deadline != other.deadline
+                    ? deadline > other.deadline
+                    : sequence > other.sequence;
+            }
+        };
+
+        /**
+         * @brief [!! 新增 !!] 最早的定时器是否已到期 (没有定时器时只有一次原子读)。
+         */
+        bool IsTimerDue() const;
+
+        /**
+         * @brief [!! 新增 !!] 在当前工作线程上执行所有已到期的定时器。
+         */
+        void RunDueTimers();
+
+        /**
+         * @brief [!! 新增 !!] 在调用线程上立即触发所有尚未触发的定时器
+         * (ClearAllRegistries 开始时调用，挂起的协程等待随之结束)。
+         */
+        void FireAllTimersForClear();
+
+        /**
+         * @brief [!! 新增 !!] 查询事件类型当前的优先级。
+         * (调用方必须持有 event_mutex_)
+         */
+        EventPriority LookupEventPriority(EventId event_id) const;
+
+        /**
+         * @brief [!! 新增 !!] 修改事件类型的优先级，并以新的优先级重新发布已有订阅。
+         * (调用方必须持有 event_mutex_)
+         */
+        void ApplyEventPriority(EventId event_id, EventPriority priority,
+            bool overridden);
+
+        /**
+         * @brief [!! 新增 !!] 执行一个异步任务 (含追踪与异常转发)。
+         */
+        void RunEventTask(EventTask& task);
+
+        /**
+         * @brief [!! 新增 !!] 入队后刷新队列深度高水位 (仅在统计开启时调用)。
+         */
+        void RecordQueueDepth(size_t lane);
+
+        /**
+         * @brief [!! COW !!] 发布某个全局事件的新订阅者列表。
+         * (调用方必须持有 event_mutex_；空列表将移除该键)
+         */
+        void PublishGlobalList(EventId event_id, EventCallbackList list);
+
+        /**
+         * @brief [!! COW !!] 发布某个 (发送者, 事件) 的新订阅者列表。
+         * (调用方必须持有 event_mutex_；空列表将移除该键)
+         */
+        void PublishSenderList(void* sender_key, EventId event_id,
+            EventCallbackList list);
+
+        /**
+         * @brief [!! 新增 !!] 请求一次 GC：置位 gc_requested_ 并唤醒一个工作线程。
+         */
+        void RequestGarbageCollection();
+
+        /**
+         * @brief [!! 新增 !!] Fire 路径发现失效订阅时调用 (无锁，重复调用很廉价)。
+         */
+        void RequestExpiredSweep();
+
+        /**
+         * @brief [!! 新增 !!] 连接断开时调用：记下它，由下一个 GC 时间片
+         * 只清扫它所在的键 (不取 event_mutex_)。
+         */
+        void QueueDisconnectedConnection(
+            std::shared_ptr<SubscriptionConnection> connection);
+
+        /**
+         * @brief [!! 新增 !!] 执行一个 GC 时间片 (由工作线程调用)。
+         * @details 依次：开始新的清扫 (如有请求) → 清扫全局表 →
+         * 清扫发送者表 → 回收 gc_queue_，每批 kGcBatch 项，
+         * 超出 options_.event_gc_slice_budget 后返回；有剩余工作时重新请求。
+         */
+        void RunGarbageCollectionSlice();
+
+        /**
+         * @brief [!! COW !!] 清扫 gc_global_cursor_ 中的一批键，并一次性发布。
+         * (调用方必须持有 event_mutex_)
+         */
+        void SweepGlobalBatch(size_t max_keys);
+
+        /**
+         * @brief [!! COW !!] 清扫 gc_sender_cursor_ 中的一批 (发送者, 事件) 键，
+         * 并一次性发布。
+         * (调用方必须持有 event_mutex_)
+         */
+        void SweepSenderBatch(size_t max_keys);
+
+        /**
+         * @brief 从 gc_queue_ 回收一批反向查找项。
+         * (调用方必须持有 event_mutex_)
+         */
+        void ReclaimLookupBatch(size_t max_entries);
+
+        /**
+         * @brief [!! 新增 !!] 追加一条全局订阅并发布新快照
+         * (SubscribeGlobalImpl / SubscribeGlobalConnectedImpl 共用)。
+         */
+        void AddGlobalSubscription(EventId event_id, Subscription sub);
+
+        /**
+         * @brief [!! 新增 !!] 追加一条发送者订阅并发布新快照。
+         */
+        void AddSenderSubscription(void* sender_key, EventId event_id,
+            Subscription sub);
+
+        /**
+         * @brief [!! 新增 !!] 为订阅创建连接状态；订阅者为空时由连接状态持有订阅。
+         */
+        PluginPtr<EventConnectionState> AttachConnection(Subscription& sub);
+
+        /**
+         * @brief [!! 新增 !!] 生成类别订阅在后代事件列表中的副本
+         * (优先级取后代事件的设置；kQueuedCoalesced 订阅另建合并槽)。
+         * (调用方必须持有 event_mutex_)
+         */
+        Subscription MakeCategoryCopy(const Subscription& sub,
+            EventId descendant) const;
+
+        /**
+         * @brief [!! 新增 !!] 把新的类别订阅合并进所有已登记的后代事件列表
+         * (sender_key 为 nullptr 时为全局订阅)。
+         * (调用方必须持有 event_mutex_)
+         */
+        void PropagateCategorySubscription(void* sender_key,
+            const Subscription& sub);
+
+        /**
+         * @brief [!! 新增 !!] 新登记的事件继承其各祖先类别已有的订阅。
+         * (调用方必须持有 event_mutex_)
+         */
+        void InheritCategorySubscriptions(EventId event_id);
+
+        /**
+         * @brief [!! 新增 !!] (发送者, 事件) 的列表被清空时移出 category_sender_keys_。
+         * (调用方必须持有 event_mutex_)
+         */
+        void ForgetCategorySenderKey(void* sender_key, EventId event_id);
+
+        /**
+         * @brief [!! 新增 !!] 取得回调目标 (锁定订阅者)。
+         * @return false 表示订阅已断开或订阅者已析构。由连接句柄持有的订阅
+         * 不需要锁定，target 保持为空。
+         */
+        static bool LockSubscriptionTarget(const Subscription& sub,
+            std::shared_ptr<void>& target);
+
+        /**
+         * @brief [!! 新增 !!] 以单个事件调用订阅 (批量订阅收到长度为 1 的批次)。
+         */
+        static void InvokeSubscription(const Subscription& sub,
+            const Event& e);
+
+        /**
+         * @brief [!! 新增 !!] 以整批事件调用订阅 (普通订阅逐个接收)。
+         */
+        static void InvokeSubscription(const Subscription& sub,
+            const EventBatch& batch);
+
+        /**
+         * @brief [!! 新增 !!] 把 1.0 接口传入的 std::function 装入委托。
+         */
+        static EventDelegate WrapLegacyCallback(
+            std::function<void(const Event&)> cb);
+
+        /**
+         * @brief [!! 新增 !!] 在发布者线程上以订阅的过滤器筛选一批事件。
+         * @return 全部通过时返回 batch 本身，全部被拒绝时返回空。
+         */
+        static PluginPtr<EventBatch> FilterBatch(const Subscription& sub,
+            const PluginPtr<EventBatch>& batch);
+
+        /**
+         * @brief [!! 新增 !!] 把一个事件 (TPayload = Event) 或一批事件
+         * (TPayload = EventBatch) 分发给已解析的订阅者列表。
+         * @details 所有发布路径 (FireGlobalImpl / FireToSenderImpl、
+         * Fire*BatchImpl、Fire*AsyncImpl) 共用这一个循环。
+         * completion 不为空时每个异步任务持有一个计数，
+         * 异步回调逐个捕获异常并汇总到 completion。
+         */
+        template <typename TPayload>
+        void DispatchToList(EventId event_id, const CallbackListPtr& subs,
+            bool check_sender_also, const PluginPtr<TPayload>& payload,
+            const PluginPtr<EventCompletion>& completion, bool traced);
+
+        /**
+         * @brief [!! 新增 !!] 调用订阅；errors 不为空时把异常记录到它上面。
+         */
+        template <typename TPayload>
+        static void InvokeReporting(EventCompletion* errors,
+            const Subscription& sub, const TPayload& payload);
+
+        /**
+         * @brief [!! 新增 !!] 订阅应收到的载荷 (经过其过滤器)。
+         * @return 被过滤器全部拒绝时返回 nullptr；批次被部分过滤时
+         * 子批次存入 filtered 并返回它的地址。
+         */
+        static const PluginPtr<Event>* PayloadFor(const Subscription& sub,
+            const PluginPtr<Event>& e_ptr, PluginPtr<Event>& filtered);
+        static const PluginPtr<EventBatch>* PayloadFor(const Subscription& sub,
+            const PluginPtr<EventBatch>& batch, PluginPtr<EventBatch>& filtered);
+
+        /**
+         * @brief [!! 新增 !!] 把载荷放入 kQueuedCoalesced 订阅的槽
+         * (批次只保留最后一个事件)。
+         */
+        void PostCoalescedPayload(const CallbackListPtr& subs,
+            const Subscription& sub, const PluginPtr<Event>& e_ptr,
+            const PluginPtr<EventCompletion>& completion);
+        void PostCoalescedPayload(const CallbackListPtr& subs,
+            const Subscription& sub, const PluginPtr<EventBatch>& batch,
+            const PluginPtr<EventCompletion>& completion);
+
+        /**
+         * @brief [!! 新增 !!] 按订阅自身的连接方式投递一个事件
+         * (用于向新订阅重放保留事件，以及单独投递已通过过滤的 kQueued 订阅)。
+         */
+        void DeliverToSubscription(const CallbackListPtr& subs,
+            const Subscription& sub, const PluginPtr<const Event>& e_ptr);
+
+        /**
+         * @brief [!! 新增 !!] 查找保留事件；sender_key 为 nullptr 时查找全局事件。
+         * 发送者实例必须与 sender_id 相同 (地址被复用的新对象不会收到旧值)。
+         */
+        PluginPtr<const Event> FindRetainedEvent(EventId event_id,
+            void* sender_key, const std::weak_ptr<void>& sender_id);
 
         // [保留 map] SubscriberLookupMapG 必须使用 map
         using SubscriberLookupMapG =
@@ -509,31 +1288,151 @@ namespace z3y {
 
 
         // --- 事件总线成员 ---
+        // [!! COW !!] event_mutex_ 现在只串行化“写者”
+        // (Subscribe/Unsubscribe/GC)，Fire 路径不再加锁。
         std::recursive_mutex event_mutex_;
-        // [!! 修改: 使用 unordered_map (via EventMap) !!]
-        EventMap global_subscribers_;
-        // [!! 修改: 使用 unordered_map (via SenderMap) !!]
-        SenderMap sender_subscribers_;
+        // [!! COW !!] 全局订阅表的不可变快照
+        SnapshotPtr<EventMap> global_subscribers_;
+        // [!! COW !!] 实例订阅表的不可变快照
+        SnapshotPtr<SenderIndex> sender_subscribers_;
+        // [!! 新增 !!] 按 EventId / (发送者, EventId) 计数的布隆过滤器，
+        // 由 Publish*List 维护；IsGlobalSubscribed / IsSenderSubscribed 的快速否定
+        GlobalSubscriptionFilter global_filter_;
+        SenderSubscriptionFilter sender_filter_;
+        // [!! COW !!] Fire 路径发现失效订阅时置位，由事件循环批量清理
+        std::atomic<bool> gc_sweep_pending_;
+        // [!! 新增 !!] 有待执行的 GC 工作；置位后唤醒一个工作线程 (不再周期轮询)
+        std::atomic<bool> gc_requested_;
+        // [!! 新增 !!] 增量清扫的游标与 GC 计数器 (由 event_mutex_ 保护)
+        std::vector<EventId> gc_global_cursor_;
+        std::vector<std::pair<void*, EventId>> gc_sender_cursor_;
+        // [!! 新增 !!] 已 Disconnect、尚未转入游标的连接 (由 gc_disconnect_mutex_ 保护)
+        std::mutex gc_disconnect_mutex_;
+        std::vector<std::shared_ptr<SubscriptionConnection>> gc_disconnected_;
+        uint64_t gc_slices_;
+        uint64_t gc_subscriptions_reclaimed_;
+        uint64_t gc_lookup_entries_reclaimed_;
         // [保留 map] global_sub_lookup_ 使用 map
         SubscriberLookupMapG global_sub_lookup_;
         // [保留 map] sender_sub_lookup_ 使用 map
         SubscriberLookupMapS sender_sub_lookup_;
+        // [!! 新增 !!] kQueuedOrdered 订阅者 -> strand
+        SubscriberStrandMap subscriber_strands_;
+
+        /**
+         * @struct EventPriorityEntry
+         * @brief [!! 新增 !!] 事件类型的优先级设置。
+         */
+        struct EventPriorityEntry {
+            EventPriority priority;
+            bool overridden;  //!< 由 SetEventPriority 设置 (不再被声明值覆盖)
+        };
+        // [!! 新增 !!] EventId -> 优先级 (未登记的事件为 kNormal)
+        std::unordered_map<EventId, EventPriorityEntry> event_priorities_;
+
+        // [!! 新增 !!] 事件类别 (由 event_mutex_ 保护；ClearAllRegistries 不清空：
+        // 各模块的 DeclareEventCategory 只对每条总线登记一次)
+        // EventId -> 祖先类别 (由近及远)
+        std::unordered_map<EventId, std::vector<EventId>> event_ancestors_;
+        // 类别 -> 所有已登记的后代事件
+        std::unordered_map<EventId, std::vector<EventId>> category_descendants_;
+        // EventId -> 持有该事件发送者订阅的发送者键 (任何事件都可能在之后
+        // 成为类别，因此每个发送者订阅都登记；列表清空时移除，
+        // 由 ClearAllRegistries 清空)。后代事件登记时只访问其祖先的这些键
+        std::unordered_map<EventId, std::set<void*>> category_sender_keys_;
+
+        /**
+         * @struct RetainedSenderEvent
+         * @brief [!! 新增 !!] 某个发送者的保留事件。
+         */
+        struct RetainedSenderEvent {
+            std::weak_ptr<void> sender_id;
+            PluginPtr<const Event> event;
+        };
+        // [!! 新增 !!] 保留事件 (只由 retained_mutex_ 保护，发布路径不取 event_mutex_)
+        std::mutex retained_mutex_;
+        std::unordered_map<EventId, PluginPtr<const Event>> retained_global_;
+        std::map<std::pair<void*, EventId>, RetainedSenderEvent> retained_sender_;
+        // [!! 新增 !!] retained_sender_ 达到此大小时清理已析构发送者的条目
+        static constexpr size_t kRetainedSenderPurgeMin = 64;
+        size_t retained_sender_purge_at_ = kRetainedSenderPurgeMin;
 
         // --- 异步事件总线成员 ---
-        std::thread event_loop_thread_;
-        std::queue<EventTask> event_queue_;
-        std::mutex queue_mutex_;
-        std::condition_variable queue_cv_;
-        bool running_;
+        // [!! 新增 !!] 创建选项 (由 Create() 设置)
+        PluginManagerOptions options_;
+        // [!! 修改 !!] 工作线程池 (原单一 event_loop_thread_)
+        std::vector<std::thread> event_workers_;
+        // [!! 新增 !!] 每个工作线程的本地队列 (与 event_workers_ 一一对应)
+        std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+        // [!! 新增 !!] 各通道在所有本地队列中的任务总数 (用于唤醒与窃取)
+        std::atomic<size_t> local_task_counts_[kEventPriorityCount];
+        // [!! 修改 !!] 全局注入队列：有界、预分配的无锁环形队列 (每个通道一个)
+        std::array<std::unique_ptr<EventRingBuffer<EventTask>>,
+            kEventPriorityCount> event_queues_;
+        // [!! 新增 !!] 有任务可取时唤醒工作线程
+        EventCount work_available_;
+        // [!! 新增 !!] 队列出现空位时唤醒被阻塞的发布者 (kBlock)
+        EventCount space_available_;
+        std::atomic<bool> running_;
+
+        // [!! 新增 !!] 定时器小顶堆 (由 timer_mutex_ 保护)
+        std::mutex timer_mutex_;
+        std::priority_queue<EventTimer, std::vector<EventTimer>,
+            std::greater<EventTimer>> timers_;
+        uint64_t timer_sequence_;
+        // [!! 新增 !!] delay >= kTimerUntilCleared 的定时器 (不进堆，由 timer_mutex_ 保护)
+        std::vector<EventTimer> clear_only_timers_;
+        size_t clear_only_timers_purge_at_ = 64;
+        // [!! 新增 !!] 最早定时器的到期时刻 (steady_clock 纳秒)，没有定时器时为 kNoTimer
+        static constexpr int64_t kNoTimer = std::numeric_limits<int64_t>::max();
+        std::atomic<int64_t> next_timer_deadline_;
+        // [!! 新增 !!] 是否已有空闲工作线程按最早到期时刻带超时等待
+        std::atomic<bool> timer_keeper_claimed_;
+
+        // [!! 新增 !!] 溢出计数器
+        std::atomic<uint64_t> queue_dropped_oldest_;
+        std::atomic<uint64_t> queue_dropped_newest_;
+        std::atomic<uint64_t> queue_rejected_;
+        std::atomic<uint64_t> queue_blocked_;
+        std::atomic<uint64_t> queue_coalesced_;
 
         std::queue<std::weak_ptr<void>> gc_queue_;
 
-        // [!! 修复：在此处添加成员变量声明 !!]
         /**
-         * @brief [!! 新增 !!]
-         * 事件追踪钩子
+         * @brief [!! 新增 !!] 事件追踪缓冲区 (取代 EventTraceHook)。
+         */
+        EventTraceBuffer event_trace_;
+
+        /**
+         * @brief [!! 新增 !!] 按 EventId 的延迟/耗时/扇出统计 (IEventStats)。
          */
-        EventTraceHook event_trace_hook_;
+        EventStatsTable event_stats_;
+
+        // [!! 新增 !!] 慢回调看门狗的记录 (由 watchdog_mutex_ 保护)
+        using SlowSubscriberMap =
+            std::map<std::weak_ptr<void>, SlowSubscriberStats,
+            std::owner_less<std::weak_ptr<void>>>;
+        mutable std::mutex watchdog_mutex_;
+        SlowSubscriberMap slow_subscribers_;
+
+        // [!! 新增 !!] CreateInstance 创建的实例 -> CLSID (由 registry_mutex_ 保护)
+        using InstanceOriginMap =
+            std::map<std::weak_ptr<void>, ClassId,
+            std::owner_less<std::weak_ptr<void>>>;
+        InstanceOriginMap instance_origins_;
+        size_t instance_origins_purge_at_ = 64;
+
+        // [!! 新增 !!] 隔离通道：被降级订阅者的任务在此单独执行
+        std::mutex isolated_mutex_;
+        std::condition_variable isolated_cv_;
+        EventTaskDeque isolated_tasks_;
+        std::thread isolated_thread_;
+        bool isolated_stopping_ = false;
+
+        // [!! 新增 !!] 具名宿主调度器 (由 dispatcher_mutex_ 保护)
+        std::mutex dispatcher_mutex_;
+        std::unordered_map<std::string, std::shared_ptr<HostDispatcher>> dispatchers_;
+        unsigned next_dispatcher_slot_ = 0;  // 槽位不复用，旧的连接方式不会指向新调度器
     };
 
     // --- [!! 
@@ -617,6 +1516,7 @@ namespace z3y {
             // )
             throw PluginException(cast_result, "PluginCast failed.");
         }
+        NoteInstanceOrigin(base_obj, clsid);  // [!! 新增 !!] 看门狗据此定位插件
 
         // 
         // 
@@ -0,0 +1,276 @@
+/**
+ * @file shared_event_ring.h
+ * @brief [内部] 定义 z3y::SharedEventRing，共享内存中的多生产者广播环。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 布局 (全部位于共享内存中，只使用地址无关的无锁原子量)：
+ * @code
+ * [Header: magic / 版本 / 槽位参数 | head (独占缓存行)]
+ * [Slot 0: SlotHeader (32 字节) | 载荷] [Slot 1] ... [Slot N-1]
+ * @endcode
+ *
+ * - 写者：head.fetch_add 领取序号 s，槽位 s & (N-1)；
+ * 把槽位状态 CAS 为“正在写 s”，复制载荷，再把状态置为“已发布 s”；
+ * - 读者 (每个进程各自的游标，互不影响)：状态等于“已发布 cursor”时读取，
+ * 读完再检查状态未变 (seqlock)；状态更新说明已被覆盖，游标跳到最旧的
+ * 仍然有效的序号，差值计为丢失；
+ * - 状态单调递增：正在写 s 为 2s+1，已发布 s 为 2s+2，0 为从未写入。
+ *
+ * 写者永远不等待读者。槽位仍被落后整整一圈的写者占用时，新的写者
+ * 短暂让步；仍未释放 (该写者很可能已经崩溃) 则放弃本条记录，由调用方
+ * 计为丢失。写者不会写入其他写者持有的槽位：被占用写者的 memcpy
+ * 随时可能继续，接管会撕裂已发布的记录。读者在该序号处停滞，
+ * 超时后跳过 (见 Skip)。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_SHARED_EVENT_RING_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_SHARED_EVENT_RING_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "framework/class_id.h"
+
+namespace z3y {
+
+    /**
+     * @class SharedEventRing
+     * @brief 映射内存上的广播环视图 (不拥有内存)。
+     */
+    class SharedEventRing {
+    public:
+        static constexpr uint64_t kMagic = 0x7A33794272696467ULL;  // "z3yBridg"
+        static constexpr uint32_t kLayoutVersion = 1;
+        static constexpr size_t kSlotHeaderSize = 32;
+        static constexpr size_t kSlotAlignment = 64;
+
+        /**
+         * @enum ReadStatus
+         * @brief Read 的结果。
+         */
+        enum class ReadStatus {
+            kEmpty,    //!< cursor 处的记录尚未发布
+            kRecord,   //!< 读到一条记录，cursor 前进 1
+            kOverrun,  //!< 记录已被覆盖，cursor 跳到最旧的有效序号
+        };
+
+        /**
+         * @brief 容纳 slot_count 个 slot_size 字节槽位所需的共享内存大小。
+         */
+        static size_t RequiredSize(size_t slot_count, size_t slot_size) {
+            return sizeof(Header) + slot_count * slot_size;
+        }
+
+        /**
+         * @brief 由创建者在清零的内存上初始化环 (最后才发布 magic)。
+         */
+        static void Initialize(void* base, size_t slot_count, size_t slot_size) {
+            Header* header = ::new (base) Header();
+            header->version = kLayoutVersion;
+            header->slot_size = static_cast<uint32_t>(slot_size);
+            header->slot_count = slot_count;
+            unsigned char* slots = static_cast<unsigned char*>(base) + sizeof(Header);
+            for (size_t i = 0; i < slot_count; ++i) {
+                ::new (slots + i * slot_size) SlotHeader();
+            }
+            header->magic.store(kMagic, std::memory_order_release);
+        }
+
+        /**
+         * @brief 附加到已初始化 (或正在由其他进程初始化) 的环。
+         * @return false 表示内存不是兼容的事件桥，原因写入 error。
+         */
+        bool Attach(void* base, size_t size, std::string& error) {
+            if (size < sizeof(Header)) {
+                error = "shared memory is too small";
+                return false;
+            }
+            Header* header = static_cast<Header*>(base);
+            for (int attempt = 0;
+                header->magic.load(std::memory_order_acquire) != kMagic;
+                ++attempt) {
+                if (attempt >= 1000) {
+                    error = "shared memory is not an event bridge";
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            const uint64_t count = header->slot_count;
+            const size_t slot_size = header->slot_size;
+            if (header->version != kLayoutVersion || count == 0 ||
+                (count & (count - 1)) != 0 || slot_size <= kSlotHeaderSize ||
+                slot_size % kSlotAlignment != 0 ||
+                RequiredSize(count, slot_size) > size) {
+                error = "incompatible event bridge layout";
+                return false;
+            }
+            header_ = header;
+            slots_ = static_cast<unsigned char*>(base) + sizeof(Header);
+            mask_ = count - 1;
+            slot_size_ = slot_size;
+            return true;
+        }
+
+        size_t SlotCount() const { return mask_ + 1; }
+
+        /**
+         * @brief 每条记录的最大载荷字节数。
+         */
+        size_t PayloadCapacity() const { return slot_size_ - kSlotHeaderSize; }
+
+        /**
+         * @brief 下一个将被领取的序号 (新读者从这里开始)。
+         */
+        uint64_t Head() const {
+            return header_->head.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief 写入一条记录：fill(void* payload) 填充 size 字节的载荷。
+         * @return false 表示记录被放弃：领取的槽位已被更新的序号占用
+         * (本写者落后了整整一圈)，或上一圈的写者迟迟不释放它。
+         */
+        template <typename Fill>
+        bool Write(uint64_t origin, EventId event_id, size_t size, Fill&& fill) {
+            const uint64_t sequence =
+                header_->head.fetch_add(1, std::memory_order_relaxed);
+            SlotHeader& slot = SlotAt(sequence);
+            const uint64_t writing = WritingState(sequence);
+
+            uint64_t state = slot.state.load(std::memory_order_relaxed);
+            for (uint32_t spins = 0;;) {
+                if (state >= writing) {
+                    return false;
+                }
+                if ((state & 1) != 0) {
+                    // 上一圈的写者仍在复制载荷：不接管 (它的写入可能随时继续)
+                    if (++spins > kWriterSpinLimit) {
+                        return false;
+                    }
+                    std::this_thread::yield();
+                    state = slot.state.load(std::memory_order_relaxed);
+                    continue;
+                }
+                // acquire：之后的载荷写入不会被重排到状态变为“正在写”之前
+                if (slot.state.compare_exchange_weak(state, writing,
+                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+
+            slot.origin.store(origin, std::memory_order_relaxed);
+            slot.event_id.store(event_id, std::memory_order_relaxed);
+            slot.size.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+            fill(PayloadOf(slot));
+
+            // 持有“正在写”状态期间没有其他写者修改该槽位
+            slot.state.store(PublishedState(sequence), std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 读取 cursor 处的记录。
+         * @details 记录有效时，decode(origin, event_id, payload, size) 的返回值
+         * 存入 out；decode 执行期间记录可能被覆盖，因此之后再校验一次，
+         * 失败时丢弃 out 并按覆盖处理。decode 只能复制载荷，不能有副作用。
+         * @param[in,out] lost 累加因覆盖而跳过的记录数。
+         */
+        template <typename TResult, typename Decode>
+        ReadStatus Read(uint64_t& cursor, uint64_t& lost, TResult& out,
+            Decode&& decode) const {
+            const SlotHeader& slot = SlotAt(cursor);
+            const uint64_t published = PublishedState(cursor);
+            const uint64_t state = slot.state.load(std::memory_order_acquire);
+            if (state < published) {
+                return ReadStatus::kEmpty;
+            }
+            if (state == published) {
+                const size_t size = slot.size.load(std::memory_order_relaxed);
+                if (size <= PayloadCapacity()) {
+                    out = decode(slot.origin.load(std::memory_order_relaxed),
+                        slot.event_id.load(std::memory_order_relaxed),
+                        PayloadOf(slot), size);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.state.load(std::memory_order_relaxed) == published) {
+                    ++cursor;
+                    return ReadStatus::kRecord;
+                }
+                out = TResult();
+            }
+            SkipOverrun(cursor, lost);
+            return ReadStatus::kOverrun;
+        }
+
+        /**
+         * @brief 跳过 cursor 处的记录 (写者中途退出或放弃了记录，槽位不会发布)。
+         */
+        static void Skip(uint64_t& cursor, uint64_t& lost) {
+            ++cursor;
+            ++lost;
+        }
+
+    private:
+        static constexpr uint32_t kWriterSpinLimit = 1024;
+
+        struct alignas(64) Header {
+            std::atomic<uint64_t> magic{ 0 };
+            uint32_t version = 0;
+            uint32_t slot_size = 0;
+            uint64_t slot_count = 0;
+            alignas(64) std::atomic<uint64_t> head{ 0 };  // 写者争用，独占缓存行
+        };
+
+        struct SlotHeader {
+            std::atomic<uint64_t> state{ 0 };
+            std::atomic<uint64_t> origin{ 0 };
+            std::atomic<uint64_t> event_id{ 0 };
+            std::atomic<uint32_t> size{ 0 };
+            uint32_t reserved = 0;
+        };
+
+        static_assert(sizeof(SlotHeader) == kSlotHeaderSize,
+            "SlotHeader layout is part of the shared-memory format");
+        static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+            std::atomic<uint32_t>::is_always_lock_free,
+            "Shared-memory atomics must be lock-free (address-free)");
+
+        static uint64_t WritingState(uint64_t sequence) { return 2 * sequence + 1; }
+        static uint64_t PublishedState(uint64_t sequence) { return 2 * sequence + 2; }
+
+        SlotHeader& SlotAt(uint64_t sequence) const {
+            return *reinterpret_cast<SlotHeader*>(
+                slots_ + static_cast<size_t>(sequence & mask_) * slot_size_);
+        }
+
+        static unsigned char* PayloadOf(const SlotHeader& slot) {
+            return reinterpret_cast<unsigned char*>(
+                const_cast<SlotHeader*>(&slot)) + kSlotHeaderSize;
+        }
+
+        void SkipOverrun(uint64_t& cursor, uint64_t& lost) const {
+            const uint64_t head = Head();
+            const uint64_t oldest = head > SlotCount() ? head - SlotCount() : 0;
+            const uint64_t next = oldest > cursor + 1 ? oldest : cursor + 1;
+            lost += next - cursor;
+            cursor = next;
+        }
+
+        Header* header_ = nullptr;
+        unsigned char* slots_ = nullptr;
+        size_t mask_ = 0;
+        size_t slot_size_ = 0;
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_SHARED_EVENT_RING_H_
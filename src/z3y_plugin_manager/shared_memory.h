@@ -0,0 +1,64 @@
+/**
+ * @file shared_memory.h
+ * @brief [内部] 定义 z3y::SharedMemoryRegion，具名共享内存的映射。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 实现在 platform_posix.cpp (shm_open + mmap) 与
+ * platform_win.cpp (CreateFileMappingW + MapViewOfFile) 中。
+ * 新创建的内存总是被清零 (两个平台都保证)。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_SHARED_MEMORY_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_SHARED_MEMORY_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace z3y {
+
+    /**
+     * @class SharedMemoryRegion
+     * @brief 一段已映射的具名共享内存 (析构时解除映射，不删除名字)。
+     */
+    class SharedMemoryRegion {
+    public:
+        /**
+         * @brief 打开名为 name 的共享内存；不存在时以 size 字节创建。
+         * @param[out] created 本进程是否为创建者。
+         * @param[out] error 失败原因。
+         * @return 失败时返回空。已存在时映射其全部大小 (可能与 size 不同)。
+         */
+        static std::unique_ptr<SharedMemoryRegion> OpenOrCreate(
+            const std::string& name, size_t size, bool& created,
+            std::string& error);
+
+        /**
+         * @brief 删除共享内存的名字 (已映射的进程不受影响)。
+         */
+        static void Remove(const std::string& name);
+
+        ~SharedMemoryRegion();
+
+        SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+        SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+        void* Data() const { return data_; }
+        size_t Size() const { return size_; }
+
+    private:
+        SharedMemoryRegion(void* data, size_t size, void* handle)
+            : data_(data), size_(size), handle_(handle) {}
+
+        void* data_;
+        size_t size_;
+        void* handle_;  // Win32 的映射句柄 (POSIX 为 nullptr)
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_SHARED_MEMORY_H_
@@ -0,0 +1,92 @@
+/**
+ * @file snapshot_ptr.h
+ * @brief [内部] 定义 z3y::SnapshotPtr，用于写时复制 (Copy-On-Write) 的不可变快照。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * 事件总线的订阅表被保存为“不可变的、引用计数的快照”：
+ * - 读者 (FireGlobal/FireToSender) 只做一次原子 Load，
+ * 不取 event_mutex_，也不拷贝订阅者列表；
+ * - 写者 (Subscribe/Unsubscribe) 在 event_mutex_
+ * 保护下复制当前快照、修改副本，再原子地 Store 回去。
+ * 旧快照由仍持有它的读者 (或异步任务) 的引用计数自动释放。
+ *
+ * @note Load 不是无锁的。std::atomic<std::shared_ptr> 与 std::atomic_load
+ * 在 MSVC 与 libstdc++ 中都用一个短暂的锁保护“读指针 + 递增引用计数”
+ * (is_lock_free() 为 false；C++17 的自由函数版本按地址散列到一个
+ * 进程级的锁池，不同的 SnapshotPtr 也可能共用一把锁)。
+ * 因此每次 Load 的实际代价是：一次很短的加锁/解锁、一次原子引用计数递增，
+ * 以及快照释放时的一次原子递减；并发发布同一张表的线程会争用这把锁
+ * 与控制块所在的缓存行。临界区内不分配内存，也不会等待写者复制列表
+ * (写者只在 Store 交换指针时短暂持有这把锁)，所以发布者不会被
+ * Subscribe/Unsubscribe 阻塞到 O(列表长度) 的时间。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_SNAPSHOT_PTR_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_SNAPSHOT_PTR_H_
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace z3y {
+
+    /**
+     * @class SnapshotPtr
+     * @brief 对 std::shared_ptr<const T> 的原子发布/读取封装。
+     *
+     * @details
+     * C++20 下使用 std::atomic<std::shared_ptr>；
+     * C++17 下退回 std::atomic_load / std::atomic_store 自由函数
+     * (二者语义相同，封装在此处以避免在调用点散布条件编译)。
+     */
+    template <typename T>
+    class SnapshotPtr {
+    public:
+        using Pointer = std::shared_ptr<const T>;
+
+        SnapshotPtr() = default;
+        explicit SnapshotPtr(Pointer initial) : ptr_(std::move(initial)) {}
+
+        SnapshotPtr(const SnapshotPtr&) = delete;
+        SnapshotPtr& operator=(const SnapshotPtr&) = delete;
+
+        /**
+         * @brief 读取当前快照 (acquire)。
+         * @note 见文件说明：内部加一个短暂的锁，并递增引用计数。
+         */
+        Pointer Load() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            return ptr_.load(std::memory_order_acquire);
+#else
+            return std::atomic_load_explicit(&ptr_, std::memory_order_acquire);
+#endif
+        }
+
+        /**
+         * @brief 发布一个新快照 (release)。
+         * @note 写者之间的互斥由调用方 (event_mutex_) 保证。
+         */
+        void Store(Pointer next) {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            ptr_.store(std::move(next), std::memory_order_release);
+#else
+            std::atomic_store_explicit(&ptr_, std::move(next),
+                std::memory_order_release);
+#endif
+        }
+
+    private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+        std::atomic<Pointer> ptr_;
+#else
+        Pointer ptr_;
+#endif
+    };
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_SNAPSHOT_PTR_H_
@@ -0,0 +1,106 @@
+/**
+ * @file subscription_filter.h
+ * @brief [内部] 定义 z3y::SubscriptionFilter，订阅存在性的计数布隆过滤器。
+ * @author 孙鹏宇
+ * @date 2025-11-20
+ *
+ * @details
+ * FireGlobal / FireToSender 在构造事件之前先调用 IsGlobalSubscribed /
+ * IsSenderSubscribed。大多数框架事件 (ComponentRegisterEvent 等)
+ * 在生产环境中没有订阅者，因此这里用一个固定大小的计数数组做快速否定：
+ * - 每个键 (EventId，或 发送者+EventId) 哈希到一个槽位；
+ * - 槽位计数 = 哈希到该槽位的订阅条目总数，由写者 (持有 event_mutex_)
+ * 在发布新快照时按增量维护；
+ * - 槽位为 0 时“一定没有订阅者”，只需一次 relaxed 原子读取；
+ * 非 0 时可能是哈希冲突，调用方再回退到快照查找。
+ */
+
+#pragma once
+
+#ifndef Z3Y_SRC_PLUGIN_MANAGER_SUBSCRIPTION_FILTER_H_
+#define Z3Y_SRC_PLUGIN_MANAGER_SUBSCRIPTION_FILTER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace z3y {
+
+    /**
+     * @class SubscriptionFilter
+     * @brief 单哈希的计数布隆过滤器 (只有假阳性，没有假阴性)。
+     * @tparam kSlotBits 槽位数为 2^kSlotBits；
+     * 假阳性率约为 (订阅键数 / 槽位数)。
+     */
+    template <size_t kSlotBits>
+    class SubscriptionFilter {
+    public:
+        static constexpr size_t kSlotCount = size_t(1) << kSlotBits;
+
+        SubscriptionFilter() { Clear(); }
+
+        SubscriptionFilter(const SubscriptionFilter&) = delete;
+        SubscriptionFilter& operator=(const SubscriptionFilter&) = delete;
+
+        /**
+         * @brief 键是否可能有订阅 (false 表示一定没有)。
+         */
+        bool MayContain(uint64_t key) const {
+            return slots_[IndexOf(key)].load(std::memory_order_relaxed) != 0;
+        }
+
+        /**
+         * @brief 按增量调整键所在槽位的计数。
+         * @note 写者之间的互斥由调用方 (event_mutex_) 保证。
+         */
+        void Adjust(uint64_t key, ptrdiff_t delta) {
+            if (delta > 0) {
+                slots_[IndexOf(key)].fetch_add(static_cast<uint32_t>(delta),
+                    std::memory_order_relaxed);
+            }
+            else if (delta < 0) {
+                slots_[IndexOf(key)].fetch_sub(static_cast<uint32_t>(-delta),
+                    std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief 清零所有槽位 (ClearAllRegistries 时调用)。
+         */
+        void Clear() {
+            for (auto& slot : slots_) {
+                slot.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        static size_t IndexOf(uint64_t key) {
+            // Fibonacci 哈希：EventId 已是哈希值，但发送者指针的低位是对齐零
+            return static_cast<size_t>(
+                (key * 0x9E3779B97F4A7C15ULL) >> (64 - kSlotBits));
+        }
+
+        std::atomic<uint32_t> slots_[kSlotCount];
+    };
+
+    /**
+     * @brief 组合 (发送者, 事件) 为一个过滤器键。
+     */
+    inline uint64_t SenderFilterKey(const void* sender_key, uint64_t event_id) {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(sender_key)) ^
+            (event_id * 0xC2B2AE3D27D4EB4FULL);
+    }
+
+    /**
+     * @brief 全局订阅过滤器：事件类型通常只有几百种，4096 个槽位足够。
+     */
+    using GlobalSubscriptionFilter = SubscriptionFilter<12>;
+
+    /**
+     * @brief 发送者订阅过滤器：键数随发送者数量增长，使用 32768 个槽位 (128 KB)。
+     */
+    using SenderSubscriptionFilter = SubscriptionFilter<15>;
+
+}  // namespace z3y
+
+#endif  // Z3Y_SRC_PLUGIN_MANAGER_SUBSCRIPTION_FILTER_H_